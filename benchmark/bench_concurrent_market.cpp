@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 #include <iostream>
+#include <thread>
 #include <vector>
 #include "generate_orders.h"
 #include "market/concurrent_market.h"
@@ -33,6 +34,44 @@ static void BM_ConcurrentMarket(benchmark::State &state)
     }
 }
 
+static void BM_ConcurrentMarketProducers(benchmark::State &state)
+{
+    const uint64_t num_symbols = state.range(0);
+    const uint64_t num_orders = state.range(1);
+    const uint64_t num_producers = state.range(2);
+    const uint8_t num_threads = 3;
+    std::vector<Order> orders;
+    orders.reserve(num_orders);
+    generateOrders(orders, num_orders, num_symbols);
+    // Give each producer the orders for its own symbols so that each book sees its orders in sequence.
+    std::vector<std::vector<Order>> producer_orders(num_producers);
+    for (const auto &order : orders)
+        producer_orders[order.getSymbolID() % num_producers].push_back(order);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::vector<std::unique_ptr<EventHandler>> event_handlers;
+        event_handlers.reserve(num_threads);
+        for (int i = 0; i < num_threads; ++i)
+            event_handlers.push_back(std::make_unique<EventHandler>());
+        ConcurrentMarket market{event_handlers, num_threads};
+        for (int i = 1; i <= num_symbols; ++i)
+            market.addSymbol(i, "MARKET BENCH");
+        state.ResumeTiming();
+        std::vector<std::thread> producers;
+        producers.reserve(num_producers);
+        for (const auto &producer_order : producer_orders)
+        {
+            producers.emplace_back([&market, &producer_order] {
+                for (const auto &order : producer_order)
+                    market.addOrder(order);
+            });
+        }
+        for (auto &producer : producers)
+            producer.join();
+    }
+}
+
 BENCHMARK(BM_ConcurrentMarket)
     ->Unit(benchmark::kMillisecond)
     ->Args({1, 1000000})
@@ -61,4 +100,12 @@ BENCHMARK(BM_ConcurrentMarket)
     ->Args({2000, 3000000})
     ->Args({2000, 4000000})
     ->ArgNames({"symbols", "orders"});
+BENCHMARK(BM_ConcurrentMarketProducers)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->Args({100, 2000000, 1})
+    ->Args({100, 2000000, 2})
+    ->Args({100, 2000000, 4})
+    ->Args({100, 2000000, 8})
+    ->ArgNames({"symbols", "orders", "producers"});
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 #include <iostream>
+#include <limits>
 #include <vector>
 #include "generate_orders.h"
 #include "market/market.h"
@@ -28,6 +29,41 @@ static void BM_Market(benchmark::State &state)
     }
 }
 
+static void BM_MarketRiskCheck(benchmark::State &state)
+{
+    const uint64_t num_symbols = state.range(0);
+    const uint64_t num_orders = state.range(1);
+    const bool use_risk_check = state.range(2) != 0;
+    const uint32_t num_owners = 1000;
+    std::vector<Order> orders;
+    orders.reserve(num_orders);
+    generateOrders(orders, num_orders, num_symbols, num_owners);
+    // Limits that are never reached, so that every order is fully checked and then submitted.
+    RiskLimits limits;
+    limits.max_position = std::numeric_limits<uint32_t>::max();
+    limits.max_order_notional = std::numeric_limits<uint64_t>::max();
+    limits.max_orders_per_window = std::numeric_limits<uint32_t>::max();
+    for (auto _ : state)
+    {
+        // Add all the symbols and the risk stage, if any, before adding any orders.
+        state.PauseTiming();
+        Market market{std::make_unique<EventHandler>()};
+        for (int i = 1; i <= num_symbols; ++i)
+            market.addSymbol(i, "MARKET BENCH");
+        if (use_risk_check)
+        {
+            auto risk_check = std::make_unique<AccountRiskCheck>(num_owners + 1);
+            for (uint32_t owner_id = 1; owner_id <= num_owners; ++owner_id)
+                risk_check->setLimits(owner_id, limits);
+            market.setRiskCheck(std::move(risk_check));
+        }
+        state.ResumeTiming();
+        // Add all the orders.
+        for (const auto &order : orders)
+            market.addOrder(order);
+    }
+}
+
 static void BM_ConcurrentMarket(benchmark::State &state)
 {
     const uint64_t num_symbols = state.range(0);
@@ -82,4 +118,14 @@ BENCHMARK(BM_Market)
     ->Args({2000, 3000000})
     ->Args({2000, 4000000})
     ->ArgNames({"symbols", "orders"});
+// The same orders are added with and without the risk stage to show the cost it adds to each order.
+BENCHMARK(BM_MarketRiskCheck)
+    ->Unit(benchmark::kMillisecond)
+    ->Args({1, 1000000, 0})
+    ->Args({1, 1000000, 1})
+    ->Args({100, 1000000, 0})
+    ->Args({100, 1000000, 1})
+    ->Args({1000, 1000000, 0})
+    ->Args({1000, 1000000, 1})
+    ->ArgNames({"symbols", "orders", "risk"});
 BENCHMARK_MAIN();
\ No newline at end of file
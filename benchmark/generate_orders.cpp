@@ -2,7 +2,7 @@
 
 using namespace RapidTrader;
 
-void generateOrders(std::vector<Order> &orders, uint32_t num_orders, uint32_t num_symbols)
+void generateOrders(std::vector<Order> &orders, uint32_t num_orders, uint32_t num_symbols, uint32_t num_owners)
 {
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -17,7 +17,9 @@ void generateOrders(std::vector<Order> &orders, uint32_t num_orders, uint32_t nu
         uint64_t quantity = (uniform_dist(gen) + 1) * 100;
         uint64_t order_id = i;
         uint64_t symbol_id = symbol_dist(gen);
-        orders.push_back(side == OrderSide::Ask ? Order::limitAskOrder(order_id, symbol_id, price, quantity, tof)
-                                                : Order::limitBidOrder(order_id, symbol_id, price, quantity, tof));
+        // Orders are spread evenly over the owners, if there are any.
+        uint32_t owner_id = num_owners == 0 ? 0 : i % num_owners + 1;
+        orders.push_back(side == OrderSide::Ask ? Order::limitAskOrder(order_id, symbol_id, price, quantity, tof, owner_id)
+                                                : Order::limitBidOrder(order_id, symbol_id, price, quantity, tof, owner_id));
     }
 }
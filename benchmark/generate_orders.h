@@ -4,5 +4,5 @@
 #include <random>
 #include "order.h"
 using namespace RapidTrader;
-void generateOrders(std::vector<Order> &orders, uint32_t num_orders, uint32_t num_symbols);
+void generateOrders(std::vector<Order> &orders, uint32_t num_orders, uint32_t num_symbols, uint32_t num_owners = 0);
 #endif // RAPID_TRADER_GENERATE_ORDERS_H
@@ -16,6 +16,18 @@ protected:
     {
         std::cout << notification << std::endl;
     }
+    void handleOrdersDeleted(const OrdersDeleted &notification) override
+    {
+        std::cout << notification << std::endl;
+    }
+    void handleOrdersExecuted(const OrdersExecuted &notification) override
+    {
+        std::cout << notification << std::endl;
+    }
+    void handleOrderRejected(const OrderRejected &notification) override
+    {
+        std::cout << notification << std::endl;
+    }
     void handleOrderUpdated(const OrderUpdated &notification) override
     {
         std::cout << notification << std::endl;
@@ -24,6 +36,10 @@ protected:
     {
         std::cout << notification << std::endl;
     }
+    void handleTrade(const Trade &notification) override
+    {
+        std::cout << notification << std::endl;
+    }
     void handleSymbolAdded(const SymbolAdded &notification) override
     {
         std::cout << notification << std::endl;
@@ -0,0 +1,166 @@
+#ifndef RAPID_TRADER_MPSC_QUEUE_H
+#define RAPID_TRADER_MPSC_QUEUE_H
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+namespace RapidTrader::Concurrent {
+/**
+ * A bounded lock-free multi-producer single-consumer queue. Each cell of the ring
+ * carries a sequence number that tells producers when the cell is free and the
+ * consumer when it has been filled, so producers only contend on claiming a
+ * position and never on a lock. Producers wait for the consumer when the ring
+ * is full.
+ *
+ * @tparam T the type of the objects that will be stored in the queue.
+ */
+template<typename T>
+class MpscQueue
+{
+public:
+    /**
+     * A constructor for the MPSC queue.
+     *
+     * @param capacity the number of objects that the queue can hold, require that
+     *                 capacity is a power of two that is at least two.
+     */
+    explicit MpscQueue(size_t capacity = size_t{1} << 14)
+        : cells(new Cell[capacity])
+        , mask(capacity - 1)
+        , enqueue_position(0)
+        , dequeue_position(0)
+    {
+        assert(capacity >= 2 && (capacity & (capacity - 1)) == 0 && "Capacity must be a power of two that is at least two!");
+        for (size_t i = 0; i < capacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue &other) = delete;
+    MpscQueue &operator=(const MpscQueue &other) = delete;
+
+    ~MpscQueue()
+    {
+        T data;
+        while (tryPop(data))
+            ;
+    }
+
+    /**
+     * Pushes an object onto the queue, waiting for space if the queue is full.
+     * May be called by any thread.
+     *
+     * @param data the object to push.
+     */
+    void push(T data)
+    {
+        size_t position = enqueue_position.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true)
+        {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0)
+            {
+                // The cell is free - try to claim it.
+                if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else
+            {
+                // The queue is full or another producer claimed the cell first.
+                if (difference < 0)
+                    std::this_thread::yield();
+                position = enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+        new (&cell->storage) T(std::move(data));
+        cell->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    /**
+     * Pushes an object onto the queue if there is space. May be called by any thread.
+     *
+     * @param data the object to push.
+     * @return true if the object was pushed and false if the queue is full.
+     */
+    bool tryPush(const T &data)
+    {
+        size_t position = enqueue_position.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true)
+        {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0)
+            {
+                if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+        new (&cell->storage) T(data);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pops an object from the queue if there is one. Must only be called by the consumer.
+     *
+     * @param data set to the popped object, if there is one.
+     * @return true if an object was popped and false otherwise.
+     */
+    bool tryPop(T &data)
+    {
+        Cell &cell = cells[dequeue_position & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeue_position + 1)
+            return false;
+        T *stored = std::launder(reinterpret_cast<T *>(&cell.storage));
+        data = std::move(*stored);
+        stored->~T();
+        // Hand the cell back to the producers for the next lap around the ring.
+        cell.sequence.store(dequeue_position + mask + 1, std::memory_order_release);
+        ++dequeue_position;
+        return true;
+    }
+
+    /**
+     * Must only be called by the consumer.
+     *
+     * @return true if there are no objects in the queue that are ready to be popped and false otherwise.
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return cells[dequeue_position & mask].sequence.load(std::memory_order_acquire) != dequeue_position + 1;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+    };
+
+    // The ring of cells.
+    std::unique_ptr<Cell[]> cells;
+    // The capacity of the ring minus one.
+    size_t mask;
+    // The position that the next object will be pushed at, shared by the producers.
+    alignas(64) std::atomic<size_t> enqueue_position;
+    // The position that the next object will be popped from, only used by the consumer.
+    alignas(64) size_t dequeue_position;
+};
+} // namespace RapidTrader::Concurrent
+#endif // RAPID_TRADER_MPSC_QUEUE_H
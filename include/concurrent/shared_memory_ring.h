@@ -0,0 +1,116 @@
+#ifndef RAPID_TRADER_SHARED_MEMORY_RING_H
+#define RAPID_TRADER_SHARED_MEMORY_RING_H
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <sys/mman.h>
+
+namespace RapidTrader::Concurrent {
+/**
+ * A bounded lock-free single-producer single-consumer ring that lives in a shared
+ * memory mapping. The mapping is inherited by processes that are forked after the
+ * ring is created, so the producer and the consumer may be different processes.
+ *
+ * @tparam T the type of the items in the ring, require that T is trivially copyable.
+ */
+template<typename T>
+class SharedMemoryRing
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Items must be trivially copyable!");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Positions must be lock free to be shared between processes!");
+
+public:
+    /**
+     * A constructor for the shared memory ring.
+     *
+     * @param capacity the number of items that the ring can hold, require that capacity is a positive power of two.
+     * @throws std::system_error if the shared memory cannot be mapped.
+     */
+    explicit SharedMemoryRing(size_t capacity)
+        : mapping_size(sizeof(Header) + capacity * sizeof(T))
+        , mask(capacity - 1)
+    {
+        assert(capacity > 0 && (capacity & (capacity - 1)) == 0 && "Capacity must be a positive power of two!");
+        void *mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED)
+            throw std::system_error(errno, std::generic_category(), "Failed to map shared memory");
+        header = new (mapping) Header;
+        items = reinterpret_cast<T *>(static_cast<char *>(mapping) + sizeof(Header));
+    }
+
+    SharedMemoryRing(const SharedMemoryRing &other) = delete;
+    SharedMemoryRing &operator=(const SharedMemoryRing &other) = delete;
+
+    ~SharedMemoryRing()
+    {
+        munmap(header, mapping_size);
+    }
+
+    /**
+     * Pushes an item onto the ring if there is space. Must only be called by the producer.
+     *
+     * @param item the item to push.
+     * @return true if the item was pushed and false if the ring is full.
+     */
+    bool tryPush(const T &item)
+    {
+        uint64_t tail = header->tail.load(std::memory_order_relaxed);
+        if (tail - header->head.load(std::memory_order_acquire) > mask)
+            return false;
+        items[tail & mask] = item;
+        header->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pushes an item onto the ring, waiting for space if the ring is full. Must only be called by the producer.
+     *
+     * @param item the item to push.
+     */
+    void push(const T &item)
+    {
+        while (!tryPush(item))
+            std::this_thread::yield();
+    }
+
+    /**
+     * Pops an item from the ring if there is one. Must only be called by the consumer.
+     *
+     * @param item set to the popped item, if there is one.
+     * @return true if an item was popped and false if the ring is empty.
+     */
+    bool tryPop(T &item)
+    {
+        uint64_t head = header->head.load(std::memory_order_relaxed);
+        if (head == header->tail.load(std::memory_order_acquire))
+            return false;
+        item = items[head & mask];
+        header->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct Header
+    {
+        // The position of the next item to pop, only written by the consumer.
+        alignas(64) std::atomic<uint64_t> head{0};
+        // The position of the next item to push, only written by the producer.
+        alignas(64) std::atomic<uint64_t> tail{0};
+    };
+
+    // The size of the shared memory mapping in bytes.
+    size_t mapping_size;
+    // The capacity of the ring minus one.
+    uint64_t mask;
+    // The positions of the ring, at the start of the mapping.
+    Header *header;
+    // The items of the ring, after the positions.
+    T *items;
+};
+} // namespace RapidTrader::Concurrent
+#endif // RAPID_TRADER_SHARED_MEMORY_RING_H
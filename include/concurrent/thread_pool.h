@@ -6,7 +6,7 @@
 #include <cassert>
 #include <future>
 #include "concurrent/thread_joiner.h"
-#include "concurrent/queue.h"
+#include "concurrent/mpsc_queue.h"
 
 namespace RapidTrader::Concurrent {
 class ThreadPool
@@ -33,7 +33,7 @@ public:
         {
             for (auto i = 0; i < num_threads; ++i)
             {
-                thread_queues.push_back(std::make_unique<Queue<std::function<void()>>>());
+                thread_queues.push_back(std::make_unique<MpscQueue<std::function<void()>>>());
                 threads.emplace_back(&ThreadPool::workerThread, this, i);
             }
         }
@@ -185,8 +185,8 @@ private:
     std::atomic_bool running;
     // The number of worker threads in the thread pool - must be at least 1.
     uint32_t num_threads;
-    // Thread-safe queue for each worker thread.
-    std::vector<std::unique_ptr<Queue<std::function<void()>>>> thread_queues;
+    // Lock-free queue for each worker thread. Tasks may be submitted to a queue from any number of threads.
+    std::vector<std::unique_ptr<MpscQueue<std::function<void()>>>> thread_queues;
     // The worker threads and their corresponding queues - each thread gets its own queue.
     std::vector<std::thread> threads;
     // Handles cleaning up the worker threads when the thread pool is destroyed.
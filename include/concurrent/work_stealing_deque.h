@@ -0,0 +1,174 @@
+#ifndef RAPID_TRADER_WORK_STEALING_DEQUE_H
+#define RAPID_TRADER_WORK_STEALING_DEQUE_H
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace RapidTrader::Concurrent {
+/**
+ * A lock-free Chase-Lev work-stealing deque. A single owner thread pushes and
+ * pops items at the bottom of the deque while any number of other threads steal
+ * items from the top. The deque grows when it is full. Arrays that have been
+ * outgrown are kept until the deque is destroyed since thieves may still be
+ * reading from them.
+ *
+ * @tparam T the type of the items in the deque, require that T is trivially copyable.
+ */
+template<typename T>
+class WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Items must be trivially copyable!");
+
+public:
+    /**
+     * A constructor for the work-stealing deque.
+     *
+     * @param capacity the initial capacity of the deque, require that capacity is a positive power of two.
+     */
+    explicit WorkStealingDeque(size_t capacity = 64)
+        : top(0)
+        , bottom(0)
+    {
+        assert(capacity > 0 && (capacity & (capacity - 1)) == 0 && "Capacity must be a positive power of two!");
+        arrays.push_back(std::make_unique<Array>(capacity));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque &other) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &other) = delete;
+
+    /**
+     * Pushes an item onto the bottom of the deque. Must only be called by the owner.
+     *
+     * @param item the item to push.
+     */
+    void push(T item)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Array *a = array.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(a->capacity) - 1)
+            a = grow(a, b, t);
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Pops an item from the bottom of the deque. Must only be called by the owner.
+     *
+     * @param item set to the popped item, if there is one.
+     * @return true if an item was popped and false if the deque was empty or the
+     *         last item was stolen.
+     */
+    bool pop(T &item)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array *a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            // The deque was empty.
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = a->get(b);
+        if (t == b)
+        {
+            // This is the last item, so race any thieves for it.
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /**
+     * Steals an item from the top of the deque. May be called by any thread.
+     *
+     * @param item set to the stolen item, if there is one.
+     * @return true if an item was stolen and false if the deque was empty or
+     *         another thread took the item first.
+     */
+    bool steal(T &item)
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return false;
+        Array *a = array.load(std::memory_order_acquire);
+        T stolen = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return false;
+        item = stolen;
+        return true;
+    }
+
+    /**
+     * @return true if the deque appeared to be empty when it was checked and false otherwise.
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Array
+    {
+        explicit Array(size_t capacity_)
+            : capacity(capacity_)
+            , mask(capacity_ - 1)
+            , items(new std::atomic<T>[capacity_])
+        {}
+
+        T get(int64_t index) const
+        {
+            return items[index & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T item)
+        {
+            items[index & mask].store(item, std::memory_order_relaxed);
+        }
+
+        size_t capacity;
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> items;
+    };
+
+    /**
+     * Replaces the array with one that is twice the size. Must only be called by the owner.
+     *
+     * @param a the current array.
+     * @param b the bottom of the deque.
+     * @param t the top of the deque.
+     * @return the new array.
+     */
+    Array *grow(Array *a, int64_t b, int64_t t)
+    {
+        arrays.push_back(std::make_unique<Array>(a->capacity * 2));
+        Array *grown = arrays.back().get();
+        for (int64_t i = t; i < b; ++i)
+            grown->put(i, a->get(i));
+        array.store(grown, std::memory_order_release);
+        return grown;
+    }
+
+    // The index of the next item to steal. Kept apart from the bottom so that
+    // thieves and the owner do not contend for the same cache line.
+    alignas(64) std::atomic<int64_t> top;
+    // The index that the next item will be pushed at.
+    alignas(64) std::atomic<int64_t> bottom;
+    // The array that currently holds the items.
+    std::atomic<Array *> array;
+    // Every array that has been used by the deque, only accessed by the owner.
+    std::vector<std::unique_ptr<Array>> arrays;
+};
+} // namespace RapidTrader::Concurrent
+#endif // RAPID_TRADER_WORK_STEALING_DEQUE_H
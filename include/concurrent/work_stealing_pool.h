@@ -0,0 +1,243 @@
+#ifndef RAPID_TRADER_WORK_STEALING_POOL_H
+#define RAPID_TRADER_WORK_STEALING_POOL_H
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include "concurrent/thread_joiner.h"
+#include "concurrent/queue.h"
+#include "concurrent/work_stealing_deque.h"
+
+namespace RapidTrader::Concurrent {
+/**
+ * A thread pool for tasks that do not need to run in any particular order or on any
+ * particular thread. Each worker thread owns a work-stealing deque - tasks submitted by
+ * a worker are pushed onto its own deque, tasks submitted from outside the pool are
+ * pushed onto a shared queue, and workers that run out of tasks steal from the other
+ * workers. Unlike the thread pool, a busy worker never holds up tasks that an idle
+ * worker could run. Workers that find no tasks for a while park on a condition variable
+ * until a task is scheduled, so an idle pool does not use any CPU time.
+ */
+class WorkStealingPool
+{
+public:
+    /**
+     * A constructor for the work-stealing pool.
+     *
+     * @param num_threads_ the number of worker threads that will be spawned by the pool,
+     *                     require that num_threads_ is positive.
+     */
+    explicit WorkStealingPool(uint32_t num_threads_ = std::thread::hardware_concurrency())
+        : running(true)
+        , num_threads(num_threads_)
+        , thread_joiner(threads)
+    {
+        assert(num_threads > 0 && "Work-stealing pool requires at least one thread!");
+        deques.reserve(num_threads);
+        for (uint32_t i = 0; i < num_threads; ++i)
+            deques.push_back(std::make_unique<WorkStealingDeque<Task *>>());
+        threads.reserve(num_threads);
+        try
+        {
+            for (uint32_t i = 0; i < num_threads; ++i)
+                threads.emplace_back(&WorkStealingPool::workerThread, this, i);
+        }
+        catch (...)
+        {
+            running = false;
+            throw;
+        }
+    }
+
+    /**
+     * Submits a void or non-void returning task that can be waited on to the pool for
+     * execution with zero or more arguments. May be called from any thread, including
+     * from tasks running in the pool.
+     *
+     * @tparam F a callable type.
+     * @tparam Args the arguments to the callable type.
+     * @tparam R the return type of the callable type.
+     * @param f the function that will be executed.
+     * @param args zero or more arguments for the function that will be executed.
+     * @return a future containing the return value of the executed function.
+     */
+    template<typename F, typename... Args, typename R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>>
+    std::future<R> submitTask(F &&f, Args &&...args)
+    {
+        std::function<R()> task = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+        auto task_promise = std::make_shared<std::promise<R>>();
+        std::future<R> future = task_promise->get_future();
+        schedule(new Task([task = std::move(task), task_promise] {
+            try
+            {
+                if constexpr (std::is_void_v<R>)
+                {
+                    task();
+                    task_promise->set_value();
+                }
+                else
+                {
+                    task_promise->set_value(task());
+                }
+            }
+            catch (...)
+            {
+                task_promise->set_exception(std::current_exception());
+            }
+        }));
+        return future;
+    }
+
+    /**
+     * @return number of worker threads the pool is using.
+     */
+    [[nodiscard]] uint32_t numberOfThreads() const
+    {
+        return num_threads;
+    }
+
+    /**
+     * A destructor for the work-stealing pool. Notifies worker threads that they are finished.
+     * The worker threads finish any tasks that have already been submitted.
+     */
+    ~WorkStealingPool()
+    {
+        running = false;
+        std::lock_guard<std::mutex> lk(idle_mutex);
+        idle_condition.notify_all();
+    }
+
+private:
+    using Task = std::function<void()>;
+
+    /**
+     * Pushes a task onto the deque of the calling worker if it belongs to this pool,
+     * otherwise onto the shared queue.
+     *
+     * @param task the task to schedule.
+     */
+    void schedule(Task *task)
+    {
+        if (current_pool == this)
+            deques[current_worker]->push(task);
+        else
+            injected.push(task);
+        // Pairs with the registration of a parking worker - either the worker sees the new
+        // epoch before it waits, or this sees the worker and wakes it.
+        wake_epoch.fetch_add(1);
+        if (num_parked.load() > 0)
+        {
+            std::lock_guard<std::mutex> lk(idle_mutex);
+            idle_condition.notify_one();
+        }
+    }
+
+    /**
+     * Finds a task for a worker to run. Tries the deque of the worker, then the
+     * shared queue, and then the deques of the other workers.
+     *
+     * @param worker_id the ID of the worker.
+     * @param task set to the task that was found, if any.
+     * @return true if a task was found and false otherwise.
+     */
+    bool findTask(uint32_t worker_id, Task *&task)
+    {
+        if (deques[worker_id]->pop(task) || injected.tryPop(task))
+            return true;
+        for (uint32_t i = 1; i < num_threads; ++i)
+        {
+            if (deques[(worker_id + i) % num_threads]->steal(task))
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * Parks a worker until a task is scheduled after the provided epoch or the pool is destroyed.
+     *
+     * @param epoch the wake epoch that was read before the worker last looked for a task.
+     */
+    void park(uint64_t epoch)
+    {
+        std::unique_lock<std::mutex> lk(idle_mutex);
+        ++num_parked;
+        idle_condition.wait(lk, [this, epoch] { return wake_epoch.load() != epoch || !running; });
+        --num_parked;
+    }
+
+    /**
+     * Finds and executes tasks until the pool is destroyed and there are no tasks left.
+     *
+     * @param worker_id the ID of the worker, require that worker_id < num_threads.
+     */
+    void workerThread(uint32_t worker_id)
+    {
+        current_pool = this;
+        current_worker = worker_id;
+        uint32_t idle_rounds = 0;
+        while (true)
+        {
+            // Read before looking for a task, so that a task scheduled after a failed search
+            // always changes the epoch that the worker parks on.
+            uint64_t epoch = wake_epoch.load();
+            Task *task = nullptr;
+            if (findTask(worker_id, task))
+            {
+                (*task)();
+                delete task;
+                idle_rounds = 0;
+            }
+            else if (!running)
+            {
+                break;
+            }
+            else if (++idle_rounds < max_idle_rounds)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                park(epoch);
+                idle_rounds = 0;
+            }
+        }
+        current_pool = nullptr;
+    }
+
+    // The number of failed searches for a task after which a worker parks instead of yielding.
+    static constexpr uint32_t max_idle_rounds = 64;
+
+    // The pool that the calling thread is a worker of, if any, and its worker ID.
+    inline static thread_local WorkStealingPool *current_pool = nullptr;
+    inline static thread_local uint32_t current_worker = 0;
+
+    // IMPORTANT: The running flag, the deques, the shared queue, and the parking state must
+    // be declared before the vector containing the threads so that they outlive the threads.
+
+    // Indicates whether the working threads are running.
+    std::atomic_bool running;
+    // The number of worker threads in the pool - must be at least 1.
+    uint32_t num_threads;
+    // The deque owned by each worker thread.
+    std::vector<std::unique_ptr<WorkStealingDeque<Task *>>> deques;
+    // Tasks submitted from outside of the pool.
+    Queue<Task *> injected;
+    // Incremented whenever a task is scheduled. A parked worker wakes once it changes.
+    std::atomic<uint64_t> wake_epoch{0};
+    // The number of workers that are parked or about to park.
+    std::atomic<uint32_t> num_parked{0};
+    // Guards parking and waking the workers.
+    std::mutex idle_mutex;
+    // Parked workers wait on this until a task is scheduled or the pool is destroyed.
+    std::condition_variable idle_condition;
+    // The worker threads.
+    std::vector<std::thread> threads;
+    // Handles cleaning up the worker threads when the pool is destroyed.
+    ThreadJoiner thread_joiner;
+};
+} // namespace RapidTrader::Concurrent
+#endif // RAPID_TRADER_WORK_STEALING_POOL_H
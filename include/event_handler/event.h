@@ -1,10 +1,13 @@
 #ifndef RAPID_TRADER_EVENT_H
 #define RAPID_TRADER_EVENT_H
+#include <vector>
 #include "order.h"
 
 namespace RapidTrader {
 struct Event
 {
+    // The sequence number of the command that caused the event. Zero if the event was not caused by a sequenced command.
+    uint64_t sequence_number = 0;
     virtual ~Event() = default;
 };
 
@@ -38,6 +41,28 @@ struct SymbolDeleted : public MarketEvent
     friend std::ostream &operator<<(std::ostream &os, const SymbolDeleted &notification);
 };
 
+struct OrdersDeleted : public MarketEvent
+{
+    std::vector<Order> orders;
+    OrdersDeleted(uint32_t symbol_id_, std::vector<Order> orders_)
+        : MarketEvent(symbol_id_)
+        , orders(std::move(orders_))
+    {}
+
+    friend std::ostream &operator<<(std::ostream &os, const OrdersDeleted &notification);
+};
+
+struct OrdersExecuted : public MarketEvent
+{
+    std::vector<Order> orders;
+    OrdersExecuted(uint32_t symbol_id_, std::vector<Order> orders_)
+        : MarketEvent(symbol_id_)
+        , orders(std::move(orders_))
+    {}
+
+    friend std::ostream &operator<<(std::ostream &os, const OrdersExecuted &notification);
+};
+
 struct OrderEvent : public Event
 {
     Order order;
@@ -81,5 +106,79 @@ struct OrderUpdated : public OrderEvent
 
     friend std::ostream &operator<<(std::ostream &os, const OrderUpdated &notification);
 };
+
+// The reasons that an order may be rejected without being added to an orderbook.
+enum class RejectReason : uint8_t
+{
+    Halted = 0,
+    OutsidePriceBand = 1,
+    PositionLimit = 2,
+    NotionalLimit = 3,
+    OrderRateLimit = 4,
+    UnknownAccount = 5,
+    UnknownSymbol = 6
+};
+
+struct OrderRejected : public OrderEvent
+{
+    RejectReason reason;
+    OrderRejected(Order order_, RejectReason reason_)
+        : OrderEvent(std::move(order_))
+        , reason(reason_)
+    {}
+
+    friend std::ostream &operator<<(std::ostream &os, const OrderRejected &notification);
+};
+
+// A fill between an incoming order and an order that was resting in the book.
+struct Trade : public MarketEvent
+{
+    // The IDs of the incoming order and of the resting order.
+    uint64_t aggressor_id;
+    uint64_t passive_id;
+    Price price;
+    Quantity quantity;
+    // The side of the incoming order.
+    OrderSide aggressor_side;
+    // The open quantity of each order after the fill, zero if the order was filled.
+    Quantity aggressor_open_quantity;
+    Quantity passive_open_quantity;
+    Trade(uint32_t symbol_id_, uint64_t aggressor_id_, uint64_t passive_id_, Price price_, Quantity quantity_, OrderSide aggressor_side_,
+        Quantity aggressor_open_quantity_, Quantity passive_open_quantity_)
+        : MarketEvent(symbol_id_)
+        , aggressor_id(aggressor_id_)
+        , passive_id(passive_id_)
+        , price(price_)
+        , quantity(quantity_)
+        , aggressor_side(aggressor_side_)
+        , aggressor_open_quantity(aggressor_open_quantity_)
+        , passive_open_quantity(passive_open_quantity_)
+    {}
+
+    friend std::ostream &operator<<(std::ostream &os, const Trade &notification);
+};
+
+// The trades of a symbol in one interval of time. A bar is only sent for an interval that had trades.
+struct TradeBar : public MarketEvent
+{
+    // The interval of the bar, from start_time up to but not including end_time, in nanoseconds since the epoch.
+    uint64_t start_time;
+    uint64_t end_time;
+    // The prices of the first, highest, lowest, and last trades in the interval.
+    Price open_price = 0;
+    Price high_price = 0;
+    Price low_price = 0;
+    Price close_price = 0;
+    // The total quantity traded and the number of trades in the interval.
+    Volume volume = 0;
+    uint64_t num_trades = 0;
+    TradeBar(uint32_t symbol_id_, uint64_t start_time_, uint64_t end_time_)
+        : MarketEvent(symbol_id_)
+        , start_time(start_time_)
+        , end_time(end_time_)
+    {}
+
+    friend std::ostream &operator<<(std::ostream &os, const TradeBar &notification);
+};
 } // namespace RapidTrader
 #endif // RAPID_TRADER_EVENT_H
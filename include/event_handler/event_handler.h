@@ -17,6 +17,25 @@ public:
 
     friend class OrderBookHandler;
     friend class MapOrderBook;
+    friend class ShardedMarket;
+    friend class SequencedEventMerger;
+
+private:
+    /**
+     * Stamps an event with the sequence number of the command that is being handled.
+     *
+     * @param event the event to stamp.
+     * @return the stamped event.
+     */
+    template<typename EventType>
+    EventType stamp(EventType event) const
+    {
+        event.sequence_number = sequence_number;
+        return event;
+    }
+
+    // The sequence number of the command that is being handled, set by the market before it applies the command.
+    uint64_t sequence_number = 0;
 
 protected:
     // LCOV_EXCL_START
@@ -34,6 +53,20 @@ protected:
      */
     virtual void handleOrderDeleted(const OrderDeleted &event) {}
 
+    /**
+     * Handles an event where many orders were deleted at once.
+     *
+     * @param event an event where many orders were deleted at once.
+     */
+    virtual void handleOrdersDeleted(const OrdersDeleted &event) {}
+
+    /**
+     * Handles an event where many orders were executed at once.
+     *
+     * @param event an event where many orders were executed at once.
+     */
+    virtual void handleOrdersExecuted(const OrdersExecuted &event) {}
+
     /**
      * Handles a event where an order was updated.
      *
@@ -48,6 +81,21 @@ protected:
      */
     virtual void handleOrderExecuted(const ExecutedOrder &event) {}
 
+    /**
+     * Handles an event where an incoming order was matched against an order resting in an
+     * orderbook. Sent once for each fill instead of an executed order event for each order.
+     *
+     * @param event an event where two orders traded with each other.
+     */
+    virtual void handleTrade(const Trade &event) {}
+
+    /**
+     * Handles an event where an order was rejected without being added to an orderbook.
+     *
+     * @param event an event where an order was rejected.
+     */
+    virtual void handleOrderRejected(const OrderRejected &event) {}
+
     /**
      * Handles an event where a symbol was added.
      *
@@ -61,6 +109,13 @@ protected:
      * @param event an event where a symbol was deleted.
      */
     virtual void handleSymbolDeleted(const SymbolDeleted &event) {}
+
+    /**
+     * Handles an event where a bar of trades was closed.
+     *
+     * @param event an event where a bar of trades was closed.
+     */
+    virtual void handleTradeBar(const TradeBar &event) {}
     // LCOV_EXCL_STOP
 };
 } // namespace RapidTrader
@@ -0,0 +1,117 @@
+#ifndef RAPID_TRADER_COMMAND_H
+#define RAPID_TRADER_COMMAND_H
+#include <string>
+#include "order_record.h"
+#include "orderbook.h"
+
+namespace RapidTrader {
+// The longest symbol name that can be carried by a command.
+constexpr size_t max_command_symbol_name_length = 31;
+
+// The types of commands. Sync and Stop are only sent from a sharded market to its shards.
+enum class CommandType : uint8_t
+{
+    AddSymbol = 0,
+    DeleteSymbol = 1,
+    AddOrder = 2,
+    DeleteOrder = 3,
+    DeleteOrders = 4,
+    DeleteSideOrders = 5,
+    DeletePriceRangeOrders = 6,
+    DeleteOwnerOrders = 7,
+    ExpireOrders = 8,
+    DeleteDayOrders = 9,
+    CancelOrder = 10,
+    ReplaceOrder = 11,
+    AmendOrder = 12,
+    ExecuteOrder = 13,
+    ExecuteOrderAtPrice = 14,
+    SetSelfTradePrevention = 15,
+    SetAllocationPolicy = 16,
+    StartAuction = 17,
+    UncrossAuction = 18,
+    HaltSymbol = 19,
+    ResumeSymbol = 20,
+    SetPriceBand = 21,
+    HaltMarket = 22,
+    ResumeMarket = 23,
+    Sync = 24,
+    Stop = 25,
+    SetBarInterval = 26,
+    CloseBars = 27,
+    SetRiskCheck = 28
+};
+
+/**
+ * A command that changes the state of a market, in a form that can be copied byte for
+ * byte to another process. Only the fields that are used by the type of the command
+ * are set, and the rest are zero.
+ */
+struct Command
+{
+    static Command addSymbol(uint32_t symbol_id, const std::string &symbol_name, size_t max_orders, size_t max_levels);
+    static Command deleteSymbol(uint32_t symbol_id, const std::string &symbol_name);
+    static Command addOrder(const Order &order);
+    static Command deleteOrder(uint32_t symbol_id, uint64_t order_id);
+    static Command deleteOrders(uint32_t symbol_id);
+    static Command deleteOrders(uint32_t symbol_id, OrderSide side);
+    static Command deleteOrders(uint32_t symbol_id, OrderSide side, Price min_price, Price max_price);
+    static Command deleteOwnerOrders(uint32_t owner_id);
+    static Command cancelOrder(uint32_t symbol_id, uint64_t order_id, Quantity cancelled_quantity);
+    static Command replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, Price new_price);
+    static Command amendOrder(uint32_t symbol_id, uint64_t order_id, Quantity new_quantity, Price new_price);
+    static Command executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity);
+    static Command executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity, Price price);
+    static Command setSelfTradePrevention(uint32_t symbol_id, SelfTradePrevention mode);
+    static Command setAllocationPolicy(uint32_t symbol_id, AllocationPolicy policy);
+    static Command setPriceBand(uint32_t symbol_id, uint32_t band_bps, Price reference_price);
+    static Command setBarInterval(uint32_t symbol_id, uint64_t bar_interval);
+    static Command setRiskCheck(bool installed);
+
+    /**
+     * @param type the type of the command, require that the command only needs a symbol ID or nothing at all.
+     * @param symbol_id the ID of the symbol that the command is for, or zero if it is not for a symbol.
+     * @return a new command.
+     */
+    static Command make(CommandType type, uint32_t symbol_id = 0);
+
+    // The position of the command in the stream of commands of the market, starting at one.
+    uint64_t sequence_number;
+    // The time at which the market received the command in nanoseconds since the epoch.
+    uint64_t timestamp;
+    OrderRecord order;
+    uint64_t order_id;
+    uint64_t new_order_id;
+    uint64_t max_orders;
+    uint64_t max_levels;
+    uint64_t bar_interval;
+    Quantity quantity;
+    Price price;
+    Price max_price;
+    uint32_t symbol_id;
+    uint32_t owner_id;
+    uint32_t band_bps;
+    CommandType type;
+    OrderSide side;
+    // The self-trade prevention mode, allocation policy, or whether a risk stage is installed.
+    uint8_t mode;
+    char symbol_name[max_command_symbol_name_length + 1];
+};
+
+/**
+ * Receives the commands of a market in the order that the market applies them.
+ */
+class CommandListener
+{
+public:
+    /**
+     * Handles a command that the market is about to apply.
+     *
+     * @param command the command, stamped with its sequence number and timestamp.
+     */
+    virtual void handleCommand(const Command &command) = 0;
+
+    virtual ~CommandListener() = default;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_COMMAND_H
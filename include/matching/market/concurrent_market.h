@@ -1,19 +1,38 @@
 #ifndef RAPID_TRADER_CONCURRENT_MARKET_H
 #define RAPID_TRADER_CONCURRENT_MARKET_H
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include "utils/robin_hood.h"
+#include "utils/clock.h"
 #include "concurrent/thread_pool.h"
+#include "concurrent/work_stealing_pool.h"
 #include "order.h"
 #include "orderbook.h"
 #include "symbol.h"
+#include "symbol_routing_table.h"
 
 namespace RapidTrader {
 using namespace Concurrent;
 class EventHandler;
 class OrderBookHandler;
 
+/**
+ * A market that matches the orders for each symbol on one of a number of worker threads.
+ * The methods of the market may be called from any number of threads. Operations on the
+ * same symbol are applied in the order that they were submitted by each thread.
+ *
+ * Each command is stamped with a sequence number when it is submitted, and the events that
+ * it causes carry that sequence number. The sequence numbers of the commands submitted to a
+ * worker increase in the order that the worker applies them, so the events of the workers
+ * can be merged into one deterministic order, e.g. with a SequencedEventMerger. Market-wide
+ * commands are sent to every worker under one sequence number.
+ */
 class ConcurrentMarket
 {
 public:
@@ -27,8 +46,13 @@ public:
      *                       vector is equal to the number of threads that will be used.
      * @param num_threads the number of worker threads that will be used, require that
      *                    num_threads is positive.
+     * @param clock the clock that decides when GTD orders expire, require that the clock
+     *              can be read from multiple threads.
+     * @param num_background_threads the number of threads that will be used for tasks that are not
+     *                               tied to a symbol, require that num_background_threads is positive.
      */
-    explicit ConcurrentMarket(std::vector<std::unique_ptr<EventHandler>> &event_handlers, uint8_t num_threads = 1);
+    explicit ConcurrentMarket(std::vector<std::unique_ptr<EventHandler>> &event_handlers, uint8_t num_threads = 1,
+        std::shared_ptr<Clock> clock = std::make_shared<SystemClock>(), uint8_t num_background_threads = 1);
 
     /**
      * Adds a new symbol to market asynchronously.
@@ -36,8 +60,10 @@ public:
      * @param symbol_id the ID that the symbol is identified by, require that
      *                  the symbol associated with symbol ID does not already exist.
      * @param symbol_name the name of the symbol.
+     * @param max_orders the expected maximum number of orders resting in the orderbook.
+     * @param max_levels the expected maximum number of price levels in the orderbook.
      */
-    void addSymbol(uint32_t symbol_id, const std::string &symbol_name);
+    void addSymbol(uint32_t symbol_id, const std::string &symbol_name, size_t max_orders = 0, size_t max_levels = 0);
 
     /**
      * Removes the symbol from the market asynchronously.
@@ -48,7 +74,8 @@ public:
     void deleteSymbol(uint32_t symbol_id);
 
     /**
-     * Submits a new order to the market asynchronously.
+     * Submits a new order to the market asynchronously. Orders for symbols that do not exist
+     * are rejected.
      *
      * @param order the order to submit.
      */
@@ -62,6 +89,53 @@ public:
      */
     void deleteOrder(uint32_t symbol_id, uint64_t order_id);
 
+    /**
+     * Deletes all orders for a symbol from the market asynchronously.
+     *
+     * @param symbol_id the symbol ID to delete orders for.
+     */
+    void deleteOrders(uint32_t symbol_id);
+
+    /**
+     * Deletes all orders on one side of the orderbook for a symbol from the market asynchronously.
+     *
+     * @param symbol_id the symbol ID to delete orders for.
+     * @param side the side of the orderbook to delete orders from.
+     */
+    void deleteOrders(uint32_t symbol_id, OrderSide side);
+
+    /**
+     * Deletes the orders on one side of the orderbook for a symbol that rest at a price
+     * within the provided range asynchronously. Stop orders rest at their stop price.
+     *
+     * @param symbol_id the symbol ID to delete orders for.
+     * @param side the side of the orderbook to delete orders from.
+     * @param min_price the lowest price to delete orders at.
+     * @param max_price the highest price to delete orders at, require that max_price >= min_price.
+     */
+    void deleteOrders(uint32_t symbol_id, OrderSide side, Price min_price, Price max_price);
+
+    /**
+     * Deletes all orders that belong to an owner from every orderbook in the market asynchronously.
+     * Each worker thread deletes the orders from its own orderbooks in parallel.
+     *
+     * @param owner_id the ID of the owner, require that owner_id is positive.
+     */
+    void deleteOwnerOrders(uint32_t owner_id);
+
+    /**
+     * Deletes the GTD orders that have expired from every orderbook in the market asynchronously.
+     * Expired orders are also deleted from an orderbook whenever an order is added to it, so this
+     * only needs to be called to delete expired orders from orderbooks that are idle.
+     */
+    void expireOrders();
+
+    /**
+     * Deletes all DAY orders from every orderbook in the market asynchronously, e.g. at the end
+     * of a trading session.
+     */
+    void deleteDayOrders();
+
     /**
      * Cancels the provided quantity of an existing order in the market asynchronously, require that the order exists.
      *
@@ -69,7 +143,7 @@ public:
      * @param order_id the ID associated with the order.
      * @param cancelled_quantity the quantity of the order to cancel, require that cancelled_quantity is positive.
      */
-    void cancelOrder(uint32_t symbol_id, uint64_t order_id, uint64_t cancelled_quantity);
+    void cancelOrder(uint32_t symbol_id, uint64_t order_id, Quantity cancelled_quantity);
 
     /**
      * Replaces an existing order in the market asynchronously, require that the order exists.
@@ -79,7 +153,118 @@ public:
      * @param new_order_id the new ID to assign to the order.
      * @param new_price the new price to assign to the order, require that price is positive.
      */
-    void replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, uint64_t new_price);
+    void replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, Price new_price);
+
+    /**
+     * Amends the quantity and price of an existing order in the market asynchronously, require that the order exists.
+     * Reducing the quantity of an order without changing its price keeps its time priority.
+     *
+     * @param symbol_id the symbol ID associated with the order.
+     * @param order_id the ID associated with the order.
+     * @param new_quantity the new open quantity of the order, require that new_quantity is positive.
+     * @param new_price the new price of the order.
+     */
+    void amendOrder(uint32_t symbol_id, uint64_t order_id, Quantity new_quantity, Price new_price);
+
+    /**
+     * Sets how the orderbook of a symbol handles orders with the same owner that would trade
+     * with each other asynchronously, require that the symbol exists. Self-trade prevention
+     * is disabled by default.
+     *
+     * @param symbol_id the ID of the symbol.
+     * @param mode the self-trade prevention mode.
+     */
+    void setSelfTradePrevention(uint32_t symbol_id, SelfTradePrevention mode);
+
+    /**
+     * Sets how the orderbook of a symbol allocates incoming orders between the orders resting
+     * at a price level asynchronously, require that the symbol exists. Orderbooks use FIFO
+     * allocation by default.
+     *
+     * @param symbol_id the ID of the symbol.
+     * @param policy the allocation policy.
+     */
+    void setAllocationPolicy(uint32_t symbol_id, AllocationPolicy policy);
+
+    /**
+     * Starts an auction for a symbol asynchronously, require that the symbol exists. Limit orders
+     * for the symbol rest in its orderbook without being matched until the auction is uncrossed.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void startAuction(uint32_t symbol_id);
+
+    /**
+     * Halts trading in a symbol asynchronously, require that the symbol exists. New orders for the
+     * symbol are rejected until it is resumed, but existing orders may still be cancelled or deleted.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void haltSymbol(uint32_t symbol_id);
+
+    /**
+     * Resumes trading in a symbol after a halt asynchronously, require that the symbol exists.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void resumeSymbol(uint32_t symbol_id);
+
+    /**
+     * Sets a price band for a symbol asynchronously, require that the symbol exists. New limit
+     * orders for the symbol with a price outside of the band are rejected.
+     *
+     * @param symbol_id the ID of the symbol.
+     * @param band_bps the width of the band on either side of the reference price in basis points
+     *                 of the reference price, or zero to remove the band.
+     * @param reference_price the reference price, or zero to use the last traded price of the symbol.
+     */
+    void setPriceBand(uint32_t symbol_id, uint32_t band_bps, Price reference_price = 0);
+
+    /**
+     * Sets the length of the bars that the trades of a symbol are aggregated into asynchronously,
+     * require that the symbol exists. Closes the bar of the symbol that is open, if any.
+     *
+     * @param symbol_id the ID of the symbol.
+     * @param bar_interval the length of the bars in nanoseconds of the clock of the market, or
+     *                     zero to stop sending bars for the symbol.
+     */
+    void setBarInterval(uint32_t symbol_id, uint64_t bar_interval);
+
+    /**
+     * Sends the bars of every orderbook in the market whose interval has ended asynchronously.
+     * Each worker thread sends the bars of its own orderbooks in parallel.
+     */
+    void closeBars();
+
+    /**
+     * Halts trading in every symbol in the market asynchronously. The halt is sent to every worker
+     * thread, and each worker rejects new orders once it has processed the halt. Halting the market
+     * does not change whether individual symbols are halted.
+     */
+    void haltMarket();
+
+    /**
+     * Resumes trading in the market after a market-wide halt asynchronously.
+     */
+    void resumeMarket();
+
+    /**
+     * Installs a pre-trade risk stage asynchronously, replacing any existing risk stage. The risk
+     * stage is shared by every worker thread, so the limits of an account that trades symbols owned
+     * by different workers are enforced across all of them, and it must be safe to call from every
+     * worker thread.
+     *
+     * @param risk_check the risk stage, or nullptr to remove the risk stage.
+     */
+    void setRiskCheck(std::shared_ptr<RiskCheck> risk_check);
+
+    /**
+     * Ends the auction for a symbol asynchronously by executing all crossed orders at the auction
+     * price and returns the orderbook of the symbol to continuous matching, require that the symbol exists.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void uncrossAuction(uint32_t symbol_id);
 
     /**
      * Executes an existing order in the market asynchronously.
@@ -89,7 +274,7 @@ public:
      * @param quantity the quantity of the order to execute, require that quantity is positive.
      * @param price the price at which the order is executed, require that price is positive.
      */
-    void executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity, uint64_t price);
+    void executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity, Price price);
 
     /**
      * Executes an existing order in the market asynchronously.
@@ -98,10 +283,90 @@ public:
      * @param order_id the ID associated with the order.
      * @param quantity the quantity of the order to execute, require that quantity is positive.
      */
-    void executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity);
+    void executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity);
+
+    /**
+     * Queries the best price on each side of the orderbook of a symbol and the volume resting at it
+     * asynchronously. The query is answered by the worker thread that owns the symbol once it has
+     * applied the commands that were submitted before the query, without blocking the caller.
+     *
+     * @param symbol_id the symbol ID of the orderbook.
+     * @return a future for the result, only the symbol ID is set if the symbol does not exist.
+     */
+    std::future<BestBidOffer> queryBestBidOffer(uint32_t symbol_id);
+
+    /**
+     * Queries the best limit levels on each side of the orderbook of a symbol asynchronously.
+     *
+     * @param symbol_id the symbol ID of the orderbook.
+     * @param max_levels the maximum number of levels to return for each side.
+     * @return a future for the result, with no levels if the symbol does not exist.
+     */
+    std::future<BookDepth> queryDepth(uint32_t symbol_id, size_t max_levels);
 
     /**
-     * @return the string representation of the market.
+     * Looks up an order that is resting in the orderbook of a symbol asynchronously.
+     *
+     * @param symbol_id the symbol ID associated with the order.
+     * @param order_id the ID associated with the order.
+     * @return a future for a copy of the order, or nothing if the order is not resting in the orderbook.
+     */
+    std::future<std::optional<Order>> queryOrder(uint32_t symbol_id, uint64_t order_id);
+
+    /**
+     * Queries a summary of the state of the orderbook of a symbol asynchronously.
+     *
+     * @param symbol_id the symbol ID of the orderbook.
+     * @return a future for the result, only the symbol ID is set if the symbol does not exist.
+     */
+    std::future<SymbolStatistics> queryStatistics(uint32_t symbol_id);
+
+    /**
+     * Queries the best bid and offer of many symbols at once asynchronously. Each worker thread is
+     * sent one task for all of the symbols that it owns, and the workers answer in parallel.
+     *
+     * @param symbol_ids the symbol IDs of the orderbooks.
+     * @return a future for the results, in the same order as the symbol IDs.
+     */
+    std::future<std::vector<BestBidOffer>> queryBestBidOffers(const std::vector<uint32_t> &symbol_ids);
+
+    /**
+     * Queries the best bid and offer of many symbols at once, delivering the results to a callback.
+     *
+     * @param symbol_ids the symbol IDs of the orderbooks.
+     * @param callback called with the results in the same order as the symbol IDs by the worker
+     *                 thread that answers last, so it should not block.
+     */
+    void queryBestBidOffers(const std::vector<uint32_t> &symbol_ids, std::function<void(std::vector<BestBidOffer>)> callback);
+
+    /**
+     * Queries a summary of the state of many symbols at once asynchronously.
+     *
+     * @param symbol_ids the symbol IDs of the orderbooks.
+     * @return a future for the results, in the same order as the symbol IDs.
+     */
+    std::future<std::vector<SymbolStatistics>> queryStatistics(const std::vector<uint32_t> &symbol_ids);
+
+    /**
+     * Queries a summary of the state of many symbols at once, delivering the results to a callback.
+     *
+     * @param symbol_ids the symbol IDs of the orderbooks.
+     * @param callback called with the results in the same order as the symbol IDs by the worker
+     *                 thread that answers last, so it should not block.
+     */
+    void queryStatistics(const std::vector<uint32_t> &symbol_ids, std::function<void(std::vector<SymbolStatistics>)> callback);
+
+    /**
+     * May be called from any thread, e.g. by the thread that merges the events of the workers.
+     *
+     * @return a sequence number such that every worker thread has emitted all of the events of the
+     *         commands with a sequence number at or below it.
+     */
+    [[nodiscard]] uint64_t sequenceWatermark() const;
+
+    /**
+     * @return the string representation of the market. Each worker thread only takes a snapshot of
+     *         its orderbooks - the snapshots are formatted by the background threads.
      */
     [[nodiscard]] std::string toString();
 
@@ -113,24 +378,180 @@ public:
      */
     void dumpMarket(const std::string &name);
 
+    /**
+     * Writes a binary dump of the books to a file with the provided name. Creates a new
+     * file. Each worker thread only takes a snapshot of its orderbooks - the snapshots are
+     * written by the calling thread as soon as they are taken.
+     *
+     * @param name the name of the file that will be written to.
+     * @throws std::system_error if the file could not be written.
+     */
+    void dumpMarketBinary(const std::string &name);
+
     friend std::ostream &operator<<(std::ostream &os, ConcurrentMarket &concurrent_market);
 
 private:
     /**
-     * Gets the index that that corresponds to the queue in the thread pool
-     * that the new task should be submitted to as well the index of the orderbook
-     * handler that the task should use.
+     * Submits a task to the worker thread that owns a symbol. The task is dropped if the
+     * symbol does not exist, e.g. because another producer deleted it. A symbol that is
+     * deleted after the task is routed is skipped by the worker.
+     *
+     * @param symbol_id the ID of the symbol.
+     * @param task the task to submit, which is called with the orderbook handler of the worker.
+     */
+    template<typename Task>
+    void submitSymbolTask(uint32_t symbol_id, Task task)
+    {
+        uint32_t submission_index = symbol_routes.find(symbol_id);
+        if (submission_index == SymbolRoutingTable::unknown_symbol)
+            return;
+        submitSequencedTask(submission_index, task);
+    }
+
+    /**
+     * Stamps a task with the next sequence number and submits it to a worker thread. The sequence
+     * number is taken and the task is queued under the ingress lock of the worker, so that the
+     * tasks in each queue are in sequence order while producers that submit to different workers
+     * do not wait for each other.
+     *
+     * @param submission_index the index of the worker thread.
+     * @param task the task to submit, which is called with the orderbook handler of the worker.
+     */
+    template<typename Task>
+    void submitSequencedTask(uint32_t submission_index, Task task)
+    {
+        WorkerSequence &worker_sequence = worker_sequences[submission_index];
+        std::lock_guard lock(worker_sequence.ingress_mutex);
+        worker_sequence.queuing.store(true);
+        uint64_t command_sequence_number = sequence_number.fetch_add(1) + 1;
+        queueSequencedTask(submission_index, command_sequence_number, task);
+    }
+
+    /**
+     * Stamps a task with the next sequence number and submits it to every worker thread. Holds the
+     * ingress lock of every worker, so that the task has the same place in the order of every queue.
+     *
+     * @param task the task to submit, which is called with the orderbook handler of each worker.
+     */
+    template<typename Task>
+    void submitBroadcastTask(Task task)
+    {
+        // The locks are always taken in the order of the workers, so broadcasts cannot deadlock.
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(orderbook_handlers.size());
+        for (uint32_t i = 0; i < orderbook_handlers.size(); ++i)
+        {
+            locks.emplace_back(worker_sequences[i].ingress_mutex);
+            worker_sequences[i].queuing.store(true);
+        }
+        uint64_t command_sequence_number = sequence_number.fetch_add(1) + 1;
+        for (uint32_t i = 0; i < orderbook_handlers.size(); ++i)
+            queueSequencedTask(i, command_sequence_number, task);
+    }
+
+    /**
+     * Queues a task that has been stamped with a sequence number to a worker thread, require
+     * that the caller holds the ingress lock of the worker and has marked the worker as queuing.
+     *
+     * @param submission_index the index of the worker thread.
+     * @param command_sequence_number the sequence number of the task.
+     * @param task the task to queue, which is called with the orderbook handler of the worker.
+     */
+    template<typename Task>
+    void queueSequencedTask(uint32_t submission_index, uint64_t command_sequence_number, Task task)
+    {
+        OrderBookHandler *orderbook_handler = orderbook_handlers[submission_index].get();
+        WorkerSequence *worker_sequence = &worker_sequences[submission_index];
+        thread_pool.submitTask(submission_index, [=] {
+            beginCommand(orderbook_handler, command_sequence_number);
+            task(orderbook_handler);
+            worker_sequence->completed.store(command_sequence_number, std::memory_order_release);
+        });
+        worker_sequence->submitted.store(command_sequence_number);
+        worker_sequence->queuing.store(false);
+    }
+
+    /**
+     * Sends a query about many symbols to the worker threads that own them, one task per worker.
      *
-     * @param symbol_id the symbol ID to get the submission index for
-     * @return the submission index associated with the symbol ID.
+     * @param symbol_ids the symbol IDs to query.
+     * @param query called with the orderbook handler of a worker and a symbol ID to answer the query for the symbol.
+     * @param callback called with the results in the same order as the symbol IDs once every worker has answered.
      */
-    uint32_t getSubmissionIndex(uint32_t symbol_id);
+    template<typename Result, typename Query>
+    void submitBatchQuery(const std::vector<uint32_t> &symbol_ids, Query query, std::function<void(std::vector<Result>)> callback)
+    {
+        struct BatchQuery
+        {
+            std::vector<Result> results;
+            std::atomic<uint32_t> remaining_workers{0};
+            std::function<void(std::vector<Result>)> callback;
+        };
+        // The positions of the symbols owned by each worker, paired with their symbol IDs.
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> worker_symbols(orderbook_handlers.size());
+        for (uint32_t i = 0; i < symbol_ids.size(); ++i)
+            worker_symbols[submissionIndex(symbol_ids[i])].emplace_back(i, symbol_ids[i]);
+        auto batch = std::make_shared<BatchQuery>();
+        batch->results.resize(symbol_ids.size());
+        batch->callback = std::move(callback);
+        uint32_t num_workers = 0;
+        for (const auto &symbols : worker_symbols)
+            num_workers += symbols.empty() ? 0 : 1;
+        if (num_workers == 0)
+        {
+            batch->callback(std::move(batch->results));
+            return;
+        }
+        batch->remaining_workers.store(num_workers, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < worker_symbols.size(); ++i)
+        {
+            if (worker_symbols[i].empty())
+                continue;
+            OrderBookHandler *orderbook_handler = orderbook_handlers[i].get();
+            auto symbols = std::make_shared<std::vector<std::pair<uint32_t, uint32_t>>>(std::move(worker_symbols[i]));
+            thread_pool.submitTask(i, [=] {
+                for (const auto &[position, symbol_id] : *symbols)
+                    batch->results[position] = query(orderbook_handler, symbol_id);
+                // The worker that answers last sees the results of the others.
+                if (batch->remaining_workers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    batch->callback(std::move(batch->results));
+            });
+        }
+    }
+
+    /**
+     * @param symbol_id a symbol ID.
+     * @return the index of the worker thread that owns the symbol, or of an arbitrary worker thread
+     *         if the symbol does not exist.
+     */
+    [[nodiscard]] uint32_t submissionIndex(uint32_t symbol_id) const;
+
+    /**
+     * Sets the sequence number that a worker stamps the events of the command it is about to apply with.
+     *
+     * @param orderbook_handler the orderbook handler of the worker.
+     * @param command_sequence_number the sequence number of the command.
+     */
+    static void beginCommand(OrderBookHandler *orderbook_handler, uint64_t command_sequence_number);
 
     /**
      * Increments the symbol submission index modulo the number of orderbook handlers.
      */
     void updateSymbolSubmissionIndex();
 
+    // The progress of a worker thread through the sequence numbers.
+    struct WorkerSequence
+    {
+        // Serializes stamping commands for the worker with sequence numbers and queuing them.
+        alignas(64) std::mutex ingress_mutex;
+        // True from the time a command for the worker takes a sequence number until it is queued.
+        std::atomic<bool> queuing{false};
+        // The sequence number of the last command submitted to the worker.
+        std::atomic<uint64_t> submitted{0};
+        // The sequence number of the last command that the worker has applied.
+        alignas(64) std::atomic<uint64_t> completed{0};
+    };
+
     // The number of orderbook handlers is equivalent to the number of worker threads in the thread pool.
     std::vector<std::unique_ptr<OrderBookHandler>> orderbook_handlers;
     // Maps symbol IDs to symbols.
@@ -138,13 +559,23 @@ private:
     // Maps symbol IDs to the submission indices. A submission index
     // corresponds to the thread pool queue that a task (that is associated with the symbol ID)
     // should be submitted to. Additionally, the submission index corresponds to the orderbook
-    // handler that is associated with the symbol ID.
-    robin_hood::unordered_map<uint32_t, uint32_t> id_to_submission_index;
+    // handler that is associated with the symbol ID. Looked up without locking.
+    SymbolRoutingTable symbol_routes;
+    // Serializes adding and deleting symbols. Only held by threads that change the symbols.
+    std::mutex symbols_mutex;
     // The thread pool that order operations will be submitted to.
     ThreadPool thread_pool;
+    // Runs tasks that are not tied to the serial order of a symbol, such as formatting the
+    // market, on whichever of its threads is idle.
+    WorkStealingPool background_pool;
     // The index of the thread pool queue and orderbook handler that will be associated
     // with a newly added symbol.
     uint32_t symbol_submission_index;
+    // The sequence number of the last command that was stamped. Commands for different workers
+    // may be queued in a different order than they were stamped in.
+    std::atomic<uint64_t> sequence_number;
+    // The progress of each worker thread through the sequence numbers.
+    std::unique_ptr<WorkerSequence[]> worker_sequences;
 };
 } // namespace RapidTrader
 #endif // RAPID_TRADER_CONCURRENT_MARKET_H
@@ -3,12 +3,17 @@
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include "utils/log.h"
 #include "utils/robin_hood.h"
+#include "utils/clock.h"
 #include "order.h"
 #include "orderbook.h"
 #include "symbol.h"
 #include "event_handler.h"
+#include "risk_check.h"
+#include "command.h"
+#include "book_dump.h"
 
 namespace RapidTrader {
 class EventHandler;
@@ -17,9 +22,9 @@ class EventHandler;
 // Necessary to prevent race condition in concurrent market.
 struct OrderBookHandler
 {
-    explicit OrderBookHandler(std::unique_ptr<EventHandler> event_handler);
+    OrderBookHandler(std::unique_ptr<EventHandler> event_handler, std::shared_ptr<Clock> clock);
 
-    void addOrderBook(uint32_t symbol_id, std::string symbol_name);
+    void addOrderBook(uint32_t symbol_id, std::string symbol_name, size_t max_orders = 0, size_t max_levels = 0);
 
     void deleteOrderBook(uint32_t symbol_id, std::string symbol_name);
 
@@ -27,17 +32,95 @@ struct OrderBookHandler
 
     void deleteOrder(uint32_t symbol_id, uint64_t order_id);
 
-    void cancelOrder(uint32_t symbol_id, uint64_t order_id, uint64_t cancelled_quantity);
+    void deleteOrders(uint32_t symbol_id);
 
-    void replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, uint64_t new_price);
+    void deleteOrders(uint32_t symbol_id, OrderSide side);
 
-    void executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity, uint64_t price);
+    void deleteOrders(uint32_t symbol_id, OrderSide side, Price min_price, Price max_price);
 
-    void executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity);
+    void deleteOwnerOrders(uint32_t owner_id);
+
+    void expireOrders();
+
+    void deleteDayOrders();
+
+    void cancelOrder(uint32_t symbol_id, uint64_t order_id, Quantity cancelled_quantity);
+
+    void replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, Price new_price);
+
+    void amendOrder(uint32_t symbol_id, uint64_t order_id, Quantity new_quantity, Price new_price);
+
+    void setSelfTradePrevention(uint32_t symbol_id, SelfTradePrevention mode);
+
+    void setAllocationPolicy(uint32_t symbol_id, AllocationPolicy policy);
+
+    void startAuction(uint32_t symbol_id);
+
+    void uncrossAuction(uint32_t symbol_id);
+
+    void haltSymbol(uint32_t symbol_id);
+
+    void resumeSymbol(uint32_t symbol_id);
+
+    void setPriceBand(uint32_t symbol_id, uint32_t band_bps, Price reference_price);
+
+    void setBarInterval(uint32_t symbol_id, uint64_t bar_interval);
+
+    void closeBars();
+
+    void haltMarket();
+
+    void resumeMarket();
+
+    void setRiskCheck(std::shared_ptr<RiskCheck> risk_check);
+
+    void executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity, Price price);
+
+    void executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity);
+
+    [[nodiscard]] Volume bidVolumeAtOrAbove(uint32_t symbol_id, Price price) const;
+
+    [[nodiscard]] Volume askVolumeAtOrBelow(uint32_t symbol_id, Price price) const;
+
+    [[nodiscard]] uint64_t numberOfGrowthEvents(uint32_t symbol_id) const;
+
+    [[nodiscard]] Price auctionPrice(uint32_t symbol_id) const;
+
+    [[nodiscard]] std::vector<BookSnapshot> snapshot() const;
+
+    // Writes the books to a binary dump one at a time.
+    void dump(BookDumpWriter &writer) const;
+
+    // The queries return empty results for symbols that do not exist.
+    [[nodiscard]] BestBidOffer bestBidOffer(uint32_t symbol_id) const;
+
+    [[nodiscard]] BookDepth depth(uint32_t symbol_id, size_t max_levels) const;
+
+    [[nodiscard]] std::optional<Order> findOrder(uint32_t symbol_id, uint64_t order_id) const;
+
+    [[nodiscard]] SymbolStatistics statistics(uint32_t symbol_id) const;
+
+    // Sets the sequence number that the events of the next commands will be stamped with.
+    void setSequenceNumber(uint64_t sequence_number);
 
     std::string toString();
 
 private:
+    /**
+     * @param symbol_id the ID of a symbol.
+     * @return the book of the symbol, or nullptr if the symbol does not exist. The commands and queries for
+     *         a symbol that does not exist are ignored, since another producer of a concurrent market may
+     *         delete the symbol after a command for it has been routed.
+     */
+    [[nodiscard]] OrderBook *findBook(uint32_t symbol_id) const;
+
+    // Decides when GTD orders expire. Must outlive the order books.
+    std::shared_ptr<Clock> clock;
+    // Checks the orders that enter the order books, nullptr if there is no risk stage. May be
+    // shared with the handlers of other threads. Must outlive the order books.
+    std::shared_ptr<RiskCheck> risk_check;
+    // True if trading in every orderbook is halted.
+    bool market_halted;
     // Maps symbol IDs to order books.
     robin_hood::unordered_map<uint32_t, std::unique_ptr<OrderBook>> id_to_book;
     // Handles orderbook events.
@@ -54,8 +137,10 @@ public:
      * A constructor for the Market.
      *
      * @param outgoing_messages_ the event handler that will be used by the market.
+     * @param clock the clock that decides when GTD orders expire. It is read at most once per command,
+     *              and the whole command is applied at that time.
      */
-    explicit Market(std::unique_ptr<EventHandler> event_handler);
+    explicit Market(std::unique_ptr<EventHandler> event_handler, std::shared_ptr<Clock> clock = std::make_shared<SystemClock>());
 
     /**
      * Adds a new symbol and a corresponding orderbook to market.
@@ -63,8 +148,10 @@ public:
      * @param symbol_id the ID that the symbol is identified by, require that
      *                  the symbol associated with symbol ID does not already exist.
      * @param symbol_name the name of the symbol.
+     * @param max_orders the expected maximum number of orders resting in the orderbook.
+     * @param max_levels the expected maximum number of price levels in the orderbook.
      */
-    void addSymbol(uint32_t symbol_id, const std::string &symbol_name);
+    void addSymbol(uint32_t symbol_id, const std::string &symbol_name, size_t max_orders = 0, size_t max_levels = 0);
 
     /**
      * Removes the symbol and the corresponding orderbook from the market.
@@ -81,7 +168,7 @@ public:
     [[nodiscard]] bool hasSymbol(uint32_t symbol_id) const;
 
     /**
-     * Submits a new order to the market.
+     * Submits a new order to the market. Orders for symbols that do not exist are rejected.
      *
      * @param order the order to submit.
      */
@@ -95,6 +182,51 @@ public:
      */
     void deleteOrder(uint32_t symbol_id, uint64_t order_id);
 
+    /**
+     * Deletes all orders for a symbol from the market.
+     *
+     * @param symbol_id the symbol ID to delete orders for.
+     */
+    void deleteOrders(uint32_t symbol_id);
+
+    /**
+     * Deletes all orders on one side of the orderbook for a symbol from the market.
+     *
+     * @param symbol_id the symbol ID to delete orders for.
+     * @param side the side of the orderbook to delete orders from.
+     */
+    void deleteOrders(uint32_t symbol_id, OrderSide side);
+
+    /**
+     * Deletes the orders on one side of the orderbook for a symbol that rest at a price
+     * within the provided range. Stop orders rest at their stop price.
+     *
+     * @param symbol_id the symbol ID to delete orders for.
+     * @param side the side of the orderbook to delete orders from.
+     * @param min_price the lowest price to delete orders at.
+     * @param max_price the highest price to delete orders at, require that max_price >= min_price.
+     */
+    void deleteOrders(uint32_t symbol_id, OrderSide side, Price min_price, Price max_price);
+
+    /**
+     * Deletes all orders that belong to an owner from every orderbook in the market.
+     *
+     * @param owner_id the ID of the owner, require that owner_id is positive.
+     */
+    void deleteOwnerOrders(uint32_t owner_id);
+
+    /**
+     * Deletes the GTD orders that have expired from every orderbook in the market. Expired
+     * orders are also deleted from an orderbook whenever an order is added to it, so this
+     * only needs to be called to delete expired orders from orderbooks that are idle.
+     */
+    void expireOrders();
+
+    /**
+     * Deletes all DAY orders from every orderbook in the market, e.g. at the end of a trading session.
+     */
+    void deleteDayOrders();
+
     /**
      * Cancels the provided quantity of an existing order in the market, require that the order exists.
      *
@@ -102,17 +234,132 @@ public:
      * @param order_id the ID associated with the order.
      * @param cancelled_quantity the quantity of the order to cancel, require that cancelled_quantity is positive.
      */
-    void cancelOrder(uint32_t symbol_id, uint64_t order_id, uint64_t cancelled_quantity);
+    void cancelOrder(uint32_t symbol_id, uint64_t order_id, Quantity cancelled_quantity);
 
     /**
-     * Replaces an existing order in the market, require that the order exists.
+     * Replaces an existing order in the market, require that the order exists. The new order is
+     * rejected, and the existing order left in the book, while the market or symbol is halted or
+     * if the new price is outside the price band of the symbol.
      *
      * @param symbol_id the symbol ID associated with the order.
      * @param order_id the ID associated with the order.
      * @param new_order_id the new ID to assign to the order.
      * @param new_price the new price to assign to the order, require that price is positive.
      */
-    void replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, uint64_t new_price);
+    void replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, Price new_price);
+
+    /**
+     * Amends the quantity and price of an existing order in the market, require that the order exists.
+     * Reducing the quantity of an order without changing its price keeps its time priority. The
+     * amendment is rejected, and the order left as it was, while the market or symbol is halted
+     * or if the new price is outside the price band of the symbol.
+     *
+     * @param symbol_id the symbol ID associated with the order.
+     * @param order_id the ID associated with the order.
+     * @param new_quantity the new open quantity of the order, require that new_quantity is positive.
+     * @param new_price the new price of the order.
+     */
+    void amendOrder(uint32_t symbol_id, uint64_t order_id, Quantity new_quantity, Price new_price);
+
+    /**
+     * Sets how the orderbook of a symbol handles orders with the same owner that would trade
+     * with each other, require that the symbol exists. Self-trade prevention is disabled by default.
+     *
+     * @param symbol_id the ID of the symbol.
+     * @param mode the self-trade prevention mode.
+     */
+    void setSelfTradePrevention(uint32_t symbol_id, SelfTradePrevention mode);
+
+    /**
+     * Sets how the orderbook of a symbol allocates incoming orders between the orders resting
+     * at a price level, require that the symbol exists. Orderbooks use FIFO allocation by default.
+     *
+     * @param symbol_id the ID of the symbol.
+     * @param policy the allocation policy.
+     */
+    void setAllocationPolicy(uint32_t symbol_id, AllocationPolicy policy);
+
+    /**
+     * Starts an auction for a symbol, require that the symbol exists. Limit orders for the
+     * symbol rest in its orderbook without being matched until the auction is uncrossed.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void startAuction(uint32_t symbol_id);
+
+    /**
+     * Halts trading in a symbol, require that the symbol exists. New orders for the symbol are
+     * rejected until it is resumed, but existing orders may still be cancelled or deleted.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void haltSymbol(uint32_t symbol_id);
+
+    /**
+     * Resumes trading in a symbol after a halt, require that the symbol exists.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void resumeSymbol(uint32_t symbol_id);
+
+    /**
+     * Sets a price band for a symbol, require that the symbol exists. New limit orders for the
+     * symbol with a price outside of the band are rejected.
+     *
+     * @param symbol_id the ID of the symbol.
+     * @param band_bps the width of the band on either side of the reference price in basis points
+     *                 of the reference price, or zero to remove the band.
+     * @param reference_price the reference price, or zero to use the last traded price of the symbol.
+     */
+    void setPriceBand(uint32_t symbol_id, uint32_t band_bps, Price reference_price = 0);
+
+    /**
+     * Sets the length of the bars that the trades of a symbol are aggregated into, require that
+     * the symbol exists. Each bar is sent to the event handler once its interval has ended,
+     * and only if it had trades. Closes the bar of the symbol that is open, if any.
+     *
+     * @param symbol_id the ID of the symbol.
+     * @param bar_interval the length of the bars in nanoseconds of the clock of the market, or
+     *                     zero to stop sending bars for the symbol.
+     */
+    void setBarInterval(uint32_t symbol_id, uint64_t bar_interval);
+
+    /**
+     * Sends the bars of every orderbook in the market whose interval has ended. Bars are also
+     * sent whenever a trade occurs in an orderbook, so this only needs to be called to send
+     * the bars of orderbooks that are idle, e.g. on a timer.
+     */
+    void closeBars();
+
+    /**
+     * Halts trading in every symbol in the market. New orders are rejected until the market is
+     * resumed. Halting the market does not change whether individual symbols are halted.
+     */
+    void haltMarket();
+
+    /**
+     * Resumes trading in the market after a market-wide halt.
+     */
+    void resumeMarket();
+
+    /**
+     * Installs a pre-trade risk stage in the market, replacing any existing risk stage. New orders,
+     * replacements, and amendments that reprice an order or increase its quantity are checked by the
+     * risk stage after the halts and price bands of the market, and orders that fail the check are
+     * rejected. The open quantity of the resting orders is recorded by the new risk stage. Installing
+     * or removing the risk stage is sequenced like any other command.
+     *
+     * @param risk_check the risk stage, or nullptr to remove the risk stage.
+     */
+    void setRiskCheck(std::shared_ptr<RiskCheck> risk_check);
+
+    /**
+     * Ends the auction for a symbol by executing all crossed orders at the auction price and
+     * returns the orderbook of the symbol to continuous matching, require that the symbol exists.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void uncrossAuction(uint32_t symbol_id);
 
     /**
      * Executes an existing order in the market.
@@ -122,7 +369,7 @@ public:
      * @param quantity the quantity of the order to execute, require that quantity is positive.
      * @param price the price at which the order is executed, require that price is positive.
      */
-    void executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity, uint64_t price);
+    void executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity, Price price);
 
     /**
      * Executes an existing order in the market.
@@ -131,7 +378,62 @@ public:
      * @param order_id the ID associated with the order.
      * @param quantity the quantity of the order to execute, require that quantity is positive.
      */
-    void executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity);
+    void executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity);
+
+    /**
+     * @param symbol_id the symbol ID of an orderbook, require that the symbol exists.
+     * @param price a price.
+     * @return the total open quantity of the bid limit orders in the orderbook with a price
+     *         greater than or equal to the provided price.
+     */
+    [[nodiscard]] Volume bidVolumeAtOrAbove(uint32_t symbol_id, Price price) const;
+
+    /**
+     * @param symbol_id the symbol ID of an orderbook, require that the symbol exists.
+     * @param price a price.
+     * @return the total open quantity of the ask limit orders in the orderbook with a price
+     *         less than or equal to the provided price.
+     */
+    [[nodiscard]] Volume askVolumeAtOrBelow(uint32_t symbol_id, Price price) const;
+
+    /**
+     * @param symbol_id the symbol ID of an orderbook, require that the symbol exists.
+     * @return the number of times the orderbook has had to grow its internal storage.
+     */
+    [[nodiscard]] uint64_t numberOfGrowthEvents(uint32_t symbol_id) const;
+
+    /**
+     * @param symbol_id the symbol ID of an orderbook, require that the symbol exists.
+     * @return the price that the orderbook would uncross an auction at if it is crossed, otherwise zero.
+     */
+    [[nodiscard]] Price auctionPrice(uint32_t symbol_id) const;
+
+    /**
+     * @param symbol_id the symbol ID of an orderbook.
+     * @return the best price on each side of the orderbook and the volume resting at it, only
+     *         the symbol ID is set if the symbol does not exist.
+     */
+    [[nodiscard]] BestBidOffer bestBidOffer(uint32_t symbol_id) const;
+
+    /**
+     * @param symbol_id the symbol ID of an orderbook.
+     * @param max_levels the maximum number of levels to return for each side.
+     * @return the best limit levels on each side of the orderbook, no levels if the symbol does not exist.
+     */
+    [[nodiscard]] BookDepth depth(uint32_t symbol_id, size_t max_levels) const;
+
+    /**
+     * @param symbol_id the symbol ID associated with the order.
+     * @param order_id the ID associated with the order.
+     * @return a copy of the order if it is resting in the orderbook of the symbol, otherwise nothing.
+     */
+    [[nodiscard]] std::optional<Order> findOrder(uint32_t symbol_id, uint64_t order_id) const;
+
+    /**
+     * @param symbol_id the symbol ID of an orderbook.
+     * @return a summary of the state of the orderbook, only the symbol ID is set if the symbol does not exist.
+     */
+    [[nodiscard]] SymbolStatistics statistics(uint32_t symbol_id) const;
 
     /**
      * @return the string representation of the market.
@@ -146,13 +448,72 @@ public:
      */
     void dumpMarket(const std::string &name) const;
 
+    /**
+     * Writes a binary dump of the books to a file with the provided name. Creates a new
+     * file. Each book is written as soon as its snapshot is taken, so the dump is much
+     * faster to produce than the string representation. The dump can be read with a
+     * BookDumpReader, e.g. by the dump reader tool.
+     *
+     * @param name the name of the file that will be written to.
+     * @throws std::system_error if the file could not be written.
+     */
+    void dumpMarketBinary(const std::string &name) const;
+
+    /**
+     * Applies a command to the market, e.g. one that was received from another market. A command
+     * that is stamped with a sequence number is applied under that sequence number, so that its
+     * events carry the sequence number of the market that stamped it.
+     *
+     * @param command the command to apply, require that it is not a Sync or Stop command.
+     * @param risk_check the risk stage that a SetRiskCheck command installs, require that it is
+     *                   provided if the command installs a risk stage. Ignored by other commands.
+     */
+    void applyCommand(const Command &command, const std::shared_ptr<RiskCheck> &risk_check = nullptr);
+
+    /**
+     * Sets the listener that is sent every command that changes the state of the market,
+     * stamped with a sequence number and the time at which it was received, before the
+     * command is applied. Replaying the commands in order on an empty market reproduces the
+     * state of the market. Installing or removing a risk stage is sent as a command, but the
+     * stage itself is not, so the market replaying the commands must provide a stage that is
+     * configured like the one of this market.
+     *
+     * @param listener the command listener, or nullptr if there is none. The listener must
+     *                 outlive the market and should be set before the first command.
+     */
+    void setCommandListener(CommandListener *listener);
+
     friend std::ostream &operator<<(std::ostream &os, const Market &book);
 
 private:
+    /**
+     * Assigns the next sequence number to the command that is about to be applied. The events
+     * of the command are stamped with it, and the command is applied at the first time that is
+     * read from the clock while it is applied.
+     */
+    void sequenceCommand();
+
+    /**
+     * Stamps a command with its sequence number and the time at which it is applied and
+     * sends it to the command listener, require that there is a command listener.
+     *
+     * @param command the command to send.
+     */
+    void publish(Command command);
+
+    class CommandClock;
+
+    // Holds the time at which the command that is being applied was received. Declared before
+    // the orderbook handler, which reads the time from it.
+    std::shared_ptr<CommandClock> clock;
     // Submits order operations to their respective orderbook.
     std::unique_ptr<OrderBookHandler> orderbook_handler;
     // Symbol IDs to symbols.
     robin_hood::unordered_map<uint32_t, std::unique_ptr<Symbol>> id_to_symbol;
+    // Receives the commands of the market, nullptr if there is no listener.
+    CommandListener *command_listener;
+    // The sequence number of the last command that was applied.
+    uint64_t sequence_number;
 };
 } // namespace RapidTrader
 #endif // RAPID_TRADER_MARKET_H
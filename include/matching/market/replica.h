@@ -0,0 +1,215 @@
+#ifndef RAPID_TRADER_REPLICA_H
+#define RAPID_TRADER_REPLICA_H
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "concurrent/mpsc_queue.h"
+#include "market.h"
+#include "command.h"
+
+namespace RapidTrader {
+using namespace Concurrent;
+
+/**
+ * Supported replication modes.
+ *
+ * Sync: each command is written to the replica before the primary applies it, so the
+ * primary waits on the replica.
+ *
+ * Async: commands are queued and written to the replica by a background thread, so the
+ * primary never waits on the replica. Commands are dropped if the queue is full, which
+ * the replica detects as a sequence gap.
+ */
+enum class ReplicationMode : uint8_t
+{
+    Sync = 0,
+    Async = 1
+};
+
+/**
+ * Sends the commands of a primary market to a replica over a connected stream socket,
+ * e.g. one end of a Unix domain socket pair. Install it on the primary market with
+ * Market::setCommandListener.
+ */
+class ReplicaPublisher : public CommandListener
+{
+public:
+    /**
+     * A constructor for the replica publisher.
+     *
+     * @param socket_fd_ a connected stream socket to the replica, which the publisher takes ownership of.
+     * @param mode_ the replication mode.
+     * @param queue_capacity the number of commands that can be waiting to be sent in async mode,
+     *                       require that queue_capacity is a power of two that is at least two.
+     */
+    ReplicaPublisher(int socket_fd_, ReplicationMode mode_, size_t queue_capacity = size_t{1} << 14);
+
+    /**
+     * Sends any commands that are waiting to be sent and closes the socket.
+     */
+    ~ReplicaPublisher() override;
+
+    void handleCommand(const Command &command) override;
+
+    /**
+     * Waits until every command that has been published has been sent to the replica or dropped.
+     */
+    void flush() const;
+
+    /**
+     * @return the sequence number of the last command that was published.
+     */
+    [[nodiscard]] uint64_t publishedSequence() const
+    {
+        return published_sequence.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return the sequence number of the last command that was sent to the replica.
+     */
+    [[nodiscard]] uint64_t sentSequence() const
+    {
+        return sent_sequence.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return the number of commands that were dropped because the queue was full or the replica
+     *         disconnected.
+     */
+    [[nodiscard]] uint64_t droppedCommands() const
+    {
+        return dropped_commands.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return the number of commands that have been published but not yet sent or dropped.
+     */
+    [[nodiscard]] uint64_t backlog() const;
+
+private:
+    /**
+     * Writes a command to the socket. Stops sending commands if the replica has disconnected.
+     *
+     * @param command the command to write.
+     */
+    void send(const Command &command);
+
+    /**
+     * Sends queued commands until the publisher is destroyed and the queue is empty.
+     */
+    void sendCommands();
+
+    // The socket that commands are written to, or -1 if the replica has disconnected.
+    int socket_fd;
+    ReplicationMode mode;
+    // The commands waiting to be sent in async mode.
+    MpscQueue<Command> queue;
+    // The number of commands that have been published, sent, and dropped.
+    std::atomic<uint64_t> published_commands;
+    std::atomic<uint64_t> sent_commands;
+    std::atomic<uint64_t> dropped_commands;
+    std::atomic<uint64_t> published_sequence;
+    std::atomic<uint64_t> sent_sequence;
+    std::atomic_bool running;
+    // Sends the queued commands in async mode.
+    std::thread sender;
+};
+
+/**
+ * A hot standby that applies the commands of a primary market to its own market in
+ * the same order, reproducing the state of the primary. Commands must be applied from
+ * the first command of the primary. The replica stops applying commands as soon as it
+ * sees a sequence gap, since its books would no longer match the primary.
+ *
+ * GTD orders expire on the replica using the times at which the primary received the
+ * commands, so the replica expires the same orders as the primary. The replica installs
+ * and removes its own risk stage at the same points in the commands as the primary.
+ */
+class Replica
+{
+public:
+    /**
+     * A constructor for the replica.
+     *
+     * @param socket_fd_ a connected stream socket to the primary, which the replica takes ownership of.
+     * @param event_handler the event handler of the market of the replica.
+     * @param risk_check_ the risk stage that the replica installs whenever the primary installs one, or nullptr if
+     *                    the primary never installs one. It must be in the same state and have the same limits as
+     *                    the stage of the primary when it is installed, and must not be shared with other markets,
+     *                    so that it accepts and rejects the same orders as the stage of the primary.
+     */
+    Replica(int socket_fd_, std::unique_ptr<EventHandler> event_handler, std::shared_ptr<RiskCheck> risk_check_ = nullptr);
+
+    Replica(const Replica &other) = delete;
+    Replica &operator=(const Replica &other) = delete;
+
+    ~Replica();
+
+    /**
+     * Applies the commands that have been received from the primary without waiting.
+     *
+     * @return the number of commands that were applied.
+     */
+    size_t poll();
+
+    /**
+     * @return the sequence number of the last command that was applied.
+     */
+    [[nodiscard]] uint64_t appliedSequence() const
+    {
+        return applied_sequence;
+    }
+
+    /**
+     * @return the time between the primary receiving the last applied command and the replica
+     *         applying it in nanoseconds, assuming that the primary and replica share a clock.
+     */
+    [[nodiscard]] uint64_t lagNanoseconds() const
+    {
+        return lag_nanoseconds;
+    }
+
+    /**
+     * @return true if a command was missing from the commands received from the primary.
+     */
+    [[nodiscard]] bool hasGap() const
+    {
+        return gap;
+    }
+
+    /**
+     * @return the market of the replica.
+     */
+    [[nodiscard]] const Market &getMarket() const
+    {
+        return *market;
+    }
+
+    /**
+     * Makes the replica the primary. Applies the commands that have already been received,
+     * disconnects from the old primary, and switches the market to the system clock.
+     *
+     * @return the market of the replica, which may be used as the new primary. The replica must not be used afterwards.
+     */
+    std::unique_ptr<Market> promote();
+
+private:
+    class ReplayClock;
+
+    // The socket that commands are read from, or -1 if the replica has been promoted.
+    int socket_fd;
+    // The clock of the market - follows the primary until the replica is promoted.
+    std::shared_ptr<ReplayClock> clock;
+    // Installed in the market when the primary installs its risk stage.
+    std::shared_ptr<RiskCheck> risk_check;
+    std::unique_ptr<Market> market;
+    // The bytes received from the primary that have not been applied yet.
+    std::vector<char> buffer;
+    size_t buffered;
+    uint64_t applied_sequence;
+    uint64_t lag_nanoseconds;
+    bool gap;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_REPLICA_H
@@ -0,0 +1,192 @@
+#ifndef RAPID_TRADER_RISK_CHECK_H
+#define RAPID_TRADER_RISK_CHECK_H
+#include <atomic>
+#include <vector>
+#include "utils/clock.h"
+#include "order.h"
+#include "event_handler/event.h"
+
+namespace RapidTrader {
+/**
+ * A pre-trade risk stage. New orders, replacements, and amendments that reprice an order or
+ * increase its quantity are checked by the risk stage before they enter an orderbook. The risk
+ * stage is told about every execution of an order and about every quantity that leaves a book
+ * without being executed, so that it can track both the positions of accounts and the open
+ * quantity of their orders. A risk stage may be shared by the orderbooks of several threads, in
+ * which case it must be safe to call from all of them.
+ */
+class RiskCheck
+{
+public:
+    /**
+     * Checks whether an order may enter an orderbook. If the order is accepted, its open quantity
+     * counts towards the exposure of its account until it is executed or released.
+     *
+     * @param order the order.
+     * @param replaced_quantity the open quantity of the order that this order replaces or amends,
+     *                          which stops counting towards the exposure of the account if the
+     *                          order is accepted, or zero for a new order.
+     * @param reference_price the price that an order without a limit or stop price is valued at,
+     *                        or zero if the orderbook has no reference price.
+     * @param clock the clock of the orderbooks, which is only read if the check needs the time.
+     * @param reason set to the reason the order is rejected, if it is.
+     * @return true if the order should be rejected and false otherwise.
+     */
+    virtual bool rejectOrder(
+        const Order &order, Quantity replaced_quantity, Price reference_price, const Clock &clock, RejectReason &reason) = 0;
+
+    /**
+     * Records an order that entered an orderbook without being checked, such as an order that was
+     * resting in a book when the risk stage was installed.
+     *
+     * @param order the order, its open quantity counts towards the exposure of its account.
+     */
+    virtual void orderAccepted(const Order &order) = 0;
+
+    /**
+     * Records an execution of an order.
+     *
+     * @param order the order that was executed, its last executed quantity is the quantity
+     *              of the execution.
+     */
+    virtual void orderExecuted(const Order &order) = 0;
+
+    /**
+     * Records open quantity of an order that left an orderbook without being executed, because
+     * the order was cancelled, reduced, deleted, expired, or could not rest in the book.
+     *
+     * @param order the order.
+     * @param quantity the open quantity that left the book.
+     */
+    virtual void orderReleased(const Order &order, Quantity quantity) = 0;
+
+    virtual ~RiskCheck() = default;
+};
+
+/**
+ * The limits that an account is held to. A limit of zero means that the limit is not enforced.
+ */
+struct RiskLimits
+{
+    // The largest long or short position that the account may hold if all of its open orders on one side are executed.
+    uint64_t max_position = 0;
+    // The largest notional value, i.e. price times quantity, of a single order. Orders without a
+    // limit or stop price are valued at the reference price of their book, and are rejected if
+    // the book has no reference price.
+    uint64_t max_order_notional = 0;
+    // The most orders that the account may submit within a single rate window.
+    uint32_t max_orders_per_window = 0;
+};
+
+/**
+ * A risk stage that enforces position, order notional, and order rate limits for each
+ * account. Accounts are identified by the owner IDs of orders and are stored in a table
+ * indexed by owner ID that is allocated up front, with each account on its own cache
+ * line, so checking an order is a single lookup and never allocates. Orders without an
+ * owner are not checked and orders with an owner outside of the table are rejected.
+ * Each account is guarded by its own spin lock, so a single table may be shared by the
+ * orderbooks of every worker thread of a concurrent market.
+ */
+class AccountRiskCheck : public RiskCheck
+{
+public:
+    /**
+     * A constructor for the account risk check.
+     *
+     * @param max_accounts the number of accounts in the table, owner IDs must be less than max_accounts.
+     * @param window_duration_ the length of an order rate window in nanoseconds, require that
+     *                         window_duration_ is positive.
+     */
+    explicit AccountRiskCheck(size_t max_accounts, uint64_t window_duration_ = 1000000000);
+
+    /**
+     * Sets the limits of an account.
+     *
+     * @param owner_id the owner ID of the account, require that 0 < owner_id < max_accounts.
+     * @param limits the limits of the account.
+     */
+    void setLimits(uint32_t owner_id, const RiskLimits &limits);
+
+    /**
+     * @param owner_id the owner ID of an account, require that 0 < owner_id < max_accounts.
+     * @return the position of the account - positive if it is long and negative if it is short.
+     */
+    [[nodiscard]] int64_t getPosition(uint32_t owner_id) const;
+
+    /**
+     * @param owner_id the owner ID of an account, require that 0 < owner_id < max_accounts.
+     * @param side the side of the orders.
+     * @return the open quantity of the orders of the account on the side.
+     */
+    [[nodiscard]] uint64_t getOpenQuantity(uint32_t owner_id, OrderSide side) const;
+
+    /**
+     * @inheritdoc
+     */
+    bool rejectOrder(
+        const Order &order, Quantity replaced_quantity, Price reference_price, const Clock &clock, RejectReason &reason) override;
+
+    /**
+     * @inheritdoc
+     */
+    void orderAccepted(const Order &order) override;
+
+    /**
+     * @inheritdoc
+     */
+    void orderExecuted(const Order &order) override;
+
+    /**
+     * @inheritdoc
+     */
+    void orderReleased(const Order &order, Quantity quantity) override;
+
+private:
+    // Kept to a single cache line so that checking an order touches one line.
+    struct alignas(64) Account
+    {
+        RiskLimits limits;
+        // Executed bid quantity minus executed ask quantity.
+        int64_t position = 0;
+        // The open quantity of the bid orders of the account.
+        uint64_t open_bid_quantity = 0;
+        // The open quantity of the ask orders of the account.
+        uint64_t open_ask_quantity = 0;
+        // The time that the current rate window started at.
+        uint64_t window_start = 0;
+        // The number of orders submitted in the current rate window.
+        uint32_t orders_in_window = 0;
+        // True while a thread is reading or updating the account.
+        mutable std::atomic<bool> locked{false};
+    };
+
+    /**
+     * Holds the spin lock of an account for as long as it exists.
+     */
+    class AccountLock
+    {
+    public:
+        explicit AccountLock(const Account &account_);
+        AccountLock(const AccountLock &other) = delete;
+        AccountLock &operator=(const AccountLock &other) = delete;
+        ~AccountLock();
+
+    private:
+        const Account &account;
+    };
+
+    /**
+     * @param account an account.
+     * @param side a side of the book.
+     * @return the open quantity of the orders of the account on the side.
+     */
+    static uint64_t &openQuantity(Account &account, OrderSide side)
+    {
+        return side == OrderSide::Bid ? account.open_bid_quantity : account.open_ask_quantity;
+    }
+
+    std::vector<Account> accounts;
+    uint64_t window_duration;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_RISK_CHECK_H
@@ -0,0 +1,87 @@
+#ifndef RAPID_TRADER_SEQUENCED_EVENT_MERGER_H
+#define RAPID_TRADER_SEQUENCED_EVENT_MERGER_H
+#include <deque>
+#include <memory>
+#include <variant>
+#include <vector>
+#include "concurrent/mpsc_queue.h"
+#include "event_handler/event.h"
+#include "concurrent_market.h"
+
+namespace RapidTrader {
+using namespace Concurrent;
+
+/**
+ * Merges the events of the worker threads of a concurrent market into one stream that is
+ * delivered to a single event handler in a deterministic total order: by sequence number,
+ * then by the index of the worker for market-wide commands, then in the order that the
+ * worker emitted them. Given the same sequence of commands, the merged stream is the same
+ * on every run regardless of how the workers are scheduled.
+ *
+ * The event handlers returned by createEventHandlers must be passed to the concurrent market,
+ * and the merger must outlive the market. An event is delivered by poll once the market's
+ * sequence watermark has reached its sequence number, so it is held back for no longer than
+ * it takes every worker to apply the commands that were submitted before its own. Workers wait
+ * for the merger when their queue of undelivered events is full.
+ */
+class SequencedEventMerger
+{
+public:
+    /**
+     * A constructor for the sequenced event merger.
+     *
+     * @param event_handler_ the event handler that the merged events are delivered to.
+     * @param num_workers the number of worker threads of the concurrent market, require that num_workers is positive.
+     * @param queue_capacity the number of events of each worker that can be waiting to be merged,
+     *                       require that queue_capacity is a power of two that is at least two.
+     */
+    SequencedEventMerger(std::unique_ptr<EventHandler> event_handler_, uint32_t num_workers, size_t queue_capacity = size_t{1} << 14);
+
+    SequencedEventMerger(const SequencedEventMerger &other) = delete;
+    SequencedEventMerger &operator=(const SequencedEventMerger &other) = delete;
+
+    ~SequencedEventMerger();
+
+    /**
+     * Creates the event handlers that the worker threads of the concurrent market will send
+     * their events to, require that it is only called once.
+     *
+     * @return a vector with an event handler for each worker thread.
+     */
+    std::vector<std::unique_ptr<EventHandler>> createEventHandlers();
+
+    /**
+     * Delivers the events whose sequence number is at or below the sequence watermark of the
+     * market without waiting. Must only be called by one thread at a time.
+     *
+     * @param market the concurrent market that was constructed with the event handlers of the merger.
+     * @return the number of events that were delivered.
+     */
+    size_t poll(const ConcurrentMarket &market);
+
+    /**
+     * @return the number of events that have been received from the workers but not delivered.
+     */
+    [[nodiscard]] size_t pending() const;
+
+private:
+    using SequencedEvent = std::variant<std::monostate, OrderAdded, OrderDeleted, OrderUpdated, ExecutedOrder, OrderRejected,
+        OrdersDeleted, OrdersExecuted, SymbolAdded, SymbolDeleted, Trade, TradeBar>;
+
+    class WorkerEventHandler;
+
+    /**
+     * @param event the event to deliver to the event handler of the merger.
+     */
+    void deliver(const SequencedEvent &event);
+
+    // Receives the merged events.
+    std::unique_ptr<EventHandler> event_handler;
+    // The events sent by each worker that have not been received by the merger yet.
+    std::vector<std::unique_ptr<MpscQueue<SequencedEvent>>> worker_queues;
+    // The events received from each worker that are waiting for the watermark to reach them.
+    std::vector<std::deque<SequencedEvent>> pending_events;
+    bool created_event_handlers;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_SEQUENCED_EVENT_MERGER_H
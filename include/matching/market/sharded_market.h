@@ -0,0 +1,353 @@
+#ifndef RAPID_TRADER_SHARDED_MARKET_H
+#define RAPID_TRADER_SHARDED_MARKET_H
+#include <memory>
+#include <vector>
+#include <sys/types.h>
+#include "utils/robin_hood.h"
+#include "concurrent/shared_memory_ring.h"
+#include "event_handler/event.h"
+#include "order_record.h"
+#include "command.h"
+#include "symbol.h"
+
+namespace RapidTrader {
+using namespace Concurrent;
+class EventHandler;
+
+enum class ShardEventType : uint8_t
+{
+    OrderAdded = 0,
+    OrderDeleted = 1,
+    OrderUpdated = 2,
+    OrderExecuted = 3,
+    OrderRejected = 4,
+    OrdersDeleted = 5,
+    OrdersExecuted = 6,
+    SymbolAdded = 7,
+    SymbolDeleted = 8,
+    Synced = 9,
+    Trade = 10,
+    TradeBar = 11
+};
+
+// The fields of a trade event, in a form that can be copied byte for byte to another process.
+struct TradeRecord
+{
+    uint64_t aggressor_id;
+    uint64_t passive_id;
+    Price price;
+    Quantity quantity;
+    Quantity aggressor_open_quantity;
+    Quantity passive_open_quantity;
+    OrderSide aggressor_side;
+};
+
+// The fields of a trade bar event, in a form that can be copied byte for byte to another process.
+struct TradeBarRecord
+{
+    uint64_t start_time;
+    uint64_t end_time;
+    Price open_price;
+    Price high_price;
+    Price low_price;
+    Price close_price;
+    Volume volume;
+    uint64_t num_trades;
+};
+
+// An event sent from a shard to the router. Events about several orders are sent as one
+// event with the number of orders followed by an event for each order.
+struct ShardEvent
+{
+    // The sequence number that the router stamped the command that caused the event with.
+    uint64_t sequence_number;
+    OrderRecord order;
+    // Only set for trade events.
+    TradeRecord trade;
+    // Only set for trade bar events.
+    TradeBarRecord bar;
+    uint32_t symbol_id;
+    uint32_t num_orders;
+    ShardEventType type;
+    RejectReason reason;
+    char symbol_name[max_command_symbol_name_length + 1];
+};
+
+/**
+ * A market whose symbols are sharded across worker processes on the same host. Each shard
+ * is a forked process that owns the orderbooks of its symbols. The market routes commands
+ * to the shards through shared memory rings and delivers the events that the shards send
+ * back through shared memory to an event handler for each shard. Since each shard has its
+ * own address space, a shard that fails does not corrupt the others.
+ *
+ * Each command is stamped with a sequence number that is unique across the shards, and the
+ * events that it causes carry that sequence number.
+ *
+ * The market must only be used by one thread. Events are delivered from within calls to
+ * pollEvents and sync, and from within other calls while a shard is waiting for space
+ * to send events.
+ *
+ * The router checks that a shard process is still running whenever it has to wait for the
+ * shard. If the process has exited, the call that was waiting delivers the events that the
+ * shard sent before it exited and throws, and the market must not be used afterwards.
+ */
+class ShardedMarket
+{
+public:
+    ShardedMarket(ShardedMarket &&other) = delete;
+    ShardedMarket &operator=(ShardedMarket &&other) = delete;
+
+    /**
+     * A constructor for the sharded market. Forks the shard processes, so it should be called
+     * before the process starts any other threads.
+     *
+     * @param event_handlers a vector of event handlers, require that the size of the vector
+     *                       is equal to the number of shards.
+     * @param num_shards the number of shard processes, require that num_shards is positive.
+     * @param ring_capacity the number of commands or events that each shared memory ring can
+     *                      hold, require that ring_capacity is a positive power of two.
+     * @throws std::system_error if the shared memory cannot be mapped or a shard cannot be forked.
+     */
+    explicit ShardedMarket(
+        std::vector<std::unique_ptr<EventHandler>> &event_handlers, uint8_t num_shards = 1, size_t ring_capacity = size_t{1} << 12);
+
+    /**
+     * Stops the shard processes. Events that have not been delivered are discarded.
+     */
+    ~ShardedMarket();
+
+    /**
+     * Adds a new symbol to the market.
+     *
+     * @param symbol_id the ID that the symbol is identified by, require that
+     *                  the symbol associated with symbol ID does not already exist.
+     * @param symbol_name the name of the symbol, require that it is no longer than
+     *                    max_command_symbol_name_length characters.
+     * @param max_orders the expected maximum number of orders resting in the orderbook.
+     * @param max_levels the expected maximum number of price levels in the orderbook.
+     */
+    void addSymbol(uint32_t symbol_id, const std::string &symbol_name, size_t max_orders = 0, size_t max_levels = 0);
+
+    /**
+     * Removes the symbol from the market.
+     *
+     * @param symbol_id the ID that the symbol is identified by, require that
+     *                  the symbol associated with symbol ID exists.
+     */
+    void deleteSymbol(uint32_t symbol_id);
+
+    /**
+     * Submits a new order to the market. Orders for symbols that do not exist are rejected.
+     *
+     * @param order the order to submit.
+     */
+    void addOrder(const Order &order);
+
+    /**
+     * Deletes an existing order from the market, require that the order exists.
+     *
+     * @param symbol_id the symbol ID associated with the order.
+     * @param order_id the ID associated with the order.
+     */
+    void deleteOrder(uint32_t symbol_id, uint64_t order_id);
+
+    /**
+     * Deletes all orders for a symbol from the market.
+     *
+     * @param symbol_id the symbol ID to delete orders for.
+     */
+    void deleteOrders(uint32_t symbol_id);
+
+    /**
+     * Cancels the provided quantity of an existing order in the market, require that the order exists.
+     *
+     * @param symbol_id the symbol ID associated with the order.
+     * @param order_id the ID associated with the order.
+     * @param cancelled_quantity the quantity of the order to cancel, require that cancelled_quantity is positive.
+     */
+    void cancelOrder(uint32_t symbol_id, uint64_t order_id, Quantity cancelled_quantity);
+
+    /**
+     * Replaces an existing order in the market, require that the order exists.
+     *
+     * @param symbol_id the symbol ID associated with the order.
+     * @param order_id the ID associated with the order.
+     * @param new_order_id the new ID to assign to the order.
+     * @param new_price the new price to assign to the order, require that price is positive.
+     */
+    void replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, Price new_price);
+
+    /**
+     * Amends the quantity and price of an existing order in the market, require that the order exists.
+     *
+     * @param symbol_id the symbol ID associated with the order.
+     * @param order_id the ID associated with the order.
+     * @param new_quantity the new open quantity of the order, require that new_quantity is positive.
+     * @param new_price the new price of the order.
+     */
+    void amendOrder(uint32_t symbol_id, uint64_t order_id, Quantity new_quantity, Price new_price);
+
+    /**
+     * Executes an existing order in the market.
+     *
+     * @param symbol_id the symbol ID associated with the order.
+     * @param order_id the ID associated with the order.
+     * @param quantity the quantity of the order to execute, require that quantity is positive.
+     * @param price the price at which the order is executed, require that price is positive.
+     */
+    void executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity, Price price);
+
+    /**
+     * Executes an existing order in the market.
+     *
+     * @param symbol_id the symbol ID associated with the order.
+     * @param order_id the ID associated with the order.
+     * @param quantity the quantity of the order to execute, require that quantity is positive.
+     */
+    void executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity);
+
+    /**
+     * Starts an auction for a symbol, require that the symbol exists.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void startAuction(uint32_t symbol_id);
+
+    /**
+     * Ends the auction for a symbol, require that the symbol exists.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void uncrossAuction(uint32_t symbol_id);
+
+    /**
+     * Halts trading in a symbol, require that the symbol exists.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void haltSymbol(uint32_t symbol_id);
+
+    /**
+     * Resumes trading in a symbol after a halt, require that the symbol exists.
+     *
+     * @param symbol_id the ID of the symbol.
+     */
+    void resumeSymbol(uint32_t symbol_id);
+
+    /**
+     * Sets the length of the bars that the trades of a symbol are aggregated into, require that
+     * the symbol exists. Bars are measured with the clock of the shard that owns the symbol.
+     *
+     * @param symbol_id the ID of the symbol.
+     * @param bar_interval the length of the bars in nanoseconds, or zero to stop sending bars for the symbol.
+     */
+    void setBarInterval(uint32_t symbol_id, uint64_t bar_interval);
+
+    /**
+     * Sends the bars of every orderbook in the market whose interval has ended.
+     */
+    void closeBars();
+
+    /**
+     * Delivers the events that the shards have sent so far without waiting.
+     */
+    void pollEvents();
+
+    /**
+     * Waits for every shard to process the commands that have been sent to it and delivers
+     * all of the events that they sent while doing so.
+     *
+     * @throws std::runtime_error if the process of a shard has exited.
+     */
+    void sync();
+
+    /**
+     * @param shard_index the index of a shard, require that shard_index is less than the number of shards.
+     * @return the ID of the process of the shard.
+     */
+    [[nodiscard]] pid_t shardProcess(uint32_t shard_index) const
+    {
+        return shards[shard_index].pid;
+    }
+
+private:
+    struct Shard
+    {
+        Shard(std::unique_ptr<EventHandler> event_handler_, size_t ring_capacity);
+
+        // The commands sent to the shard by the router.
+        std::unique_ptr<SharedMemoryRing<Command>> commands;
+        // The events sent to the router by the shard.
+        std::unique_ptr<SharedMemoryRing<ShardEvent>> events;
+        // Handles the events sent by the shard.
+        std::unique_ptr<EventHandler> event_handler;
+        // The ID of the shard process.
+        pid_t pid;
+        // True once the shard process has exited and been reaped.
+        bool exited;
+        // The status that the shard process exited with, as reported by waitpid.
+        int exit_status;
+    };
+
+    /**
+     * Runs a shard until it is told to stop. Only called in the shard process.
+     *
+     * @param shard the shard to run.
+     */
+    [[noreturn]] static void runShard(Shard &shard);
+
+    /**
+     * Checks whether the process of a shard is still running, and reaps it if it has exited.
+     *
+     * @param shard the shard to check.
+     * @return true if the process of the shard is running and false otherwise.
+     */
+    static bool isRunning(Shard &shard);
+
+    /**
+     * Reports that the process of a shard has exited.
+     *
+     * @param shard the shard whose process has exited.
+     * @throws std::runtime_error always.
+     */
+    [[noreturn]] static void reportExit(const Shard &shard);
+
+    /**
+     * Stamps a command with the next sequence number, unless it is a Sync command, and sends it
+     * to a shard, delivering the events of the shard while waiting for space.
+     *
+     * @param shard_index the index of the shard.
+     * @param command the command to send.
+     * @throws std::runtime_error if the process of the shard exits while waiting for space.
+     */
+    void submit(uint32_t shard_index, Command command);
+
+    /**
+     * Sends a command about a symbol to the shard that owns the symbol.
+     *
+     * @param command the command to send, require that the symbol of the command exists.
+     */
+    void submitSymbolCommand(const Command &command);
+
+    /**
+     * Delivers the events that a shard has sent so far without waiting.
+     *
+     * @param shard the shard to deliver the events of.
+     * @return true if the shard has acknowledged a sync and false otherwise.
+     * @throws std::runtime_error if the process of the shard exits in the middle of sending an event.
+     */
+    bool pollEvents(Shard &shard);
+
+    // The shards of the market.
+    std::vector<Shard> shards;
+    // Maps symbol IDs to symbols.
+    robin_hood::unordered_map<uint32_t, std::unique_ptr<Symbol>> id_to_symbol;
+    // Maps symbol IDs to the index of the shard that owns them.
+    robin_hood::unordered_map<uint32_t, uint32_t> id_to_shard;
+    // The index of the shard that will own the next symbol that is added.
+    uint32_t symbol_shard_index;
+    // The sequence number of the last command that was sent to a shard.
+    uint64_t sequence_number;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_SHARDED_MARKET_H
@@ -0,0 +1,115 @@
+#ifndef RAPID_TRADER_SYMBOL_ROUTING_TABLE_H
+#define RAPID_TRADER_SYMBOL_ROUTING_TABLE_H
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include "utils/robin_hood.h"
+
+namespace RapidTrader {
+/**
+ * Maps symbol IDs to the worker that owns them. Lookups never lock and may run
+ * concurrently with updates. Symbol IDs below a dense limit are stored in an array
+ * of lazily allocated chunks that is indexed by symbol ID, so that compact symbol
+ * IDs are found with two loads. Any other symbol IDs are stored in an immutable hash
+ * table that is copied and swapped in whenever it changes. Readers of the hash table
+ * announce themselves in one of two reader counts, and a table that has been swapped
+ * out is freed once both counts have drained, so only the current table is kept.
+ */
+class SymbolRoutingTable
+{
+public:
+    // The route of a symbol that is not in the table.
+    static constexpr uint32_t unknown_symbol = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * A constructor for the symbol routing table.
+     *
+     * @param dense_limit_ the symbol IDs below which symbols are stored in the dense array,
+     *                     require that dense_limit_ is a multiple of the chunk size.
+     */
+    explicit SymbolRoutingTable(uint32_t dense_limit_ = uint32_t{1} << 20);
+
+    SymbolRoutingTable(const SymbolRoutingTable &other) = delete;
+    SymbolRoutingTable &operator=(const SymbolRoutingTable &other) = delete;
+
+    ~SymbolRoutingTable();
+
+    /**
+     * Looks up the route of a symbol. May be called by any thread.
+     *
+     * @param symbol_id the ID of the symbol.
+     * @return the route of the symbol if it is in the table, otherwise unknown_symbol.
+     */
+    [[nodiscard]] uint32_t find(uint32_t symbol_id) const
+    {
+        if (symbol_id < dense_limit)
+        {
+            const Chunk *chunk = chunks[symbol_id >> chunk_bits].load(std::memory_order_acquire);
+            return chunk == nullptr ? unknown_symbol : (*chunk)[symbol_id & chunk_mask].load(std::memory_order_acquire);
+        }
+        std::atomic<uint64_t> &readers = reader_counts[reader_epoch.load(std::memory_order_acquire) & 1].count;
+        readers.fetch_add(1);
+        const SparseTable *table = sparse_table.load();
+        auto it = table->find(symbol_id);
+        uint32_t route = it == table->end() ? unknown_symbol : it->second;
+        readers.fetch_sub(1, std::memory_order_release);
+        return route;
+    }
+
+    /**
+     * Adds a symbol to the table. Updates must not be made by more than one thread at a time.
+     *
+     * @param symbol_id the ID of the symbol, require that the symbol is not in the table.
+     * @param route the route of the symbol, require that route is not unknown_symbol.
+     */
+    void insert(uint32_t symbol_id, uint32_t route);
+
+    /**
+     * Removes a symbol from the table. Updates must not be made by more than one thread at a time.
+     *
+     * @param symbol_id the ID of the symbol, require that the symbol is in the table.
+     */
+    void erase(uint32_t symbol_id);
+
+private:
+    static constexpr uint32_t chunk_bits = 12;
+    static constexpr uint32_t chunk_size = uint32_t{1} << chunk_bits;
+    static constexpr uint32_t chunk_mask = chunk_size - 1;
+    using Chunk = std::array<std::atomic<uint32_t>, chunk_size>;
+    using SparseTable = robin_hood::unordered_map<uint32_t, uint32_t>;
+
+    // The number of readers of the sparse table that announced themselves in an epoch of one parity.
+    struct alignas(64) ReaderCount
+    {
+        std::atomic<uint64_t> count{0};
+    };
+
+    /**
+     * Publishes a new version of the sparse table and frees the current version once no reader
+     * can be using it.
+     *
+     * @param table the new version of the sparse table.
+     */
+    void publish(std::unique_ptr<SparseTable> table);
+
+    /**
+     * Waits until every reader that may have loaded a sparse table before the last call to publish
+     * has finished. New readers are sent to the other reader count while a count drains, so the
+     * wait does not depend on readers going quiet.
+     */
+    void waitForReaders();
+
+    // The symbol IDs below which symbols are stored in the dense array.
+    uint32_t dense_limit;
+    // The chunks of the dense array, allocated when a symbol in their range is first added.
+    std::unique_ptr<std::atomic<Chunk *>[]> chunks;
+    // The current version of the sparse table, owned by the routing table.
+    std::atomic<const SparseTable *> sparse_table;
+    // The parity of the epoch selects the reader count that new readers of the sparse table join.
+    std::atomic<uint64_t> reader_epoch;
+    mutable std::array<ReaderCount, 2> reader_counts;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_SYMBOL_ROUTING_TABLE_H
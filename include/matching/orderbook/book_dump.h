@@ -0,0 +1,129 @@
+#ifndef RAPID_TRADER_BOOK_DUMP_H
+#define RAPID_TRADER_BOOK_DUMP_H
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "book_snapshot.h"
+
+namespace RapidTrader {
+/**
+ * The binary dump format, in the byte order of the machine that wrote it:
+ *
+ *   header: char magic[8] = "RTDUMP\0\0", uint32_t version, uint32_t reserved
+ *   book:   uint32_t symbol_id, uint32_t reserved, uint64_t last_traded_price,
+ *           uint64_t num_levels[6], followed by num_levels[k] records of
+ *           (uint64_t price, uint64_t volume) for each kind k of level
+ *
+ * The books follow the header until the end of the file. The kinds of level are written in
+ * the order bids, asks, stop bids, stop asks, trailing stop bids, trailing stop asks, and the
+ * levels of each kind are in ascending order of price, as in a book snapshot.
+ */
+constexpr char book_dump_magic[8] = {'R', 'T', 'D', 'U', 'M', 'P', '\0', '\0'};
+constexpr uint32_t book_dump_version = 1;
+
+/**
+ * Writes book snapshots to a binary dump. Each book is written as soon as it is passed to the
+ * writer, so a market can be dumped one book at a time without formatting anything.
+ */
+class BookDumpWriter
+{
+public:
+    /**
+     * A constructor for the book dump writer. Creates a new file and writes the header.
+     *
+     * @param name the name of the file to write to.
+     * @throws std::system_error if the file could not be created.
+     */
+    explicit BookDumpWriter(const std::string &name);
+
+    BookDumpWriter(const BookDumpWriter &other) = delete;
+    BookDumpWriter &operator=(const BookDumpWriter &other) = delete;
+
+    /**
+     * Flushes the buffered books and closes the file.
+     */
+    ~BookDumpWriter();
+
+    /**
+     * Writes a book to the dump.
+     *
+     * @param book the snapshot of the book to write.
+     */
+    void write(const BookSnapshot &book);
+
+    /**
+     * Writes the buffered books to the file.
+     *
+     * @throws std::system_error if the books could not be written.
+     */
+    void flush();
+
+private:
+    /**
+     * Appends a value to the buffer, flushing the buffer first if it is full.
+     *
+     * @param value the value to append.
+     */
+    void append(uint64_t value);
+    void append(uint32_t value);
+    void appendBytes(const void *bytes, size_t num_bytes);
+
+    // The file that the dump is written to.
+    std::FILE *file;
+    // The bytes that have not been written to the file yet.
+    std::vector<char> buffer;
+};
+
+/**
+ * Reads the book snapshots of a binary dump, one book at a time.
+ */
+class BookDumpReader
+{
+public:
+    /**
+     * A constructor for the book dump reader. Opens the file and checks the header.
+     *
+     * @param name the name of the file to read from.
+     * @throws std::system_error if the file could not be opened.
+     * @throws std::runtime_error if the file is not a dump or has an unsupported version.
+     */
+    explicit BookDumpReader(const std::string &name);
+
+    BookDumpReader(const BookDumpReader &other) = delete;
+    BookDumpReader &operator=(const BookDumpReader &other) = delete;
+
+    ~BookDumpReader();
+
+    /**
+     * Reads the next book of the dump.
+     *
+     * @param book the snapshot to read the book into.
+     * @return true if a book was read, false if the end of the dump was reached.
+     * @throws std::runtime_error if the dump ends in the middle of a book.
+     */
+    bool read(BookSnapshot &book);
+
+private:
+    /**
+     * Reads bytes from the file.
+     *
+     * @param bytes the buffer to read the bytes into.
+     * @param num_bytes the number of bytes to read.
+     * @return the number of bytes that were read, less than num_bytes only at the end of the file.
+     */
+    size_t readBytes(void *bytes, size_t num_bytes);
+
+    /**
+     * Reads a value from the file.
+     *
+     * @return the value that was read.
+     * @throws std::runtime_error if the file ends before the value.
+     */
+    uint64_t readUint64();
+    uint32_t readUint32();
+
+    // The file that the dump is read from.
+    std::FILE *file;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_BOOK_DUMP_H
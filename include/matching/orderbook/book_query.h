@@ -0,0 +1,65 @@
+#ifndef RAPID_TRADER_BOOK_QUERY_H
+#define RAPID_TRADER_BOOK_QUERY_H
+#include <vector>
+#include "book_snapshot.h"
+
+namespace RapidTrader {
+// The results of the queries that can be made against an orderbook. They are plain values that
+// are filled in on the thread that owns the book, so they can be handed to any other thread
+// without formatting the book.
+
+// The best price on each side of an orderbook and the volume displayed at it.
+struct BestBidOffer
+{
+    // The symbol ID associated with the book.
+    uint32_t symbol_id = 0;
+    // The highest bid price, zero if there are no bid limit orders.
+    Price bid_price = 0;
+    // The total visible quantity of the bid limit orders at the highest bid price, which leaves
+    // out the hidden quantity of iceberg orders.
+    Volume bid_volume = 0;
+    // The lowest ask price, zero if there are no ask limit orders.
+    Price ask_price = 0;
+    // The total visible quantity of the ask limit orders at the lowest ask price.
+    Volume ask_volume = 0;
+};
+
+// The best limit levels on each side of an orderbook.
+struct BookDepth
+{
+    // The symbol ID associated with the book.
+    uint32_t symbol_id = 0;
+    // The levels on each side, best price first, with their displayed volume.
+    std::vector<BookSnapshot::LevelSnapshot> bid_levels;
+    std::vector<BookSnapshot::LevelSnapshot> ask_levels;
+};
+
+// A summary of the state of an orderbook.
+struct SymbolStatistics
+{
+    // The symbol ID associated with the book.
+    uint32_t symbol_id = 0;
+    // The last traded price of the book, zero if no trades have occurred.
+    Price last_traded_price = 0;
+    // The number of orders resting in the book, including stop orders.
+    uint64_t num_orders = 0;
+    // The number of limit levels on each side of the book.
+    uint64_t num_bid_levels = 0;
+    uint64_t num_ask_levels = 0;
+    // True if trading in the book is halted.
+    bool halted = false;
+    // True if the book is accumulating orders for an auction.
+    bool in_auction = false;
+    // The number of trades and the total quantity traded since the book was created. A fill
+    // between two orders in the book is one trade.
+    uint64_t num_trades = 0;
+    Volume traded_volume = 0;
+    // The prices of the first, highest, and lowest trades, zero if no trades have occurred.
+    Price open_price = 0;
+    Price high_price = 0;
+    Price low_price = 0;
+    // The volume-weighted average price of the trades, zero if no trades have occurred.
+    double vwap = 0;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_BOOK_QUERY_H
@@ -0,0 +1,40 @@
+#ifndef RAPID_TRADER_BOOK_SNAPSHOT_H
+#define RAPID_TRADER_BOOK_SNAPSHOT_H
+#include <string>
+#include <vector>
+#include "types.h"
+
+namespace RapidTrader {
+/**
+ * A copy of the levels of an orderbook. Taking a snapshot only copies the price and
+ * volume of each level, so it is much cheaper than formatting the book - the snapshot
+ * can be taken on the thread that owns the book and formatted on any other thread.
+ */
+struct BookSnapshot
+{
+    struct LevelSnapshot
+    {
+        Price price;
+        // The displayed volume of the level, which leaves out the hidden quantity of iceberg orders.
+        Volume volume;
+    };
+
+    // The symbol ID associated with the book.
+    uint32_t symbol_id = 0;
+    // The last traded price of the book.
+    Price last_traded_price = 0;
+    // The levels of each kind in the book, in ascending order of price.
+    std::vector<LevelSnapshot> bid_levels;
+    std::vector<LevelSnapshot> ask_levels;
+    std::vector<LevelSnapshot> stop_bid_levels;
+    std::vector<LevelSnapshot> stop_ask_levels;
+    std::vector<LevelSnapshot> trailing_stop_bid_levels;
+    std::vector<LevelSnapshot> trailing_stop_ask_levels;
+
+    /**
+     * @return the string representation of the book that the snapshot was taken of.
+     */
+    [[nodiscard]] std::string toString() const;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_BOOK_SNAPSHOT_H
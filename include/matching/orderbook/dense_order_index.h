@@ -0,0 +1,389 @@
+#ifndef RAPID_TRADER_DENSE_ORDER_INDEX_H
+#define RAPID_TRADER_DENSE_ORDER_INDEX_H
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace RapidTrader {
+/**
+ * A direct-address table that maps order IDs to values. Intended for
+ * order IDs that are assigned sequentially - the table is split into
+ * fixed size pages that cover contiguous ranges of IDs, so a lookup is
+ * just an offset calculation and no hashing or rehashing is ever required.
+ * Pages are allocated as new ranges of IDs are used and are recycled once
+ * all of the IDs in their range have been erased.
+ *
+ * Each orderbook has its own table, so the IDs have to be dense within a
+ * single symbol rather than across the whole market. Order IDs that are
+ * assigned from one sequence per symbol, or from one global sequence that is
+ * split into a contiguous block of IDs per symbol, fill their pages. IDs from
+ * a single global sequence that are interleaved across many symbols leave
+ * each page of a book almost empty, so every live order can hold a page of
+ * its own - use the hash map in that case.
+ *
+ * Empty pages are kept for reuse up to the capacity that was reserved, plus
+ * one spare page so that a window of sequential IDs can move forward without
+ * allocating. Any other empty page is freed.
+ *
+ * The pages never span more than max_span_pages page numbers, so a single ID
+ * that is far away from the others does not allocate the gap between them.
+ * Such IDs are stored in a node based map instead.
+ *
+ * The interface mirrors the subset of the unordered map interface that is
+ * used by the orderbook. Iterators are pointers to the stored pairs and
+ * remain valid until the element is erased.
+ *
+ * @tparam T the type of the values stored in the table.
+ * @tparam PageBits log2 of the number of IDs covered by a single page.
+ */
+template<typename T, uint32_t PageBits = 12>
+class DenseOrderIndex
+{
+public:
+    using value_type = std::pair<const uint64_t, T>;
+    using iterator = value_type *;
+    using const_iterator = const value_type *;
+
+    static constexpr uint64_t page_size = uint64_t{1} << PageBits;
+    // The maximum number of consecutive page numbers that the pages cover.
+    static constexpr uint64_t max_span_pages = 4096;
+
+    DenseOrderIndex() = default;
+    DenseOrderIndex(const DenseOrderIndex &other) = delete;
+    DenseOrderIndex &operator=(const DenseOrderIndex &other) = delete;
+
+    ~DenseOrderIndex()
+    {
+        for (auto &page : pages)
+        {
+            if (page)
+                page->clear();
+        }
+    }
+
+    /**
+     * @param id an order ID.
+     * @return an iterator to the element with the provided ID if it exists, otherwise end().
+     */
+    iterator find(uint64_t id)
+    {
+        Page *page = getPage(id >> PageBits);
+        iterator it = page ? page->get(id & page_mask) : nullptr;
+        return it || far_elements.empty() ? it : findFar(id);
+    }
+
+    /**
+     * @param id an order ID.
+     * @return an iterator to the element with the provided ID if it exists, otherwise end().
+     */
+    const_iterator find(uint64_t id) const
+    {
+        const Page *page = getPage(id >> PageBits);
+        const_iterator it = page ? page->get(id & page_mask) : nullptr;
+        return it || far_elements.empty() ? it : findFar(id);
+    }
+
+    /**
+     * @return the iterator that is returned when an element is not found.
+     */
+    iterator end()
+    {
+        return nullptr;
+    }
+
+    /**
+     * @return the iterator that is returned when an element is not found.
+     */
+    const_iterator end() const
+    {
+        return nullptr;
+    }
+
+    /**
+     * Constructs a new element in place if there is no element with the provided ID.
+     *
+     * @param id the ID of the element.
+     * @param args the arguments that the value will be constructed from.
+     * @return a pair containing an iterator to the element with the provided ID and
+     *         true if the element was inserted or false if it already existed.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(uint64_t id, Args &&...args)
+    {
+        if (!far_elements.empty())
+        {
+            iterator existing = findFar(id);
+            if (existing)
+                return {existing, false};
+        }
+        if (!coverable(id >> PageBits))
+        {
+            auto far_it = far_elements.try_emplace(id, std::forward<Args>(args)...).first;
+            ++num_elements;
+            return {&*far_it, true};
+        }
+        Page &page = acquirePage(id >> PageBits);
+        uint64_t slot = id & page_mask;
+        iterator existing = page.get(slot);
+        if (existing)
+            return {existing, false};
+        ++num_elements;
+        return {page.emplace(slot, id, std::forward<Args>(args)...), true};
+    }
+
+    /**
+     * Erases an element from the table. Recycles the page that the element
+     * was stored in if the page no longer contains any elements.
+     *
+     * @param it an iterator to the element to erase, require that it is not end().
+     */
+    void erase(iterator it)
+    {
+        assert(it != nullptr && "Cannot erase end iterator!");
+        uint64_t id = it->first;
+        --num_elements;
+        Page *page = getPage(id >> PageBits);
+        if (!page || page->get(id & page_mask) != it)
+        {
+            far_elements.erase(id);
+            return;
+        }
+        page->erase(id & page_mask);
+        if (page->empty())
+            releasePage(pages[(id >> PageBits) - first_page]);
+    }
+
+    /**
+     * @return the number of elements in the table.
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return num_elements;
+    }
+
+    /**
+     * @return true if the table contains no elements and false otherwise.
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return num_elements == 0;
+    }
+
+    /**
+     * Allocates enough pages up front to hold the provided number of
+     * sequential IDs without allocating more pages.
+     *
+     * @param n the number of IDs to reserve space for.
+     */
+    void reserve(size_t n)
+    {
+        // A range of sequential IDs may straddle one more page than it would fill.
+        size_t pages_required = (n + page_size - 1) / page_size + 1;
+        reserved_pages = std::max(reserved_pages, pages_required);
+        size_t pages_allocated = numberOfPages() + free_pages.size();
+        for (; pages_allocated < pages_required; ++pages_allocated)
+        {
+            free_pages.push_back(std::make_unique<Page>());
+            ++allocated_pages;
+        }
+    }
+
+    /**
+     * @return the number of IDs that the allocated pages can cover.
+     */
+    [[nodiscard]] size_t capacity() const
+    {
+        return (numberOfPages() + free_pages.size()) * page_size;
+    }
+
+    /**
+     * @return the number of pages that the table has allocated since it was constructed,
+     *         including pages that have since been freed. Never decreases.
+     */
+    [[nodiscard]] size_t numberOfAllocatedPages() const
+    {
+        return allocated_pages;
+    }
+
+    /**
+     * @return the number of pages that are currently holding elements.
+     */
+    [[nodiscard]] size_t numberOfPages() const
+    {
+        return num_pages;
+    }
+
+private:
+    static constexpr uint64_t page_mask = page_size - 1;
+
+    struct Page
+    {
+        Page()
+        {
+            for (auto &word : occupied)
+                word = 0;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return live == 0;
+        }
+
+        [[nodiscard]] bool isOccupied(uint64_t slot) const
+        {
+            return (occupied[slot >> 6] >> (slot & 63)) & 1;
+        }
+
+        iterator get(uint64_t slot)
+        {
+            return isOccupied(slot) ? std::launder(reinterpret_cast<value_type *>(&slots[slot])) : nullptr;
+        }
+
+        const_iterator get(uint64_t slot) const
+        {
+            return isOccupied(slot) ? std::launder(reinterpret_cast<const value_type *>(&slots[slot])) : nullptr;
+        }
+
+        template<typename... Args>
+        iterator emplace(uint64_t slot, uint64_t id, Args &&...args)
+        {
+            auto *value = new (&slots[slot])
+                value_type(std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple(std::forward<Args>(args)...));
+            occupied[slot >> 6] |= uint64_t{1} << (slot & 63);
+            ++live;
+            return value;
+        }
+
+        void erase(uint64_t slot)
+        {
+            get(slot)->~value_type();
+            occupied[slot >> 6] &= ~(uint64_t{1} << (slot & 63));
+            --live;
+        }
+
+        void clear()
+        {
+            for (uint64_t slot = 0; slot < page_size && live > 0; ++slot)
+            {
+                if (isOccupied(slot))
+                    erase(slot);
+            }
+        }
+
+        std::aligned_storage_t<sizeof(value_type), alignof(value_type)> slots[page_size];
+        uint64_t occupied[page_size / 64 > 0 ? page_size / 64 : 1];
+        uint64_t live = 0;
+    };
+
+    Page *getPage(uint64_t page_number)
+    {
+        // Page numbers below the first page wrap around and fail the bounds check.
+        uint64_t offset = page_number - first_page;
+        return offset < pages.size() ? pages[offset].get() : nullptr;
+    }
+
+    const Page *getPage(uint64_t page_number) const
+    {
+        uint64_t offset = page_number - first_page;
+        return offset < pages.size() ? pages[offset].get() : nullptr;
+    }
+
+    iterator findFar(uint64_t id)
+    {
+        auto far_it = far_elements.find(id);
+        return far_it != far_elements.end() ? &*far_it : nullptr;
+    }
+
+    const_iterator findFar(uint64_t id) const
+    {
+        auto far_it = far_elements.find(id);
+        return far_it != far_elements.end() ? &*far_it : nullptr;
+    }
+
+    [[nodiscard]] bool coverable(uint64_t page_number) const
+    {
+        if (pages.empty())
+            return true;
+        uint64_t last_page = first_page + pages.size() - 1;
+        if (page_number < first_page)
+            return last_page - page_number < max_span_pages;
+        return page_number - first_page < max_span_pages;
+    }
+
+    Page &acquirePage(uint64_t page_number)
+    {
+        if (pages.empty())
+        {
+            first_page = page_number;
+            pages.emplace_back();
+        }
+        while (page_number < first_page)
+        {
+            pages.emplace_front();
+            --first_page;
+        }
+        while (page_number - first_page >= pages.size())
+            pages.emplace_back();
+        auto &page = pages[page_number - first_page];
+        if (!page)
+        {
+            if (free_pages.empty())
+            {
+                page = std::make_unique<Page>();
+                ++allocated_pages;
+            }
+            else
+            {
+                page = std::move(free_pages.back());
+                free_pages.pop_back();
+            }
+            ++num_pages;
+        }
+        return *page;
+    }
+
+    void releasePage(std::unique_ptr<Page> &page)
+    {
+        --num_pages;
+        if (free_pages.empty() || numberOfPages() + free_pages.size() < reserved_pages)
+            free_pages.push_back(std::move(page));
+        else
+            page.reset();
+        // Drop empty pages from either end so that the table only spans the live IDs.
+        while (!pages.empty() && !pages.front())
+        {
+            pages.pop_front();
+            ++first_page;
+        }
+        while (!pages.empty() && !pages.back())
+            pages.pop_back();
+    }
+
+    // Pages covering IDs from first_page * page_size onwards. Pages that do not
+    // contain any elements are null.
+    std::deque<std::unique_ptr<Page>> pages;
+    // Empty pages that can be reused without allocating.
+    std::vector<std::unique_ptr<Page>> free_pages;
+    // The number of pages that reserve has asked to keep allocated.
+    size_t reserved_pages = 0;
+    // Elements whose IDs are too far from the pages to be covered by them.
+    std::unordered_map<uint64_t, T> far_elements;
+    // The page number of the first page in pages.
+    uint64_t first_page = 0;
+    // The number of elements in the table.
+    size_t num_elements = 0;
+    // The number of pages that are holding elements, i.e. the non-null pages in pages.
+    size_t num_pages = 0;
+    // The number of pages that have been allocated since construction.
+    size_t allocated_pages = 0;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_DENSE_ORDER_INDEX_H
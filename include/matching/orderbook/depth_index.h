@@ -0,0 +1,133 @@
+#ifndef RAPID_TRADER_DEPTH_INDEX_H
+#define RAPID_TRADER_DEPTH_INDEX_H
+#include <map>
+#include <vector>
+#include "types.h"
+
+namespace RapidTrader {
+/**
+ * Tracks the volume resting at each price on one side of an orderbook and
+ * answers cumulative volume queries in logarithmic time. Prices within a
+ * window of the price ladder are stored in a Fenwick tree - the window grows
+ * to cover new prices up to a maximum size and any prices that fall outside
+ * of it are kept in an ordered map instead. Queries within the window never
+ * walk the map, and queries outside of it only walk the prices beyond the
+ * queried price. Once too many prices fall outside of the window, the window
+ * is re-centred on the price that is being added, so it follows the market
+ * as it moves.
+ */
+class DepthIndex
+{
+public:
+    /**
+     * A constructor for the depth index.
+     *
+     * @param max_window_ the maximum number of prices that the Fenwick tree may cover,
+     *                    require that max_window_ is a positive power of two.
+     */
+    explicit DepthIndex(size_t max_window_ = size_t{1} << 16);
+
+    /**
+     * Adds volume at a price.
+     *
+     * @param price the price to add volume at.
+     * @param volume the volume to add.
+     */
+    void add(Price price, Volume volume);
+
+    /**
+     * Removes volume at a price.
+     *
+     * @param price the price to remove volume at.
+     * @param volume the volume to remove, require that there is at least
+     *               that much volume at the price.
+     */
+    void remove(Price price, Volume volume);
+
+    /**
+     * @param price a price.
+     * @return the total volume at prices less than or equal to the provided price.
+     */
+    [[nodiscard]] Volume volumeAtOrBelow(Price price) const;
+
+    /**
+     * @param price a price.
+     * @return the total volume at prices greater than or equal to the provided price.
+     */
+    [[nodiscard]] Volume volumeAtOrAbove(Price price) const;
+
+    /**
+     * @return the total volume at all prices.
+     */
+    [[nodiscard]] Volume totalVolume() const
+    {
+        return total_volume;
+    }
+
+    /**
+     * @return the number of prices with volume that are outside of the window.
+     */
+    [[nodiscard]] size_t numberOfOutliers() const
+    {
+        return outliers.size();
+    }
+
+private:
+    /**
+     * @param price a price.
+     * @return true if the price is covered by the Fenwick tree and false otherwise.
+     */
+    [[nodiscard]] bool inWindow(Price price) const
+    {
+        return price >= base && price - base < volumes.size();
+    }
+
+    /**
+     * Grows the window so that it covers the provided price if that would not
+     * exceed the maximum window size.
+     *
+     * @param price the price to cover.
+     * @return true if the price is now covered by the window and false otherwise.
+     */
+    bool cover(Price price);
+
+    /**
+     * Moves a window of the maximum size so that it is centred on the provided price. The
+     * volumes that leave the window become outliers and the outliers that it now covers
+     * move into it.
+     *
+     * @param price the price to centre the window on.
+     */
+    void recentre(Price price);
+
+    /**
+     * Rebuilds the Fenwick tree from the volumes at each price in the window.
+     */
+    void rebuild();
+
+    /**
+     * @param index an index into the window.
+     * @return the total volume at the indices in the window up to and including index.
+     */
+    [[nodiscard]] Volume prefixSum(size_t index) const;
+
+    // The Fenwick tree over the window, one-based.
+    std::vector<Volume> tree;
+    // The volume at each price in the window.
+    std::vector<Volume> volumes;
+    // The volume at each price outside of the window.
+    std::map<Price, Volume> outliers;
+    // The volume of the outliers below the window.
+    Volume below_volume;
+    // The number of outliers that makes the window re-centre. It is at least twice the number of outliers
+    // left by the last re-centre, so the cost of moving the window is spread over the outliers added since.
+    size_t recentre_outliers;
+    // The lowest price covered by the window.
+    Price base;
+    // The total volume at all prices.
+    Volume total_volume;
+    // The maximum number of prices the window may cover.
+    size_t max_window;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_DEPTH_INDEX_H
@@ -1,6 +1,7 @@
 #ifndef RAPID_TRADER_LEVEL_H
 #define RAPID_TRADER_LEVEL_H
 #include "order.h"
+#include "depth_index.h"
 
 namespace RapidTrader {
 // Only validate level in debug mode.
@@ -30,8 +31,10 @@ public:
      * @param price_ the price associated with the level, require that price_ is positive.
      * @param side_ the side the level is on - either ask or bid.
      * @param symbol_id_ the symbol ID associated with the level.
+     * @param depth_ the depth index that changes in the volume of the level are
+     *               reported to, or nullptr if they should not be reported.
      */
-    Level(uint64_t price_, LevelSide side_, uint32_t symbol_id_);
+    Level(Price price_, LevelSide side_, uint32_t symbol_id_, DepthIndex *depth_ = nullptr);
 
     /**
      * @return the orders in the level.
@@ -46,7 +49,7 @@ public:
     /**
      * @return the price associated with the level.
      */
-    [[nodiscard]] uint64_t getPrice() const
+    [[nodiscard]] Price getPrice() const
     {
         return price;
     }
@@ -54,11 +57,19 @@ public:
     /**
      * @return the total volume of the level.
      */
-    [[nodiscard]] uint64_t getVolume() const
+    [[nodiscard]] Volume getVolume() const
     {
         return volume;
     }
 
+    /**
+     * @return the displayed volume of the level, which leaves out the hidden quantity of iceberg orders.
+     */
+    [[nodiscard]] Volume getDisplayedVolume() const
+    {
+        return displayed_volume;
+    }
+
     /**
      * @return the side of the level - bid or ask.
      */
@@ -148,11 +159,33 @@ public:
     void deleteOrder(const Order &order);
 
     /**
-     * Reduce the current volume of the level.
+     * Moves an order to the back of the level. The volume of the level is unchanged.
+     *
+     * @param order the order to move, require that the order is in the level.
+     */
+    void moveToBack(Order &order);
+
+    /**
+     * Removes all orders from the level.
+     */
+    void clear();
+
+    /**
+     * Reduce the current volume of the level after the open quantity of one of its orders was reduced.
      *
      * @param amount the amount to reduce the volume by, require that 0 < amount <= volume.
+     * @param displayed_amount the amount that the visible quantity of the order was reduced by,
+     *                         require that displayed_amount <= amount.
+     */
+    void reduceVolume(Quantity amount, Quantity displayed_amount);
+
+    /**
+     * Replenishes the visible quantity of an iceberg order in the level. The order keeps its
+     * place in the level.
+     *
+     * @param order the order to replenish, require that the order is in the level.
      */
-    void reduceVolume(uint64_t amount);
+    void replenishOrder(Order &order);
 
     /**
      * @return the string representation of the level.
@@ -168,18 +201,45 @@ private:
      * @throws Error if any of the following are true: an order
      *               is on a different side than the level, the sum
      *               of the open quantities of the orders in the level
-     *               does not equal the volume of the level, the level
+     *               does not equal the volume of the level, the sum of
+     *               their visible quantities does not equal the displayed
+     *               volume of the level, the level
      *               contains an order that is a market order,
      *               or the price / stop price of an order does not equal
      *               the price of the level.
      */
     void validateLevel() const;
 
+    /**
+     * Reports volume added to the level to the depth index, if any.
+     *
+     * @param amount the volume added to the level.
+     */
+    void depthAdded(Volume amount)
+    {
+        if (depth)
+            depth->add(price, amount);
+    }
+
+    /**
+     * Reports volume removed from the level to the depth index, if any.
+     *
+     * @param amount the volume removed from the level.
+     */
+    void depthRemoved(Volume amount)
+    {
+        if (depth && amount)
+            depth->remove(price, amount);
+    }
+
     list<Order> orders;
+    DepthIndex *depth;
     LevelSide side;
     uint32_t symbol_id;
-    uint64_t volume;
-    uint64_t price;
+    Volume volume;
+    // The sum of the visible quantities of the orders in the level.
+    Volume displayed_volume;
+    Price price;
 };
 } // namespace RapidTrader
 #endif // RAPID_TRADER_LEVEL_H
@@ -3,10 +3,16 @@
 #include <map>
 #include <limits>
 #include "robin_hood.h"
+#include "dense_order_index.h"
+#include "depth_index.h"
+#include "node_pool.h"
+#include "timer_wheel.h"
+#include "clock.h"
 #include "level.h"
 #include "orderbook.h"
 #include "order.h"
 #include "event_handler/event_handler.h"
+#include "market/risk_check.h"
 
 namespace RapidTrader {
 // Only validate orderbook in debug mode.
@@ -16,6 +22,9 @@ namespace RapidTrader {
 #    define VALIDATE_ORDERBOOK
 #endif
 
+// Price levels are allocated from a per-book node pool so that they can be reserved up front.
+using LevelMap = std::map<Price, Level, std::less<Price>, PoolAllocator<std::pair<const Price, Level>>>;
+
 struct OrderWrapper
 {
     Order order;
@@ -24,9 +33,21 @@ struct OrderWrapper
     // Be careful about iterator invalidation! For the STL map, this iterator
     // will remain valid as long as element that iterator corresponds to in
     // the map is deleted. Insertions and deletions do not invalidate the iterator.
-    std::map<uint64_t, Level>::iterator level_it;
+    LevelMap::iterator level_it;
 };
 
+// Order IDs are looked up through a hash map by default. Defining RAPID_TRADER_DENSE_ORDER_INDEX
+// (see ENABLE_DENSE_ORDER_INDEX in CMakeLists.txt) uses a paged direct-address table instead,
+// which is faster and never rehashes when the order IDs of each symbol are assigned sequentially.
+#ifdef RAPID_TRADER_DENSE_ORDER_INDEX
+using OrderIndex = DenseOrderIndex<OrderWrapper>;
+#else
+using OrderIndex = robin_hood::unordered_map<uint64_t, OrderWrapper>;
+#endif
+
+// The orders in the book that belong to a single owner.
+using OwnerOrders = list<Order, base_hook<OwnerHook>, constant_time_size<false>>;
+
 class MapOrderBook : public OrderBook
 {
 public:
@@ -35,8 +56,14 @@ public:
      *
      * @param symbol_id_ the symbol ID that will be associated with the book.
      * @param event_handler_ handles updates from the book.
+     * @param clock_ the clock that decides when GTD orders expire, require that the clock
+     *               outlives the book.
+     * @param max_orders the expected maximum number of orders resting in the book. Space
+     *                   for this many orders is reserved up front.
+     * @param max_levels the expected maximum number of price levels in the book. Space
+     *                   for this many levels is reserved up front.
      */
-    MapOrderBook(uint32_t symbol_id_, EventHandler &event_handler_);
+    MapOrderBook(uint32_t symbol_id_, EventHandler &event_handler_, const Clock &clock_, size_t max_orders = 0, size_t max_levels = 0);
 
     /**
      * @inheritdoc
@@ -46,12 +73,12 @@ public:
     /**
      * @inheritdoc
      */
-    void executeOrder(uint64_t order_id, uint64_t quantity, uint64_t price) override;
+    void executeOrder(uint64_t order_id, Quantity quantity, Price price) override;
 
     /**
      * @inheritdoc
      */
-    void executeOrder(uint64_t order_id, uint64_t quantity) override;
+    void executeOrder(uint64_t order_id, Quantity quantity) override;
 
     /**
      * @inheritdoc
@@ -61,12 +88,137 @@ public:
     /**
      * @inheritdoc
      */
-    void cancelOrder(uint64_t order_id, uint64_t quantity) override;
+    void deleteOrders() override;
+
+    /**
+     * @inheritdoc
+     */
+    void deleteOrders(OrderSide side) override;
+
+    /**
+     * @inheritdoc
+     */
+    void deleteOrders(OrderSide side, Price min_price, Price max_price) override;
+
+    /**
+     * @inheritdoc
+     */
+    void deleteOwnerOrders(uint32_t owner_id) override;
+
+    /**
+     * @inheritdoc
+     */
+    void expireOrders() override;
+
+    /**
+     * @inheritdoc
+     */
+    void deleteDayOrders() override;
+
+    /**
+     * @inheritdoc
+     */
+    void cancelOrder(uint64_t order_id, Quantity quantity) override;
+
+    /**
+     * @inheritdoc
+     */
+    void replaceOrder(uint64_t order_id, uint64_t new_order_id, Price new_price) override;
+
+    /**
+     * @inheritdoc
+     */
+    void amendOrder(uint64_t order_id, Quantity new_quantity, Price new_price) override;
+
+    /**
+     * @inheritdoc
+     */
+    void setSelfTradePrevention(SelfTradePrevention mode) override
+    {
+        self_trade_prevention = mode;
+    }
+
+    /**
+     * @inheritdoc
+     */
+    void setAllocationPolicy(AllocationPolicy policy) override
+    {
+        allocation_policy = policy;
+    }
+
+    /**
+     * @inheritdoc
+     */
+    void setRiskCheck(RiskCheck *risk_check_) override;
+
+    /**
+     * @inheritdoc
+     */
+    void startAuction() override
+    {
+        in_auction = true;
+    }
+
+    /**
+     * @inheritdoc
+     */
+    void halt() override
+    {
+        halted = true;
+    }
+
+    /**
+     * @inheritdoc
+     */
+    void resume() override
+    {
+        halted = false;
+    }
+
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] bool isHalted() const override
+    {
+        return halted;
+    }
+
+    /**
+     * @inheritdoc
+     */
+    void setPriceBand(uint32_t band_bps, Price reference_price) override
+    {
+        price_band_bps = band_bps;
+        price_band_reference = reference_price;
+    }
+
+    /**
+     * @inheritdoc
+     */
+    void uncrossAuction() override;
 
     /**
      * @inheritdoc
      */
-    void replaceOrder(uint64_t order_id, uint64_t new_order_id, uint64_t new_price) override;
+    void setBarInterval(uint64_t bar_interval_) override;
+
+    /**
+     * @inheritdoc
+     */
+    void closeBars() override;
+
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] bool inAuction() const override
+    {
+        return in_auction;
+    }
+
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] Price auctionPrice() const override;
 
     /**
      * @inheritdoc
@@ -103,7 +255,7 @@ public:
     /**
      * @inheritdoc
      */
-    [[nodiscard]] uint64_t bestBid() const override
+    [[nodiscard]] Price bestBid() const override
     {
         return bid_levels.empty() ? 0 : bid_levels.rbegin()->first;
     }
@@ -111,24 +263,68 @@ public:
     /**
      * @inheritdoc
      */
-    [[nodiscard]] uint64_t bestAsk() const override
+    [[nodiscard]] Price bestAsk() const override
     {
-        return ask_levels.empty() ? std::numeric_limits<uint64_t>::max() : ask_levels.begin()->first;
+        return ask_levels.empty() ? std::numeric_limits<Price>::max() : ask_levels.begin()->first;
     }
 
     /**
      * @inheritdoc
      */
-    [[nodiscard]] uint64_t lastTradedPrice() const override
+    [[nodiscard]] Price lastTradedPrice() const override
     {
         return last_traded_price;
     }
 
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] Volume bidVolumeAtOrAbove(Price price) const override
+    {
+        return bid_depth.volumeAtOrAbove(price);
+    }
+
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] Volume askVolumeAtOrBelow(Price price) const override
+    {
+        return ask_depth.volumeAtOrBelow(price);
+    }
+
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] uint64_t numberOfGrowthEvents() const override
+    {
+        return growth_events;
+    }
+
     /**
      * @inheritdoc
      */
     void dumpBook(const std::string &path) const override;
 
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] BookSnapshot snapshot() const override;
+
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] BestBidOffer bestBidOffer() const override;
+
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] BookDepth depth(size_t max_levels) const override;
+
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] SymbolStatistics statistics() const override;
+
     /**
      * @inheritdoc
      */
@@ -148,6 +344,74 @@ private:
      */
     void deleteOrder(uint64_t order_id, bool notification);
 
+    /**
+     * Deletes every order in a range of levels and erases the levels. Does not send
+     * any notifications.
+     *
+     * @param levels the levels to delete orders from.
+     * @param first an iterator to the first level to delete.
+     * @param last an iterator past the last level to delete.
+     * @param deleted_orders the vector that the deleted orders are appended to.
+     */
+    void deleteLevels(LevelMap &levels, LevelMap::iterator first, LevelMap::iterator last, std::vector<Order> &deleted_orders);
+
+    /**
+     * Deletes every order in a list of orders from the book and sends a single
+     * notification for all of them.
+     *
+     * @param expiring the orders to delete, require that every order in the list
+     *                 is in the book. The list is left empty.
+     */
+    void deleteExpiryList(ExpiryList &expiring);
+
+    /**
+     * Checks whether an order may enter the book, first against the halt and price band of the
+     * book and then against the risk stage, if any. Takes constant time.
+     *
+     * @param order the order.
+     * @param replaced_quantity the open quantity of the resting order that the order replaces or
+     *                          amends, or zero for a new order.
+     * @param reason set to the reason the order is rejected, if it is.
+     * @return true if the order should be rejected and false otherwise.
+     */
+    [[nodiscard]] bool rejectOrder(const Order &order, Quantity replaced_quantity, RejectReason &reason);
+
+    /**
+     * Submits an order that has passed the checks of the book.
+     *
+     * @param order the order to submit, require that the order does not already exist in the book.
+     */
+    void acceptOrder(Order &order);
+
+    /**
+     * Deletes the GTD orders that have expired by the provided time.
+     *
+     * @param now the current time in nanoseconds since the epoch.
+     */
+    void deleteExpiredOrders(uint64_t now);
+
+    /**
+     * @param order an order that is resting in the book.
+     * @return the levels that the provided order rests in.
+     */
+    LevelMap &getLevels(const Order &order);
+
+    /**
+     * @param order an order that is resting in the book.
+     * @return the depth index that tracks the level the provided order rests in,
+     *         or nullptr if the order is not a limit order.
+     */
+    DepthIndex *getDepth(const Order &order);
+
+    /**
+     * Removes the order wrapped by the provided wrapper from its level and
+     * erases the level if it is left empty. The order remains in the order index.
+     *
+     * @param wrapper the wrapper of the order to remove, require that the order
+     *                is in a level.
+     */
+    void removeFromLevel(OrderWrapper &wrapper);
+
     /**
      * Submits a limit order to the book.
      *
@@ -163,6 +427,21 @@ private:
      */
     void insertLimitOrder(const Order &order);
 
+    /**
+     * Inserts an order into the order index and the provided level.
+     *
+     * @param order the order to insert, require that the order does not
+     *              already exist in the book.
+     * @param level_it an iterator to the level to insert the order into.
+     */
+    void insertOrder(const Order &order, LevelMap::iterator level_it);
+
+    /**
+     * Records a growth event if the order index or the level pool has
+     * allocated storage since the last check. Warns if the book was given a capacity hint.
+     */
+    void checkGrowth();
+
     /**
      * Submits a market order to the book.
      *
@@ -199,7 +478,7 @@ private:
      *              order is a trailing stop ir trailing stop limit order.
      * @return the new stop price of the order.
      */
-    uint64_t calculateStopPrice(Order &order);
+    Price calculateStopPrice(Order &order);
 
     /**
      * Updates the restart price of trailing stop orders on the bid side.
@@ -217,6 +496,27 @@ private:
      */
     void activateStopOrders();
 
+    /**
+     * Indicates whether the last traded price has crossed the nearest trigger price
+     * on either side of the book or has moved such that trailing stop orders need
+     * to be updated. Checks only the ends of the stop level maps.
+     *
+     * @return true if any stop orders may need to be activated or updated and false otherwise.
+     */
+    [[nodiscard]] bool stopOrdersTriggered() const;
+
+    /**
+     * @return the lowest stop price of the stop and trailing stop orders on the bid side
+     *         if there are any, otherwise the max price value.
+     */
+    [[nodiscard]] Price nearestBidTrigger() const;
+
+    /**
+     * @return the highest stop price of the stop and trailing stop orders on the ask side
+     *         if there are any, otherwise zero.
+     */
+    [[nodiscard]] Price nearestAskTrigger() const;
+
     /**
      * Attempts to activate stop, stop limit, trailing restart, and trailing stop limit
      * orders on the bid side.
@@ -245,12 +545,47 @@ private:
 
     /**
      * Matches all crossed orders in the book. Orders that are filled
-     * are removed from the book.
+     * are removed from the book. Does nothing while the book is in an auction.
      *
      * @param order the order to match.
      */
     void match(Order &order);
 
+    /**
+     * Matches an order against the book, allocating the quantity matched at each level
+     * pro-rata between the orders resting in the level.
+     *
+     * @tparam TopOrderPriority true if the order at the front of a level is filled before
+     *                          the rest of the level is allocated and false otherwise.
+     * @param order the order to match.
+     * @param owner_id the owner of the order if self-trade prevention is enabled, otherwise zero.
+     */
+    template<bool TopOrderPriority>
+    void matchProRata(Order &order, uint32_t owner_id);
+
+    /**
+     * Allocates as much of the open quantity of an order as possible pro-rata between
+     * the orders resting in a level, executes the allocations, and removes any filled
+     * orders from the book.
+     *
+     * @param order the order to match, require that it crosses the level.
+     * @param level the level to match against, require that it contains no orders with
+     *              the same owner as order if self-trade prevention is enabled.
+     */
+    void allocateLevel(Order &order, Level &level);
+
+    /**
+     * Executes an incoming order against a resting order at the price of the resting order.
+     *
+     * @param incoming the order being matched.
+     * @param resting the order resting in the book.
+     * @param level the level that the resting order is in.
+     * @param matched_quantity the quantity to execute, require that matched_quantity is positive and
+     *                         does not exceed the open quantity of incoming or the displayed quantity
+     *                         of resting.
+     */
+    void executeResting(Order &incoming, Order &resting, Level &level, Quantity matched_quantity);
+
     /**
      * Indicates whether an order is able to completely filled
      * or not.
@@ -262,28 +597,112 @@ private:
     [[nodiscard]] bool canMatchOrder(const Order &order) const;
 
     /**
-     * Matches two orders.
+     * Indicates whether an order is able to be completely filled without trading with
+     * the resting orders of its owner. Walks the levels that the order would match
+     * against, so it is only used when the owner has orders resting in the book.
+     *
+     * @param order an order.
+     * @param owner_id the owner ID of the order, require that it is positive.
+     * @return true if the order can be completely filled and false otherwise.
+     */
+    [[nodiscard]] bool canMatchOrderWithoutSelfTrade(const Order &order, uint32_t owner_id) const;
+
+    /**
+     * Matches two orders and sends a single trade event for the fill.
      *
-     * @param ask an ask order to execute.
-     * @param bid a bid order to execute.
+     * @param aggressor the incoming order to execute.
+     * @param passive the resting order to execute, require that it is on the other side of aggressor.
      * @param executing_price price at which orders are executed, require that
      *                        ask price <= executing_price <= bid price.
+     * @param matched_quantity the quantity to execute, require that matched_quantity is positive
+     *                         and does not exceed the open quantity of either order.
+     */
+    void executeOrders(Order &aggressor, Order &passive, Price executing_price, Quantity matched_quantity);
+
+    /**
+     * Adds a trade to the trading statistics and the open bar of the book, sending the open
+     * bar first if its interval has ended.
+     *
+     * @param price the price of the trade.
+     * @param quantity the quantity of the trade.
+     */
+    void recordTrade(Price price, Quantity quantity);
+
+    /**
+     * Sends the open bar and leaves no bar open, require that a bar is open.
+     */
+    void sendBar();
+
+    /**
+     * Tells the risk stage of the book, if any, that an order was executed.
+     *
+     * @param order the order that was executed.
+     */
+    void reportExecution(const Order &order)
+    {
+        if (risk_check)
+            risk_check->orderExecuted(order);
+    }
+
+    /**
+     * Tells the risk stage of the book, if any, that open quantity of an order left the book
+     * without being executed.
+     *
+     * @param order the order.
+     * @param quantity the open quantity that left the book.
+     */
+    void reportRelease(const Order &order, Quantity quantity)
+    {
+        if (risk_check && quantity != 0)
+            risk_check->orderReleased(order, quantity);
+    }
+
+    /**
+     * Replenishes the displayed quantity of an iceberg order whose displayed quantity has
+     * been executed and moves the order to the back of its level. The order keeps its place
+     * in the order index.
+     *
+     * @param order the iceberg order to replenish, require that the order is resting in level
+     *              and is not filled.
+     * @param level the level that the order is resting in.
+     */
+    void replenishOrder(Order &order, Level &level);
+
+    /**
+     * Prevents an incoming order from trading with a resting order that has the same
+     * owner according to the self-trade prevention mode of the book.
+     *
+     * @param incoming the order being matched.
+     * @param resting an order in the level being matched against, require that resting
+     *                has the same owner as incoming.
+     * @param resting_level the level that the resting order is in.
+     */
+    void preventSelfTrade(Order &incoming, Order &resting, Level &resting_level);
+
+    /**
+     * Applies self-trade prevention to every order in a level that has the same owner as an
+     * incoming order, stopping early if the incoming order has no open quantity left.
+     *
+     * @param incoming the order being matched.
+     * @param level the level being matched against.
+     * @param owner_id the owner of the incoming order, require that owner_id is positive.
+     * @return true if the level contained any orders with the same owner and false otherwise.
      */
-    void executeOrders(Order &ask, Order &bid, uint64_t executing_price);
+    bool preventSelfTrades(Order &incoming, Level &level, uint32_t owner_id);
 
     /**
      * @returns the last traded price if any trades have been made and the max
-     *          64-bit unsigned integer value otherwise.
+     *          price value otherwise.
      */
-    [[nodiscard]] uint64_t lastTradedPriceAsk() const
+    [[nodiscard]] Price lastTradedPriceAsk() const
     {
-        return last_traded_price == 0 ? std::numeric_limits<uint64_t>::max() : last_traded_price;
+        return last_traded_price == 0 ? std::numeric_limits<Price>::max() : last_traded_price;
     }
 
     /**
      * @returns the last traded price if any trades have been made and zero otherwise.
      */
-    [[nodiscard]] uint64_t lastTradedPriceBid() const
+    [[nodiscard]] Price lastTradedPriceBid() const
     {
         return last_traded_price;
     }
@@ -336,6 +755,8 @@ private:
      */
     void validateTrailingStopOrders() const;
 
+    // Allocates the nodes of the level maps. Must outlive the level maps.
+    NodePool level_pool;
     // IMPORTANT: Note that the declaration of orders MUST be
     // declared before the declaration of the price level vectors.
     // Class members are destroyed in the reverse order of their declaration,
@@ -343,24 +764,74 @@ private:
     // required for the intrusive list.
 
     // Maps order IDs to order wrappers.
-    robin_hood::unordered_map<uint64_t, OrderWrapper> orders;
+    OrderIndex orders;
+    // Maps owner IDs to the orders that belong to them. Must be declared after orders.
+    robin_hood::unordered_node_map<uint32_t, OwnerOrders> owner_orders;
+    // Schedules the expiry of the GTD orders in the book. Must be declared after orders.
+    TimerWheel expiry_wheel;
+    // The DAY orders in the book. Must be declared after orders.
+    ExpiryList day_orders;
     // Maps prices to limit levels.
-    std::map<uint64_t, Level> ask_levels;
-    std::map<uint64_t, Level> bid_levels;
+    LevelMap ask_levels;
+    LevelMap bid_levels;
     // Maps prices to stop levels.
-    std::map<uint64_t, Level> stop_ask_levels;
-    std::map<uint64_t, Level> stop_bid_levels;
+    LevelMap stop_ask_levels;
+    LevelMap stop_bid_levels;
     // Maps prices to trailing stop levels.
-    std::map<uint64_t, Level> trailing_stop_ask_levels;
-    std::map<uint64_t, Level> trailing_stop_bid_levels;
+    LevelMap trailing_stop_ask_levels;
+    LevelMap trailing_stop_bid_levels;
+    // Tracks the cumulative volume of the limit levels on each side.
+    DepthIndex ask_depth;
+    DepthIndex bid_depth;
     // Handles any trade events.
     EventHandler &event_handler;
+    // Decides when GTD orders expire.
+    const Clock &clock;
+    // Told about every execution in the book, nullptr if there is no risk stage.
+    RiskCheck *risk_check;
     // The current price of the symbol - based off the price that the
     // symbol was last traded at. Initially zero.
-    uint64_t last_traded_price;
+    Price last_traded_price;
     // Tracks increases and decreases in market price.
-    uint64_t trailing_bid_price;
-    uint64_t trailing_ask_price;
+    Price trailing_bid_price;
+    Price trailing_ask_price;
+    // The storage allocated by the order index and level pool at the last growth check.
+    size_t index_allocations;
+    size_t pool_allocations;
+    // The number of times the order index or level pool has grown after construction.
+    uint64_t growth_events;
+    // True if the book was constructed with a capacity hint.
+    bool capacity_hinted;
+    // How orders with the same owner are prevented from trading with each other.
+    SelfTradePrevention self_trade_prevention;
+    // How the quantity matched at a level is shared between the orders in the level.
+    AllocationPolicy allocation_policy;
+    // Scratch space for pro-rata allocation, reused between levels so that matching does
+    // not allocate. The displayed quantity of each resting order and its allocation are
+    // kept in contiguous arrays so that the allocation is a single pass over them.
+    std::vector<Order *> allocation_orders;
+    std::vector<Quantity> allocation_quantities;
+    std::vector<Quantity> allocations;
+    // True if the book is accumulating orders for an auction instead of matching them.
+    bool in_auction;
+    // True if trading in the book is halted.
+    bool halted;
+    // The width of the price band in basis points of the reference price, zero if there is no band.
+    uint32_t price_band_bps;
+    // The price that the band is centered on, zero if the band follows the last traded price.
+    Price price_band_reference;
+    // The number of trades, the total quantity and notional value traded, and the prices of the
+    // first, highest, and lowest trades since the book was created.
+    uint64_t num_trades;
+    Volume traded_volume;
+    double traded_notional;
+    Price open_price;
+    Price high_price;
+    Price low_price;
+    // The length of the bars in nanoseconds, zero if bars are not sent.
+    uint64_t bar_interval;
+    // The bar that trades are added to, open only if it has trades.
+    TradeBar open_bar;
     // The symbol ID associated with the book.
     uint32_t symbol_id;
 };
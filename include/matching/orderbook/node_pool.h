@@ -0,0 +1,173 @@
+#ifndef RAPID_TRADER_NODE_POOL_H
+#define RAPID_TRADER_NODE_POOL_H
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace RapidTrader {
+/**
+ * A pool of fixed size memory blocks. Blocks are carved out of large
+ * chunks and recycled through a free list, so allocating and deallocating
+ * a block is constant time and does not touch the system allocator unless
+ * the pool has to grow.
+ */
+class NodePool
+{
+public:
+    /**
+     * A constructor for the node pool.
+     *
+     * @param block_size_ the size of the blocks in bytes, require that block_size_ is positive.
+     */
+    explicit NodePool(size_t block_size_);
+
+    NodePool(const NodePool &other) = delete;
+    NodePool &operator=(const NodePool &other) = delete;
+
+    /**
+     * @return a block of memory with at least block size bytes.
+     */
+    void *allocate()
+    {
+        if (!free_list)
+            grow(std::max<size_t>(capacity, 16));
+        FreeBlock *block = free_list;
+        free_list = block->next;
+        return block;
+    }
+
+    /**
+     * Returns a block to the pool.
+     *
+     * @param block a block that was allocated by the pool.
+     */
+    void deallocate(void *block)
+    {
+        auto *free_block = static_cast<FreeBlock *>(block);
+        free_block->next = free_list;
+        free_list = free_block;
+    }
+
+    /**
+     * Ensures that the pool can hold at least the provided number of blocks without growing.
+     *
+     * @param num_blocks the number of blocks to reserve.
+     */
+    void reserve(size_t num_blocks)
+    {
+        if (num_blocks > capacity)
+            grow(num_blocks - capacity);
+    }
+
+    /**
+     * @param size the size of an object in bytes.
+     * @param alignment the alignment of an object in bytes.
+     * @return true if the object can be stored in a block and false otherwise.
+     */
+    [[nodiscard]] bool fits(size_t size, size_t alignment) const
+    {
+        return size <= block_size && alignment <= alignof(std::max_align_t);
+    }
+
+    /**
+     * @return the total number of blocks that the pool holds.
+     */
+    [[nodiscard]] size_t getCapacity() const
+    {
+        return capacity;
+    }
+
+    /**
+     * @return the number of blocks that the pool has allocated since it was constructed. Never decreases.
+     */
+    [[nodiscard]] size_t getAllocatedBlocks() const
+    {
+        return allocated_blocks;
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    /**
+     * Allocates a new chunk and adds its blocks to the free list.
+     *
+     * @param num_blocks the number of blocks in the new chunk.
+     */
+    void grow(size_t num_blocks);
+
+    // The chunks of memory that blocks are carved from.
+    std::vector<std::unique_ptr<std::byte[]>> chunks;
+    // The blocks that are available for allocation.
+    FreeBlock *free_list;
+    // The size of each block - rounded up to preserve alignment.
+    size_t block_size;
+    // The total number of blocks in all chunks.
+    size_t capacity;
+    // The number of blocks that have been allocated since construction.
+    size_t allocated_blocks;
+};
+
+/**
+ * An allocator for node based containers that allocates single nodes from
+ * a NodePool. Any other allocation falls back to the global allocator.
+ *
+ * @tparam T the type of the objects to allocate.
+ */
+template<typename T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit PoolAllocator(NodePool *pool_)
+        : pool(pool_)
+    {}
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U> &other) // NOLINT(google-explicit-constructor)
+        : pool(other.pool)
+    {}
+
+    T *allocate(size_t n)
+    {
+        if (n == 1 && pool->fits(sizeof(T), alignof(T)))
+            return static_cast<T *>(pool->allocate());
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t n)
+    {
+        if (n == 1 && pool->fits(sizeof(T), alignof(T)))
+            pool->deallocate(p);
+        else
+            ::operator delete(p);
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U> &other) const
+    {
+        return pool == other.pool;
+    }
+
+    template<typename U>
+    bool operator!=(const PoolAllocator<U> &other) const
+    {
+        return pool != other.pool;
+    }
+
+    template<typename U>
+    friend class PoolAllocator;
+
+private:
+    NodePool *pool;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_NODE_POOL_H
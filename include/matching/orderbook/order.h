@@ -1,6 +1,7 @@
 #ifndef RAPID_TRADER_ORDER_H
 #define RAPID_TRADER_ORDER_H
 #include <boost/intrusive/list.hpp>
+#include "types.h"
 
 namespace RapidTrader {
 // Only validate order in debug mode.
@@ -48,7 +49,7 @@ class Level;
  * Instead, the stop price is defined as a specific dollar amount (the trail
  * amount) below or above the market price of the security (the trailing stop price).
  */
-enum class OrderType
+enum class OrderType : uint8_t
 {
     Limit = 0,
     Market = 1,
@@ -70,12 +71,22 @@ enum class OrderType
  * IOC (Immediate Or Cancel): an order with time in force IOC will
  * be executed immediately. Any portion of the IOC order that cannot
  * be filled will be cancelled.
+ *
+ * GTD (Good Till Date): an order with time in force GTD will remain
+ * active until the order is completed, cancelled, or its expiry time
+ * is reached.
+ *
+ * DAY: an order with time in force DAY will remain active until the
+ * order is completed, cancelled, or the day orders of the trading
+ * session are deleted.
  */
-enum class OrderTimeInForce
+enum class OrderTimeInForce : uint8_t
 {
     GTC = 0,
     FOK = 1,
     IOC = 2,
+    GTD = 3,
+    DAY = 4
 };
 
 /**
@@ -84,13 +95,25 @@ enum class OrderTimeInForce
  * Bid: An order on the bid side is an order to buy a security.
  * Ask: An order on the ask side is an order to sell a security.
  */
-enum class OrderSide
+enum class OrderSide : uint8_t
 {
     Bid = 0,
     Ask = 1
 };
 
-struct Order : public list_base_hook<>
+// Tag for the hook that links an order into the list of orders of its owner. The hook
+// unlinks itself when the order is destroyed, so orders never have to be removed from
+// their owner list explicitly.
+struct OwnerTag;
+using OwnerHook = list_base_hook<tag<OwnerTag>, link_mode<auto_unlink>>;
+
+// Tag for the hook that links a GTD order into the timer wheel of its book or a DAY
+// order into the list of day orders of its book. Like the owner hook, it unlinks itself
+// when the order is destroyed.
+struct ExpiryTag;
+using ExpiryHook = list_base_hook<tag<ExpiryTag>, link_mode<auto_unlink>>;
+
+struct Order : public list_base_hook<>, public OwnerHook, public ExpiryHook
 {
 public:
     /**
@@ -101,9 +124,11 @@ public:
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order, require that time_in_force is either
      *                      FOK or IOC.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new market order.
      */
-    static Order marketAskOrder(uint64_t order_id, uint32_t symbol_id, uint64_t quantity, OrderTimeInForce time_in_force);
+    static Order marketAskOrder(
+        uint64_t order_id, uint32_t symbol_id, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * Creates a market order on the bid side.
@@ -113,9 +138,11 @@ public:
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order, require that time_in_force is either
      *                      FOK or IOC.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new market order.
      */
-    static Order marketBidOrder(uint64_t order_id, uint32_t symbol_id, uint64_t quantity, OrderTimeInForce time_in_force);
+    static Order marketBidOrder(
+        uint64_t order_id, uint32_t symbol_id, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * Creates a new limit order on the ask side.
@@ -125,9 +152,11 @@ public:
      * @param price the price of the order, require that price is positive.
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new limit order.
      */
-    static Order limitAskOrder(uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t quantity, OrderTimeInForce time_in_force);
+    static Order limitAskOrder(
+        uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * Creates a new limit order on the bid side.
@@ -137,9 +166,79 @@ public:
      * @param price the price of the order, require that price is positive.
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new limit order.
      */
-    static Order limitBidOrder(uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t quantity, OrderTimeInForce time_in_force);
+    static Order limitBidOrder(
+        uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id = 0);
+
+    /**
+     * Creates a new GTD limit order on the ask side.
+     *
+     * @param order_id the ID of the order, require that order_id is positive.
+     * @param symbol_id the symbol ID of the order, require that symbol_id is positive.
+     * @param price the price of the order, require that price is positive.
+     * @param quantity the quantity of the order, require that quantity is positive.
+     * @param expiry_time the time at which the order expires in nanoseconds since the epoch,
+     *                    require that expiry_time is positive.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
+     * @return a new GTD limit order.
+     */
+    static Order gtdAskOrder(uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, uint64_t expiry_time,
+        uint32_t owner_id = 0);
+
+    /**
+     * Creates a new GTD limit order on the bid side.
+     *
+     * @param order_id the ID of the order, require that order_id is positive.
+     * @param symbol_id the symbol ID of the order, require that symbol_id is positive.
+     * @param price the price of the order, require that price is positive.
+     * @param quantity the quantity of the order, require that quantity is positive.
+     * @param expiry_time the time at which the order expires in nanoseconds since the epoch,
+     *                    require that expiry_time is positive.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
+     * @return a new GTD limit order.
+     */
+    static Order gtdBidOrder(uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, uint64_t expiry_time,
+        uint32_t owner_id = 0);
+
+    /**
+     * Creates a new iceberg order on the ask side. An iceberg order is a limit order that
+     * only displays part of its quantity at a time. Once the displayed quantity of a resting
+     * iceberg order is executed, it is replenished from the hidden quantity and the order
+     * moves to the back of its level.
+     *
+     * @param order_id the ID of the order, require that order_id is positive.
+     * @param symbol_id the symbol ID of the order, require that symbol_id is positive.
+     * @param price the price of the order, require that price is positive.
+     * @param quantity the total quantity of the order, require that quantity is positive.
+     * @param display_quantity the quantity of the order that is displayed at a time, require that
+     *                         display_quantity is positive and does not exceed quantity.
+     * @param time_in_force the time in force of the order.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
+     * @return a new iceberg order.
+     */
+    static Order icebergAskOrder(uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, Quantity display_quantity,
+        OrderTimeInForce time_in_force, uint32_t owner_id = 0);
+
+    /**
+     * Creates a new iceberg order on the bid side. An iceberg order is a limit order that
+     * only displays part of its quantity at a time. Once the displayed quantity of a resting
+     * iceberg order is executed, it is replenished from the hidden quantity and the order
+     * moves to the back of its level.
+     *
+     * @param order_id the ID of the order, require that order_id is positive.
+     * @param symbol_id the symbol ID of the order, require that symbol_id is positive.
+     * @param price the price of the order, require that price is positive.
+     * @param quantity the total quantity of the order, require that quantity is positive.
+     * @param display_quantity the quantity of the order that is displayed at a time, require that
+     *                         display_quantity is positive and does not exceed quantity.
+     * @param time_in_force the time in force of the order.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
+     * @return a new iceberg order.
+     */
+    static Order icebergBidOrder(uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, Quantity display_quantity,
+        OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * Creates a new stop market order on the ask side.
@@ -150,10 +249,11 @@ public:
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order, require that time_in_force is either
      *                      FOK or IOC.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new stop market order.
      */
     static Order stopAskOrder(
-        uint64_t order_id, uint32_t symbol_id, uint64_t stop_price, uint64_t quantity, OrderTimeInForce time_in_force);
+        uint64_t order_id, uint32_t symbol_id, Price stop_price, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * Creates a new stop market order on the bid side.
@@ -164,10 +264,11 @@ public:
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order, require that time_in_force is either
      *                      FOK or IOC.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new stop market order.
      */
     static Order stopBidOrder(
-        uint64_t order_id, uint32_t symbol_id, uint64_t stop_price, uint64_t quantity, OrderTimeInForce time_in_force);
+        uint64_t order_id, uint32_t symbol_id, Price stop_price, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * Creates a new stop limit order on the ask side.
@@ -178,10 +279,11 @@ public:
      * @param stop_price the stop price of the order, require that stop_price is positive.
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new stop limit order.
      */
-    static Order stopLimitAskOrder(
-        uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t stop_price, uint64_t quantity, OrderTimeInForce time_in_force);
+    static Order stopLimitAskOrder(uint64_t order_id, uint32_t symbol_id, Price price, Price stop_price, Quantity quantity,
+        OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * Creates a new stop limit order on the bid side.
@@ -192,10 +294,11 @@ public:
      * @param stop_price the stop price of the order, require that stop_price is positive.
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new stop limit order.
      */
-    static Order stopLimitBidOrder(
-        uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t stop_price, uint64_t quantity, OrderTimeInForce time_in_force);
+    static Order stopLimitBidOrder(uint64_t order_id, uint32_t symbol_id, Price price, Price stop_price, Quantity quantity,
+        OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * Create a new trailing stop order on the ask side.
@@ -205,10 +308,11 @@ public:
      * @param trail_amount the trail amount, require that trail_amount is positive.
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order, require that time in force is IOC or FOK.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new trailing stop order.
      */
-    static Order trailingStopAskOrder(
-        uint64_t order_id, uint32_t symbol_id, uint64_t trail_amount, uint64_t quantity, OrderTimeInForce time_in_force);
+    static Order trailingStopAskOrder(uint64_t order_id, uint32_t symbol_id, Price trail_amount, Quantity quantity,
+        OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * Create a new trailing stop order on the bid side.
@@ -218,10 +322,11 @@ public:
      * @param trail_amount the trail amount, require that trail_amount is positive.
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order, require that time in force is IOC or FOK.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new trailing stop order.
      */
-    static Order trailingStopBidOrder(
-        uint64_t order_id, uint32_t symbol_id, uint64_t trail_amount, uint64_t quantity, OrderTimeInForce time_in_force);
+    static Order trailingStopBidOrder(uint64_t order_id, uint32_t symbol_id, Price trail_amount, Quantity quantity,
+        OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * Create a new trailing stop limit order on the ask side.
@@ -232,10 +337,11 @@ public:
      * @param trail_amount the trail amount, require that trail_amount is positive.
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order, require that time in force is IOC or FOK.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new trailing stop limit order.
      */
-    static Order trailingStopLimitAskOrder(
-        uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t trail_amount, uint64_t quantity, OrderTimeInForce time_in_force);
+    static Order trailingStopLimitAskOrder(uint64_t order_id, uint32_t symbol_id, Price price, Price trail_amount, Quantity quantity,
+        OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * Create a new trailing stop limit order on the bid side.
@@ -246,15 +352,16 @@ public:
      * @param trail_amount the trail amount, require that trail_amount is positive.
      * @param quantity the quantity of the order, require that quantity is positive.
      * @param time_in_force the time in force of the order, require that time in force is IOC or FOK.
+     * @param owner_id the ID of the owner (e.g. session) of the order, or zero if the order has no owner.
      * @return a new trailing stop limit order.
      */
-    static Order trailingStopLimitBidOrder(
-        uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t trail_amount, uint64_t quantity, OrderTimeInForce time_in_force);
+    static Order trailingStopLimitBidOrder(uint64_t order_id, uint32_t symbol_id, Price price, Price trail_amount, Quantity quantity,
+        OrderTimeInForce time_in_force, uint32_t owner_id = 0);
 
     /**
      * @return the quantity of the order.
      */
-    [[nodiscard]] uint64_t getQuantity() const
+    [[nodiscard]] Quantity getQuantity() const
     {
         return quantity;
     }
@@ -262,7 +369,7 @@ public:
     /**
      * @return the quantity of the order that has been executed.
      */
-    [[nodiscard]] uint64_t getExecutedQuantity() const
+    [[nodiscard]] Quantity getExecutedQuantity() const
     {
         return executed_quantity;
     }
@@ -270,7 +377,7 @@ public:
     /**
      * @return the quantity of the order that remains to be executed.
      */
-    [[nodiscard]] uint64_t getOpenQuantity() const
+    [[nodiscard]] Quantity getOpenQuantity() const
     {
         return open_quantity;
     }
@@ -279,7 +386,7 @@ public:
      * @return the last executed quantity of the order if the order
      *         has been executed, otherwise zero.
      */
-    [[nodiscard]] uint64_t getLastExecutedQuantity() const
+    [[nodiscard]] Quantity getLastExecutedQuantity() const
     {
         return last_executed_quantity;
     }
@@ -295,7 +402,7 @@ public:
     /**
      * @return the price associated with the order.
      */
-    [[nodiscard]] uint64_t getPrice() const
+    [[nodiscard]] Price getPrice() const
     {
         return price;
     }
@@ -304,7 +411,7 @@ public:
      * @return the stop price associated with the order
      *         if applicable, otherwise zero.
      */
-    [[nodiscard]] uint64_t getStopPrice() const
+    [[nodiscard]] Price getStopPrice() const
     {
         return stop_price;
     }
@@ -313,7 +420,7 @@ public:
      * @return the trail amount associated with the order
      *         if applicable, otherwise zero.
      */
-    [[nodiscard]] uint64_t getTrailAmount() const
+    [[nodiscard]] Price getTrailAmount() const
     {
         return trail_amount;
     }
@@ -347,7 +454,7 @@ public:
      * @return the price at which the order was last executed if the order
      *         has been executed, otherwise zero.
      */
-    [[nodiscard]] uint64_t getLastExecutedPrice() const
+    [[nodiscard]] Price getLastExecutedPrice() const
     {
         return last_executed_price;
     }
@@ -360,6 +467,23 @@ public:
         return symbol_id;
     }
 
+    /**
+     * @return the ID of the owner of the order, or zero if the order has no owner.
+     */
+    [[nodiscard]] uint32_t getOwnerID() const
+    {
+        return owner_id;
+    }
+
+    /**
+     * @return the time at which a GTD order expires in nanoseconds since the epoch,
+     *         or zero if the order is not a GTD order.
+     */
+    [[nodiscard]] uint64_t getExpiryTime() const
+    {
+        return expiry_time;
+    }
+
     /**
      * @return true if order is on the ask side and false otherwise.
      */
@@ -448,6 +572,22 @@ public:
         return time_in_force == OrderTimeInForce::FOK;
     }
 
+    /**
+     * @return true if the order is a GTD order and false otherwise.
+     */
+    [[nodiscard]] bool isGtd() const
+    {
+        return time_in_force == OrderTimeInForce::GTD;
+    }
+
+    /**
+     * @return true if the order is a DAY order and false otherwise.
+     */
+    [[nodiscard]] bool isDay() const
+    {
+        return time_in_force == OrderTimeInForce::DAY;
+    }
+
     /**
      * @return true if the order is filled (i.e. the entire quantity of the order
      *         has been executed) and false otherwise.
@@ -457,6 +597,32 @@ public:
         return open_quantity == 0;
     }
 
+    /**
+     * @return true if the order is an iceberg order and false otherwise.
+     */
+    [[nodiscard]] bool isIceberg() const
+    {
+        return display_quantity > 0;
+    }
+
+    /**
+     * @return the quantity of an iceberg order that is displayed at a time, or zero
+     *         if the order is not an iceberg order.
+     */
+    [[nodiscard]] Quantity getDisplayQuantity() const
+    {
+        return display_quantity;
+    }
+
+    /**
+     * @return the open quantity of the order that is currently displayed. This is
+     *         the open quantity of the order unless the order is an iceberg order.
+     */
+    [[nodiscard]] Quantity getVisibleQuantity() const
+    {
+        return display_quantity == 0 ? open_quantity : std::min(visible_quantity, open_quantity);
+    }
+
     /**
      * Indicates whether two orders are equal. Two orders are equal iff they
      * have the same order ID.
@@ -488,6 +654,8 @@ public:
     friend std::ostream &operator<<(std::ostream &os, const Order &order);
     friend class MapOrderBook;
     friend class Level;
+    friend struct OrderRecord;
+    friend struct OrderBookHandler;
 
 private:
     /**
@@ -503,9 +671,11 @@ private:
      *                      stop limit orders will trail.
      * @param quantity_ the quantity of the order.
      * @param id_ the ID associated with the order.
+     * @param owner_id_ the ID of the owner of the order, or zero if the order has no owner.
+     * @param expiry_time_ the time at which the order expires if it is a GTD order, otherwise zero.
      */
-    Order(OrderType type_, OrderSide side_, OrderTimeInForce time_in_force_, uint32_t symbol_id_, uint64_t price_, uint64_t stop_price_,
-        uint64_t trail_amount_, uint64_t quantity_, uint64_t id_);
+    Order(OrderType type_, OrderSide side_, OrderTimeInForce time_in_force_, uint32_t symbol_id_, Price price_, Price stop_price_,
+        Price trail_amount_, Quantity quantity_, uint64_t id_, uint32_t owner_id_, uint64_t expiry_time_ = 0);
 
     /**
      * Executes the order.
@@ -513,22 +683,31 @@ private:
      * @param price_ the price at which to execute the order, require that price is positive.
      * @param quantity_ the quantity of the order to execute, require that quantity is positive.
      */
-    void execute(uint32_t price_, uint64_t quantity_)
+    void execute(Price price_, Quantity quantity_)
     {
         open_quantity -= quantity_;
         executed_quantity += quantity_;
+        visible_quantity -= std::min(visible_quantity, quantity_);
         last_executed_price = price_;
         last_executed_quantity = quantity_;
         VALIDATE_ORDER;
     }
 
+    /**
+     * Replenishes the displayed quantity of an iceberg order from its hidden quantity.
+     */
+    void replenish()
+    {
+        visible_quantity = std::min(display_quantity, open_quantity);
+    }
+
     /**
      * Set the price of the order.
      *
      * @param price_ the new price of that order, require that price
      *               is positive if the order is not a market order.
      */
-    void setPrice(uint64_t price_)
+    void setPrice(Price price_)
     {
         price = price_;
         VALIDATE_ORDER;
@@ -540,7 +719,7 @@ private:
      *
      * @param stop_price_ the new price of that order, require that price_ is positive.
      */
-    void setStopPrice(uint64_t stop_price_)
+    void setStopPrice(Price stop_price_)
     {
         stop_price = stop_price_;
         VALIDATE_ORDER;
@@ -552,7 +731,7 @@ private:
      *
      * @param trail_amount_ the new trail amount of the order.
      */
-    void setTrailAmount(uint64_t trail_amount_)
+    void setTrailAmount(Price trail_amount_)
     {
         trail_amount = trail_amount_;
         VALIDATE_ORDER;
@@ -563,13 +742,40 @@ private:
      *
      * @param quantity_ the new quantity of the order, require that quantity_ is positive.
      */
-    void setQuantity(uint64_t quantity_)
+    void setQuantity(Quantity quantity_)
     {
         quantity = std::min(quantity_, open_quantity);
         open_quantity -= quantity_;
         VALIDATE_ORDER;
     }
 
+    /**
+     * Set the open quantity of the order. The quantity of the order is adjusted
+     * so that the executed quantity of the order is preserved.
+     *
+     * @param open_quantity_ the new open quantity of the order, require that open_quantity_ is positive.
+     */
+    void setOpenQuantity(Quantity open_quantity_)
+    {
+        quantity = executed_quantity + open_quantity_;
+        open_quantity = open_quantity_;
+        VALIDATE_ORDER;
+    }
+
+    /**
+     * Cancels some of the open quantity of the order. The quantity and executed
+     * quantity of the order are unchanged.
+     *
+     * @param cancelled_quantity the quantity to cancel, require that cancelled_quantity
+     *                           does not exceed the open quantity of the order.
+     */
+    void cancel(Quantity cancelled_quantity)
+    {
+        assert(cancelled_quantity <= open_quantity && "Cannot cancel more than the open quantity of the order!");
+        open_quantity -= cancelled_quantity;
+        VALIDATE_ORDER;
+    }
+
     /**
      * Set the ID of the order.
      *
@@ -607,19 +813,26 @@ private:
      */
     void validateOrder() const;
 
+    // Members are ordered from widest to narrowest to avoid padding.
+    uint64_t id;
+    uint64_t expiry_time;
+    Price price;
+    Price stop_price;
+    Price trail_amount;
+    Price last_executed_price;
+    Quantity quantity;
+    Quantity executed_quantity;
+    Quantity open_quantity;
+    Quantity last_executed_quantity;
+    // The quantity of an iceberg order that is displayed at a time and the part of
+    // it that has not been executed yet. Both are zero for other orders.
+    Quantity display_quantity;
+    Quantity visible_quantity;
+    uint32_t symbol_id;
+    uint32_t owner_id;
     OrderType type;
     OrderSide side;
     OrderTimeInForce time_in_force;
-    uint32_t symbol_id;
-    uint64_t price;
-    uint64_t stop_price;
-    uint64_t trail_amount;
-    uint64_t last_executed_price;
-    uint64_t id;
-    uint64_t quantity;
-    uint64_t executed_quantity;
-    uint64_t open_quantity;
-    uint64_t last_executed_quantity;
 };
 } // namespace RapidTrader
 #endif // RAPID_TRADER_ORDER_H
@@ -0,0 +1,43 @@
+#ifndef RAPID_TRADER_ORDER_RECORD_H
+#define RAPID_TRADER_ORDER_RECORD_H
+#include "order.h"
+
+namespace RapidTrader {
+/**
+ * A plain copy of the state of an order that can be copied byte for byte, e.g.
+ * into memory that is shared with another process. Orders themselves cannot be
+ * since they contain the hooks that link them into a book.
+ */
+struct OrderRecord
+{
+    /**
+     * @param order an order.
+     * @return a record of the state of the order.
+     */
+    static OrderRecord fromOrder(const Order &order);
+
+    /**
+     * @return an order with the state in the record.
+     */
+    [[nodiscard]] Order toOrder() const;
+
+    uint64_t id;
+    uint64_t expiry_time;
+    Price price;
+    Price stop_price;
+    Price trail_amount;
+    Price last_executed_price;
+    Quantity quantity;
+    Quantity executed_quantity;
+    Quantity open_quantity;
+    Quantity last_executed_quantity;
+    Quantity display_quantity;
+    Quantity visible_quantity;
+    uint32_t symbol_id;
+    uint32_t owner_id;
+    OrderType type;
+    OrderSide side;
+    OrderTimeInForce time_in_force;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_ORDER_RECORD_H
@@ -1,8 +1,60 @@
 #ifndef RAPID_TRADER_ORDERBOOK_H
 #define RAPID_TRADER_ORDERBOOK_H
 #include "order.h"
+#include "book_snapshot.h"
+#include "book_query.h"
 
 namespace RapidTrader {
+class RiskCheck;
+
+/**
+ * Supported self-trade prevention modes. A self-trade occurs when an incoming
+ * order would match an order resting in the book that has the same owner. Orders
+ * without an owner never self-trade.
+ *
+ * None: orders with the same owner are matched like any other orders.
+ *
+ * Cancel Newest: the remaining quantity of the incoming order is cancelled.
+ *
+ * Cancel Oldest: the resting order is deleted and matching continues.
+ *
+ * Cancel Both: the resting order is deleted and the remaining quantity of the
+ * incoming order is cancelled.
+ *
+ * Decrement: the smaller open quantity of the two orders is cancelled from both
+ * orders without a trade. Any order that is left with no open quantity is deleted.
+ */
+enum class SelfTradePrevention : uint8_t
+{
+    None = 0,
+    CancelNewest = 1,
+    CancelOldest = 2,
+    CancelBoth = 3,
+    Decrement = 4
+};
+
+/**
+ * Supported allocation policies. An allocation policy decides how the quantity of
+ * an incoming order is shared between the orders resting at a price level that it
+ * matches against.
+ *
+ * FIFO: resting orders are filled in price-time priority.
+ *
+ * Pro-Rata: the quantity matched at a level is shared between the resting orders in
+ * proportion to their displayed quantities, rounded down. Any quantity that is left
+ * over after rounding is allocated one at a time to the resting orders in time priority.
+ *
+ * Top Order Pro-Rata: the order at the front of a level is filled first the first time
+ * that an incoming order matches against the level. Any remaining quantity at the
+ * level is then allocated pro-rata.
+ */
+enum class AllocationPolicy : uint8_t
+{
+    Fifo = 0,
+    ProRata = 1,
+    TopOrderProRata = 2
+};
+
 class OrderBook
 {
 public:
@@ -21,7 +73,7 @@ public:
      * @param quantity the quantity of the order to execute, require that quantity is positive.
      * @param price the price to execute the order at, require that price is positive.
      */
-    virtual void executeOrder(uint64_t order_id, uint64_t quantity, uint64_t price) = 0;
+    virtual void executeOrder(uint64_t order_id, Quantity quantity, Price price) = 0;
 
     /**
      * Executes an order in the book.
@@ -30,7 +82,7 @@ public:
      *                 ID exists in the book.
      * @param quantity the quantity of the order to execute, require that quantity is positive.
      */
-    virtual void executeOrder(uint64_t order_id, uint64_t quantity) = 0;
+    virtual void executeOrder(uint64_t order_id, Quantity quantity) = 0;
 
     /**
      * Deletes an existing order from the book.
@@ -40,6 +92,47 @@ public:
      */
     virtual void deleteOrder(uint64_t order_id) = 0;
 
+    /**
+     * Deletes all orders from the book.
+     */
+    virtual void deleteOrders() = 0;
+
+    /**
+     * Deletes all orders on one side of the book.
+     *
+     * @param side the side of the book to delete orders from.
+     */
+    virtual void deleteOrders(OrderSide side) = 0;
+
+    /**
+     * Deletes the orders on one side of the book that rest at a price within the
+     * provided range. Limit orders rest at their price and stop orders rest at their
+     * stop price.
+     *
+     * @param side the side of the book to delete orders from.
+     * @param min_price the lowest price to delete orders at.
+     * @param max_price the highest price to delete orders at, require that max_price >= min_price.
+     */
+    virtual void deleteOrders(OrderSide side, Price min_price, Price max_price) = 0;
+
+    /**
+     * Deletes all orders in the book that belong to an owner.
+     *
+     * @param owner_id the ID of the owner, require that owner_id is positive.
+     */
+    virtual void deleteOwnerOrders(uint32_t owner_id) = 0;
+
+    /**
+     * Deletes the GTD orders in the book that have expired according to the clock of the book.
+     * Expired orders are also deleted whenever an order is added to the book.
+     */
+    virtual void expireOrders() = 0;
+
+    /**
+     * Deletes all DAY orders from the book, e.g. at the end of a trading session.
+     */
+    virtual void deleteDayOrders() = 0;
+
     /**
      * Cancels the provided quantity of an order in the book. Removes order from
      * the book if provided quantity exceeds the open quantity of the order.
@@ -48,17 +141,134 @@ public:
      *                 ID exists in the book.
      * @param quantity the quantity of the order to cancel, require that quantity is positive.
      */
-    virtual void cancelOrder(uint64_t order_id, uint64_t quantity) = 0;
+    virtual void cancelOrder(uint64_t order_id, Quantity quantity) = 0;
 
     /**
-     * Replaces an existing order in the book.
+     * Replaces an existing order in the book. The new order is rejected, and the existing
+     * order left in the book, if the book is halted or the new price is outside the price band.
      *
      * @param order_id the ID of the order to replace, require that an order with the provided
      *                 ID exists in the book.
      * @param new_order_id the ID that the new order will have.
      * @param new_price the new price of the order, require that new_price is positive.
      */
-    virtual void replaceOrder(uint64_t order_id, uint64_t new_order_id, uint64_t new_price) = 0;
+    virtual void replaceOrder(uint64_t order_id, uint64_t new_order_id, Price new_price) = 0;
+
+    /**
+     * Amends the open quantity and price of an order in the book. Reducing the
+     * quantity of an order without changing its price keeps its time priority.
+     * Otherwise the order loses priority and, if it is a limit order whose price
+     * changed, it is matched against the book at its new price. The amendment is
+     * rejected, and the order left as it was, if the book is halted or the new price
+     * is outside the price band.
+     *
+     * @param order_id the ID of the order to amend, require that an order with the provided
+     *                 ID exists in the book.
+     * @param new_quantity the new open quantity of the order, require that new_quantity is positive.
+     * @param new_price the new price of the order, require that new_price is positive if the order
+     *                  is a limit, stop limit, or trailing stop limit order.
+     */
+    virtual void amendOrder(uint64_t order_id, Quantity new_quantity, Price new_price) = 0;
+
+    /**
+     * Sets how the book handles an incoming order that would match a resting order
+     * with the same owner. Self-trade prevention is disabled by default. A FOK order
+     * that is able to fill may still have its remaining quantity cancelled by self-trade
+     * prevention.
+     *
+     * @param mode the self-trade prevention mode.
+     */
+    virtual void setSelfTradePrevention(SelfTradePrevention mode) = 0;
+
+    /**
+     * Sets how the quantity of an incoming order is allocated between the orders resting
+     * at the levels it matches against. The book uses FIFO allocation by default.
+     *
+     * @param policy the allocation policy.
+     */
+    virtual void setAllocationPolicy(AllocationPolicy policy) = 0;
+
+    /**
+     * Sets the risk stage that checks the orders that enter the book and is told about every
+     * execution and release of open quantity in the book. The open quantity of the resting
+     * orders is released from the previous risk stage and recorded by the new one.
+     *
+     * @param risk_check the risk stage, or nullptr if there is none. The risk stage must outlive the book.
+     */
+    virtual void setRiskCheck(RiskCheck *risk_check) = 0;
+
+    /**
+     * Starts an auction. While the book is in an auction, limit orders rest in the book
+     * without being matched, even if the book becomes crossed. Market, IOC, and FOK orders
+     * cannot rest in the book and are deleted without being matched.
+     */
+    virtual void startAuction() = 0;
+
+    /**
+     * Ends an auction by executing all crossed limit orders at the auction price and returns
+     * the book to continuous matching. Orders are executed in price-time priority. Sends a single
+     * notification for all of the executed orders and another for all of the filled orders.
+     */
+    virtual void uncrossAuction() = 0;
+
+    /**
+     * Halts trading in the book. New orders are rejected while the book is halted, but orders
+     * in the book may still be cancelled, amended, or deleted.
+     */
+    virtual void halt() = 0;
+
+    /**
+     * Resumes trading in the book after a halt.
+     */
+    virtual void resume() = 0;
+
+    /**
+     * @return true if trading in the book is halted and false otherwise.
+     */
+    [[nodiscard]] virtual bool isHalted() const = 0;
+
+    /**
+     * Sets a price band around a reference price. New limit orders with a price further than the
+     * band from the reference price are rejected. Market orders and stop orders are not checked.
+     *
+     * @param band_bps the width of the band on either side of the reference price in basis points
+     *                 of the reference price, or zero to remove the band.
+     * @param reference_price the reference price, or zero to use the last traded price. No orders
+     *                        are rejected while the reference price is zero.
+     */
+    virtual void setPriceBand(uint32_t band_bps, Price reference_price) = 0;
+
+    /**
+     * Sets the length of the bars that the trades of the book are aggregated into. A bar covers
+     * an interval of the clock of the book that starts at a multiple of the length, and is sent
+     * once a trade occurs after the end of the interval or closeBars is called after it. Closes
+     * the bar that is open, if any.
+     *
+     * @param bar_interval the length of the bars in nanoseconds, or zero to stop sending bars.
+     */
+    virtual void setBarInterval(uint64_t bar_interval) = 0;
+
+    /**
+     * Sends the bar that is open if its interval has ended according to the clock of the book.
+     * Bars are also sent whenever a trade occurs, so this only needs to be called to send the
+     * bars of books that are idle.
+     */
+    virtual void closeBars() = 0;
+
+    /**
+     * @return true if the book is in an auction and false otherwise.
+     */
+    [[nodiscard]] virtual bool inAuction() const = 0;
+
+    /**
+     * Calculates the price that the book would uncross at. The auction price is the price that
+     * maximises the executed volume. Ties are broken by minimising the imbalance between the bid
+     * volume and the ask volume at the price, then by choosing the price closest to the last traded
+     * price, and then by choosing the lowest price.
+     *
+     * @return the auction price if the book is crossed, otherwise zero.
+     */
+    [[nodiscard]] virtual Price auctionPrice() const = 0;
 
     /**
      * @param order_id the ID of the order to check the book for, require that quantity is positive.
@@ -88,17 +298,35 @@ public:
     /**
      * @return the highest bid price if there any bid orders in the book, otherwise zero.
      */
-    [[nodiscard]] virtual uint64_t bestBid() const = 0;
+    [[nodiscard]] virtual Price bestBid() const = 0;
 
     /**
-     * @return the lowest ask price if there any ask orders in the book, otherwise max 64-bit integer value.
+     * @return the lowest ask price if there any ask orders in the book, otherwise the max price value.
      */
-    [[nodiscard]] virtual uint64_t bestAsk() const = 0;
+    [[nodiscard]] virtual Price bestAsk() const = 0;
 
     /**
      * @return the last traded price if any trades have occurred, otherwise zero.
      */
-    [[nodiscard]] virtual uint64_t lastTradedPrice() const = 0;
+    [[nodiscard]] virtual Price lastTradedPrice() const = 0;
+
+    /**
+     * @param price a price.
+     * @return the total open quantity of the bid limit orders with a price greater than or equal to the provided price.
+     */
+    [[nodiscard]] virtual Volume bidVolumeAtOrAbove(Price price) const = 0;
+
+    /**
+     * @param price a price.
+     * @return the total open quantity of the ask limit orders with a price less than or equal to the provided price.
+     */
+    [[nodiscard]] virtual Volume askVolumeAtOrBelow(Price price) const = 0;
+
+    /**
+     * @return the number of times the book has had to grow its internal
+     *         storage (e.g. rehash its order index) while adding orders.
+     */
+    [[nodiscard]] virtual uint64_t numberOfGrowthEvents() const = 0;
 
     /**
      * Writes the string representation of the the orderbook to
@@ -108,6 +336,27 @@ public:
      */
     virtual void dumpBook(const std::string &path) const = 0;
 
+    /**
+     * @return a snapshot of the levels in the book.
+     */
+    [[nodiscard]] virtual BookSnapshot snapshot() const = 0;
+
+    /**
+     * @return the best price on each side of the book and the volume resting at it.
+     */
+    [[nodiscard]] virtual BestBidOffer bestBidOffer() const = 0;
+
+    /**
+     * @param max_levels the maximum number of levels to return for each side.
+     * @return the best limit levels on each side of the book.
+     */
+    [[nodiscard]] virtual BookDepth depth(size_t max_levels) const = 0;
+
+    /**
+     * @return a summary of the state of the book.
+     */
+    [[nodiscard]] virtual SymbolStatistics statistics() const = 0;
+
     /**
      * @return a string representation of the book.
      */
@@ -0,0 +1,101 @@
+#ifndef RAPID_TRADER_TIMER_WHEEL_H
+#define RAPID_TRADER_TIMER_WHEEL_H
+#include <array>
+#include "order.h"
+
+namespace RapidTrader {
+// A list of orders linked through their expiry hook.
+using ExpiryList = list<Order, base_hook<ExpiryHook>, constant_time_size<false>>;
+
+/**
+ * A hierarchical timer wheel that schedules the expiry of GTD orders. Time is
+ * divided into ticks and each level of the wheel has a slot for each of the next
+ * 64 ticks (level 0), 64 * 64 ticks (level 1), and so on. An order is placed in the
+ * slot of the lowest level that covers its expiry tick and is cascaded down to a
+ * lower level when the wheel reaches the slot that it is in. Orders that expire
+ * beyond the range of the highest level are kept in an overflow list that is
+ * cascaded once per rotation of the highest level.
+ *
+ * Scheduling an order and expiring it are constant time and an order is cascaded
+ * at most once per level. Orders are linked into the wheel intrusively, so an order
+ * that is deleted from the book before it expires leaves the wheel automatically.
+ */
+class TimerWheel
+{
+public:
+    /**
+     * A constructor for the timer wheel.
+     *
+     * @param tick_duration_ the length of a tick in nanoseconds, require that tick_duration_ is positive.
+     * @param start_time the current time in nanoseconds since the epoch.
+     */
+    TimerWheel(uint64_t tick_duration_, uint64_t start_time);
+
+    /**
+     * Schedules the expiry of an order. The order expires at the end of the tick that
+     * contains its expiry time, so it never expires early. An order whose expiry time
+     * has already passed expires the next time the wheel is advanced past the current tick.
+     *
+     * @param order the order to schedule, require that order is a GTD order that is not
+     *              already scheduled.
+     */
+    void schedule(Order &order);
+
+    /**
+     * Advances the wheel to the provided time and moves the orders that have expired
+     * into the provided list.
+     *
+     * @param now the current time in nanoseconds since the epoch.
+     * @param expired the list that the expired orders are moved to.
+     */
+    void advance(uint64_t now, ExpiryList &expired);
+
+private:
+    static constexpr uint32_t slot_bits = 6;
+    static constexpr uint64_t num_slots = uint64_t{1} << slot_bits;
+    static constexpr uint64_t slot_mask = num_slots - 1;
+    static constexpr uint32_t num_levels = 4;
+
+    /**
+     * @param time a time in nanoseconds since the epoch.
+     * @return the first tick that starts at or after the provided time.
+     */
+    [[nodiscard]] uint64_t toTick(uint64_t time) const
+    {
+        return time / tick_duration + (time % tick_duration != 0);
+    }
+
+    /**
+     * Places an order in the slot that covers the provided tick.
+     *
+     * @param order the order to place.
+     * @param tick the tick that the order expires at, require that tick is at least
+     *             the current tick.
+     */
+    void place(Order &order, uint64_t tick);
+
+    /**
+     * Moves the orders in a list back into the wheel relative to the current tick.
+     *
+     * @param orders the orders to move.
+     */
+    void cascade(ExpiryList &orders);
+
+    /**
+     * @param target_tick the tick that the wheel is being advanced to.
+     * @return the next tick before or at the target tick that has a slot that may
+     *         need to be cascaded or expired. Empty slots are skipped.
+     */
+    [[nodiscard]] uint64_t nextTick(uint64_t target_tick) const;
+
+    // The slots of each level of the wheel.
+    std::array<std::array<ExpiryList, num_slots>, num_levels> wheel;
+    // The orders that expire beyond the range of the highest level.
+    ExpiryList overflow;
+    // The length of a tick in nanoseconds.
+    uint64_t tick_duration;
+    // The last tick that the wheel has been advanced to.
+    uint64_t current_tick;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_TIMER_WHEEL_H
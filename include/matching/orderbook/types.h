@@ -0,0 +1,21 @@
+#ifndef RAPID_TRADER_TYPES_H
+#define RAPID_TRADER_TYPES_H
+#include <cstdint>
+
+namespace RapidTrader {
+// Prices and quantities are 64-bit by default. Defining RAPID_TRADER_NARROW_TYPES
+// (see ENABLE_NARROW_TYPES in CMakeLists.txt) switches them to 32-bit, which shrinks
+// orders and the keys of the level maps for instruments that fit in 32-bit ticks and quantities.
+#ifdef RAPID_TRADER_NARROW_TYPES
+using Price = uint32_t;
+using Quantity = uint32_t;
+#else
+using Price = uint64_t;
+using Quantity = uint64_t;
+#endif
+
+// The sum of the quantities of many orders (e.g. the volume of a level),
+// which may exceed the range of a single quantity.
+using Volume = uint64_t;
+} // namespace RapidTrader
+#endif // RAPID_TRADER_TYPES_H
@@ -0,0 +1,87 @@
+#ifndef RAPID_TRADER_CLOCK_H
+#define RAPID_TRADER_CLOCK_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace RapidTrader {
+/**
+ * A source of time for the orderbooks. Orderbooks use the clock to
+ * decide when GTD orders expire.
+ */
+class Clock
+{
+public:
+    /**
+     * @return the current time in nanoseconds since the epoch.
+     */
+    [[nodiscard]] virtual uint64_t now() const = 0;
+
+    virtual ~Clock() = default;
+};
+
+/**
+ * A clock that reads the system time.
+ */
+class SystemClock : public Clock
+{
+public:
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] uint64_t now() const override
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+};
+
+/**
+ * A clock that only moves when it is told to. Useful for replaying
+ * historical order flow and for testing. Safe to read from multiple threads.
+ */
+class ManualClock : public Clock
+{
+public:
+    /**
+     * A constructor for the manual clock.
+     *
+     * @param time_ the initial time in nanoseconds since the epoch.
+     */
+    explicit ManualClock(uint64_t time_ = 0)
+        : time(time_)
+    {}
+
+    /**
+     * @inheritdoc
+     */
+    [[nodiscard]] uint64_t now() const override
+    {
+        return time.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Sets the time of the clock.
+     *
+     * @param time_ the new time in nanoseconds since the epoch.
+     */
+    void setTime(uint64_t time_)
+    {
+        time.store(time_, std::memory_order_release);
+    }
+
+    /**
+     * Moves the clock forward.
+     *
+     * @param duration the number of nanoseconds to move the clock forward by.
+     */
+    void advance(uint64_t duration)
+    {
+        time.fetch_add(duration, std::memory_order_acq_rel);
+    }
+
+private:
+    // The current time in nanoseconds since the epoch.
+    std::atomic<uint64_t> time;
+};
+} // namespace RapidTrader
+#endif // RAPID_TRADER_CLOCK_H
@@ -6,15 +6,16 @@ class Log
 {
 public:
     /**
-     * Initializes the logger.
+     * Initializes the logger. Only the first call has any effect.
      */
     static void init();
 
     /**
-     * @return a reference to the logger.
+     * @return a reference to the logger, initializing it if necessary.
      */
     inline static std::shared_ptr<spdlog::logger> &getLogger()
     {
+        init();
         return logger;
     }
 
@@ -30,10 +31,10 @@ private:
 #    define LOG_ERROR(...) Log::getLogger()->error(__VA_ARGS__)
 #    define LOG_CRITICAL(...) Log::getLogger()->critical(__VA_ARGS__)
 #else
-#    define LOG_TRACE
-#    define LOG_DEBUG
-#    define LOG_INFO
-#    define LOG_WARN
+#    define LOG_TRACE(...)
+#    define LOG_DEBUG(...)
+#    define LOG_INFO(...)
+#    define LOG_WARN(...)
 #    define LOG_ERROR(...) Log::getLogger()->error(__VA_ARGS__)
 #    define LOG_CRITICAL(...) Log::getLogger()->critical(__VA_ARGS__)
 #endif
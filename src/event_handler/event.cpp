@@ -37,10 +37,90 @@ std::ostream &operator<<(std::ostream &os, const OrderDeleted &notification)
     return os;
 }
 
+std::ostream &operator<<(std::ostream &os, const OrdersDeleted &notification)
+{
+    os << "DELETED ORDERS\n"
+       << "Symbol ID: " << notification.symbol_id << "\n";
+    for (const auto &order : notification.orders)
+        os << order;
+    return os;
+}
+
+std::ostream &operator<<(std::ostream &os, const OrdersExecuted &notification)
+{
+    os << "EXECUTED ORDERS\n"
+       << "Symbol ID: " << notification.symbol_id << "\n";
+    for (const auto &order : notification.orders)
+        os << order;
+    return os;
+}
+
 std::ostream &operator<<(std::ostream &os, const OrderUpdated &notification)
 {
     os << "UPDATED ORDER\n" << notification.order;
     return os;
 }
+
+std::ostream &operator<<(std::ostream &os, const OrderRejected &notification)
+{
+    std::string reason;
+    switch (notification.reason)
+    {
+    case RejectReason::Halted:
+        reason = "Halted";
+        break;
+    case RejectReason::OutsidePriceBand:
+        reason = "Outside Price Band";
+        break;
+    case RejectReason::PositionLimit:
+        reason = "Position Limit";
+        break;
+    case RejectReason::NotionalLimit:
+        reason = "Notional Limit";
+        break;
+    case RejectReason::OrderRateLimit:
+        reason = "Order Rate Limit";
+        break;
+    case RejectReason::UnknownAccount:
+        reason = "Unknown Account";
+        break;
+    case RejectReason::UnknownSymbol:
+        reason = "Unknown Symbol";
+        break;
+    }
+    os << "REJECTED ORDER\n"
+       << "Reason: " << reason << "\n"
+       << notification.order;
+    return os;
+}
+
+std::ostream &operator<<(std::ostream &os, const Trade &notification)
+{
+    os << "TRADE\n"
+       << "Symbol ID: " << notification.symbol_id << "\n"
+       << "Aggressor ID: " << notification.aggressor_id << "\n"
+       << "Passive ID: " << notification.passive_id << "\n"
+       << "Aggressor Side: " << (notification.aggressor_side == OrderSide::Bid ? "Bid" : "Ask") << "\n"
+       << "Price: " << notification.price << "\n"
+       << "Quantity: " << notification.quantity << "\n"
+       << "Aggressor Open Quantity: " << notification.aggressor_open_quantity << "\n"
+       << "Passive Open Quantity: " << notification.passive_open_quantity << "\n";
+    return os;
+}
+
+std::ostream &operator<<(std::ostream &os, const TradeBar &notification)
+{
+    os << "TRADE BAR\n"
+       << "Symbol ID: " << notification.symbol_id << "\n"
+       << "Start Time: " << notification.start_time << "\n"
+       << "End Time: " << notification.end_time << "\n"
+       << "Open: " << notification.open_price << "\n"
+       << "High: " << notification.high_price << "\n"
+       << "Low: " << notification.low_price << "\n"
+       << "Close: " << notification.close_price << "\n"
+       << "Volume: " << notification.volume << "\n"
+       << "Trades: " << notification.num_trades << "\n";
+    return os;
+}
 } // namespace RapidTrader
 // LCOV_EXCL_STOP
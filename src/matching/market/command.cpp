@@ -0,0 +1,151 @@
+#include <cassert>
+#include "market/command.h"
+
+namespace RapidTrader {
+Command Command::addSymbol(uint32_t symbol_id, const std::string &symbol_name, size_t max_orders, size_t max_levels)
+{
+    assert(symbol_name.size() <= max_command_symbol_name_length && "Symbol name is too long!");
+    Command command = make(CommandType::AddSymbol, symbol_id);
+    command.max_orders = max_orders;
+    command.max_levels = max_levels;
+    symbol_name.copy(command.symbol_name, max_command_symbol_name_length);
+    return command;
+}
+
+Command Command::deleteSymbol(uint32_t symbol_id, const std::string &symbol_name)
+{
+    assert(symbol_name.size() <= max_command_symbol_name_length && "Symbol name is too long!");
+    Command command = make(CommandType::DeleteSymbol, symbol_id);
+    symbol_name.copy(command.symbol_name, max_command_symbol_name_length);
+    return command;
+}
+
+Command Command::addOrder(const Order &order)
+{
+    Command command = make(CommandType::AddOrder, order.getSymbolID());
+    command.order = OrderRecord::fromOrder(order);
+    return command;
+}
+
+Command Command::deleteOrder(uint32_t symbol_id, uint64_t order_id)
+{
+    Command command = make(CommandType::DeleteOrder, symbol_id);
+    command.order_id = order_id;
+    return command;
+}
+
+Command Command::deleteOrders(uint32_t symbol_id)
+{
+    return make(CommandType::DeleteOrders, symbol_id);
+}
+
+Command Command::deleteOrders(uint32_t symbol_id, OrderSide side)
+{
+    Command command = make(CommandType::DeleteSideOrders, symbol_id);
+    command.side = side;
+    return command;
+}
+
+Command Command::deleteOrders(uint32_t symbol_id, OrderSide side, Price min_price, Price max_price)
+{
+    Command command = make(CommandType::DeletePriceRangeOrders, symbol_id);
+    command.side = side;
+    command.price = min_price;
+    command.max_price = max_price;
+    return command;
+}
+
+Command Command::deleteOwnerOrders(uint32_t owner_id)
+{
+    Command command = make(CommandType::DeleteOwnerOrders);
+    command.owner_id = owner_id;
+    return command;
+}
+
+Command Command::cancelOrder(uint32_t symbol_id, uint64_t order_id, Quantity cancelled_quantity)
+{
+    Command command = make(CommandType::CancelOrder, symbol_id);
+    command.order_id = order_id;
+    command.quantity = cancelled_quantity;
+    return command;
+}
+
+Command Command::replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, Price new_price)
+{
+    Command command = make(CommandType::ReplaceOrder, symbol_id);
+    command.order_id = order_id;
+    command.new_order_id = new_order_id;
+    command.price = new_price;
+    return command;
+}
+
+Command Command::amendOrder(uint32_t symbol_id, uint64_t order_id, Quantity new_quantity, Price new_price)
+{
+    Command command = make(CommandType::AmendOrder, symbol_id);
+    command.order_id = order_id;
+    command.quantity = new_quantity;
+    command.price = new_price;
+    return command;
+}
+
+Command Command::executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity)
+{
+    Command command = make(CommandType::ExecuteOrder, symbol_id);
+    command.order_id = order_id;
+    command.quantity = quantity;
+    return command;
+}
+
+Command Command::executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity, Price price)
+{
+    Command command = make(CommandType::ExecuteOrderAtPrice, symbol_id);
+    command.order_id = order_id;
+    command.quantity = quantity;
+    command.price = price;
+    return command;
+}
+
+Command Command::setSelfTradePrevention(uint32_t symbol_id, SelfTradePrevention mode)
+{
+    Command command = make(CommandType::SetSelfTradePrevention, symbol_id);
+    command.mode = static_cast<uint8_t>(mode);
+    return command;
+}
+
+Command Command::setAllocationPolicy(uint32_t symbol_id, AllocationPolicy policy)
+{
+    Command command = make(CommandType::SetAllocationPolicy, symbol_id);
+    command.mode = static_cast<uint8_t>(policy);
+    return command;
+}
+
+Command Command::setPriceBand(uint32_t symbol_id, uint32_t band_bps, Price reference_price)
+{
+    Command command = make(CommandType::SetPriceBand, symbol_id);
+    command.band_bps = band_bps;
+    command.price = reference_price;
+    return command;
+}
+
+Command Command::setBarInterval(uint32_t symbol_id, uint64_t bar_interval)
+{
+    Command command = make(CommandType::SetBarInterval, symbol_id);
+    command.bar_interval = bar_interval;
+    return command;
+}
+
+Command Command::setRiskCheck(bool installed)
+{
+    Command command = make(CommandType::SetRiskCheck);
+    command.mode = installed ? 1 : 0;
+    return command;
+}
+
+Command Command::make(CommandType type, uint32_t symbol_id)
+{
+    Command command{};
+    command.type = type;
+    command.symbol_id = symbol_id;
+    return command;
+}
+} // namespace RapidTrader
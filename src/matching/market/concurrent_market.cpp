@@ -1,86 +1,278 @@
+#include <algorithm>
 #include "market/concurrent_market.h"
 #include "map_orderbook.h"
 
 namespace RapidTrader {
-ConcurrentMarket::ConcurrentMarket(std::vector<std::unique_ptr<EventHandler>> &event_handlers, uint8_t num_threads)
+ConcurrentMarket::ConcurrentMarket(std::vector<std::unique_ptr<EventHandler>> &event_handlers, uint8_t num_threads,
+    std::shared_ptr<Clock> clock, uint8_t num_background_threads)
     : thread_pool(num_threads)
+    , background_pool(num_background_threads)
     , symbol_submission_index(0)
+    , sequence_number(0)
+    , worker_sequences(std::make_unique<WorkerSequence[]>(num_threads))
 {
     assert(num_threads > 0 && "The number of threads must be positive!");
     assert(event_handlers.size() == num_threads && "The number of event handlers must be equal to the number of threads!");
     orderbook_handlers.reserve(num_threads);
     for (uint32_t i = 0; i < num_threads; ++i)
-        orderbook_handlers.push_back(std::make_unique<OrderBookHandler>(std::move(event_handlers[i])));
+        orderbook_handlers.push_back(std::make_unique<OrderBookHandler>(std::move(event_handlers[i]), clock));
 }
 
-void ConcurrentMarket::addSymbol(uint32_t symbol_id, const std::string &symbol_name)
+void ConcurrentMarket::addSymbol(uint32_t symbol_id, const std::string &symbol_name, size_t max_orders, size_t max_levels)
 {
+    std::lock_guard lock(symbols_mutex);
     auto it = id_to_symbol.find(symbol_id);
     assert(it == id_to_symbol.end() && "Symbol already exists!");
+    // The orderbook must be queued for creation before the symbol can be routed to, otherwise
+    // another producer could queue an order for the symbol ahead of its orderbook.
+    submitSequencedTask(symbol_submission_index, [=](OrderBookHandler *orderbook_handler) {
+        orderbook_handler->addOrderBook(symbol_id, symbol_name, max_orders, max_levels);
+    });
     id_to_symbol.insert({symbol_id, std::make_unique<Symbol>(symbol_id, symbol_name)});
-    id_to_submission_index.insert({symbol_id, symbol_submission_index});
-    OrderBookHandler *orderbook_handler = orderbook_handlers[symbol_submission_index].get();
-    thread_pool.submitTask(symbol_submission_index, [=] { orderbook_handler->addOrderBook(symbol_id, symbol_name); });
+    symbol_routes.insert(symbol_id, symbol_submission_index);
     updateSymbolSubmissionIndex();
 }
 
 void ConcurrentMarket::deleteSymbol(uint32_t symbol_id)
 {
+    std::lock_guard lock(symbols_mutex);
     auto it = id_to_symbol.find(symbol_id);
     assert(it != id_to_symbol.end() && "Symbol does not exist!");
-    uint32_t submission_index = getSubmissionIndex(symbol_id);
-    OrderBookHandler *orderbook_handler = orderbook_handlers[symbol_submission_index].get();
-    thread_pool.submitTask(submission_index, [=] { orderbook_handler->deleteOrderBook(symbol_id, it->second->name); });
-    id_to_symbol.erase(symbol_id);
-    id_to_submission_index.erase(symbol_id);
+    uint32_t submission_index = symbol_routes.find(symbol_id);
+    std::string symbol_name = it->second->name;
+    id_to_symbol.erase(it);
+    symbol_routes.erase(symbol_id);
+    submitSequencedTask(
+        submission_index, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->deleteOrderBook(symbol_id, symbol_name); });
 }
 
 void ConcurrentMarket::addOrder(const Order &order)
 {
-    uint32_t submission_index = getSubmissionIndex(order.getSymbolID());
-    OrderBookHandler *orderbook_handler = orderbook_handlers[submission_index].get();
-    thread_pool.submitTask(submission_index, [=] { orderbook_handler->addOrder(order); });
+    // Only the workers may send events, so an order for an unknown symbol is sent to a worker that will reject it.
+    uint32_t submission_index = submissionIndex(order.getSymbolID());
+    submitSequencedTask(submission_index, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->addOrder(order); });
 }
 
 void ConcurrentMarket::deleteOrder(uint32_t symbol_id, uint64_t order_id)
 {
-    uint32_t submission_index = getSubmissionIndex(symbol_id);
-    OrderBookHandler *orderbook_handler = orderbook_handlers[submission_index].get();
-    thread_pool.submitTask(submission_index, [=] { orderbook_handler->deleteOrder(symbol_id, order_id); });
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->deleteOrder(symbol_id, order_id); });
+}
+
+void ConcurrentMarket::deleteOrders(uint32_t symbol_id)
+{
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->deleteOrders(symbol_id); });
+}
+
+void ConcurrentMarket::deleteOrders(uint32_t symbol_id, OrderSide side)
+{
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->deleteOrders(symbol_id, side); });
+}
+
+void ConcurrentMarket::deleteOrders(uint32_t symbol_id, OrderSide side, Price min_price, Price max_price)
+{
+    submitSymbolTask(
+        symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->deleteOrders(symbol_id, side, min_price, max_price); });
+}
+
+void ConcurrentMarket::deleteOwnerOrders(uint32_t owner_id)
+{
+    submitBroadcastTask([=](OrderBookHandler *orderbook_handler) { orderbook_handler->deleteOwnerOrders(owner_id); });
+}
+
+void ConcurrentMarket::expireOrders()
+{
+    submitBroadcastTask([=](OrderBookHandler *orderbook_handler) { orderbook_handler->expireOrders(); });
+}
+
+void ConcurrentMarket::deleteDayOrders()
+{
+    submitBroadcastTask([=](OrderBookHandler *orderbook_handler) { orderbook_handler->deleteDayOrders(); });
+}
+
+void ConcurrentMarket::cancelOrder(uint32_t symbol_id, uint64_t order_id, Quantity cancelled_quantity)
+{
+    submitSymbolTask(
+        symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->cancelOrder(symbol_id, order_id, cancelled_quantity); });
+}
+
+void ConcurrentMarket::replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, Price new_price)
+{
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) {
+        orderbook_handler->replaceOrder(symbol_id, order_id, new_order_id, new_price);
+    });
 }
 
-void ConcurrentMarket::cancelOrder(uint32_t symbol_id, uint64_t order_id, uint64_t cancelled_quantity)
+void ConcurrentMarket::amendOrder(uint32_t symbol_id, uint64_t order_id, Quantity new_quantity, Price new_price)
 {
-    uint32_t submission_index = getSubmissionIndex(symbol_id);
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) {
+        orderbook_handler->amendOrder(symbol_id, order_id, new_quantity, new_price);
+    });
+}
+
+void ConcurrentMarket::setSelfTradePrevention(uint32_t symbol_id, SelfTradePrevention mode)
+{
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->setSelfTradePrevention(symbol_id, mode); });
+}
+
+void ConcurrentMarket::setAllocationPolicy(uint32_t symbol_id, AllocationPolicy policy)
+{
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->setAllocationPolicy(symbol_id, policy); });
+}
+
+void ConcurrentMarket::haltSymbol(uint32_t symbol_id)
+{
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->haltSymbol(symbol_id); });
+}
+
+void ConcurrentMarket::resumeSymbol(uint32_t symbol_id)
+{
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->resumeSymbol(symbol_id); });
+}
+
+void ConcurrentMarket::setPriceBand(uint32_t symbol_id, uint32_t band_bps, Price reference_price)
+{
+    submitSymbolTask(
+        symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->setPriceBand(symbol_id, band_bps, reference_price); });
+}
+
+void ConcurrentMarket::setBarInterval(uint32_t symbol_id, uint64_t bar_interval)
+{
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->setBarInterval(symbol_id, bar_interval); });
+}
+
+void ConcurrentMarket::closeBars()
+{
+    submitBroadcastTask([=](OrderBookHandler *orderbook_handler) { orderbook_handler->closeBars(); });
+}
+
+void ConcurrentMarket::haltMarket()
+{
+    submitBroadcastTask([=](OrderBookHandler *orderbook_handler) { orderbook_handler->haltMarket(); });
+}
+
+void ConcurrentMarket::resumeMarket()
+{
+    submitBroadcastTask([=](OrderBookHandler *orderbook_handler) { orderbook_handler->resumeMarket(); });
+}
+
+void ConcurrentMarket::setRiskCheck(std::shared_ptr<RiskCheck> risk_check)
+{
+    submitBroadcastTask([=](OrderBookHandler *orderbook_handler) { orderbook_handler->setRiskCheck(risk_check); });
+}
+
+void ConcurrentMarket::startAuction(uint32_t symbol_id)
+{
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->startAuction(symbol_id); });
+}
+
+void ConcurrentMarket::uncrossAuction(uint32_t symbol_id)
+{
+    submitSymbolTask(symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->uncrossAuction(symbol_id); });
+}
+
+void ConcurrentMarket::executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity, Price price)
+{
+    submitSymbolTask(
+        symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->executeOrder(symbol_id, order_id, quantity, price); });
+}
+
+void ConcurrentMarket::executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity)
+{
+    submitSymbolTask(
+        symbol_id, [=](OrderBookHandler *orderbook_handler) { orderbook_handler->executeOrder(symbol_id, order_id, quantity); });
+}
+
+std::future<BestBidOffer> ConcurrentMarket::queryBestBidOffer(uint32_t symbol_id)
+{
+    uint32_t submission_index = submissionIndex(symbol_id);
     OrderBookHandler *orderbook_handler = orderbook_handlers[submission_index].get();
-    thread_pool.submitTask(submission_index, [=] { orderbook_handler->cancelOrder(symbol_id, order_id, cancelled_quantity); });
+    return thread_pool.submitWaitableTask(submission_index, [=] { return orderbook_handler->bestBidOffer(symbol_id); });
 }
 
-void ConcurrentMarket::replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, uint64_t new_price)
+std::future<BookDepth> ConcurrentMarket::queryDepth(uint32_t symbol_id, size_t max_levels)
 {
-    uint32_t submission_index = getSubmissionIndex(symbol_id);
+    uint32_t submission_index = submissionIndex(symbol_id);
     OrderBookHandler *orderbook_handler = orderbook_handlers[submission_index].get();
-    thread_pool.submitTask(submission_index, [=] { orderbook_handler->replaceOrder(symbol_id, order_id, new_order_id, new_price); });
+    return thread_pool.submitWaitableTask(submission_index, [=] { return orderbook_handler->depth(symbol_id, max_levels); });
 }
 
-void ConcurrentMarket::executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity, uint64_t price)
+std::future<std::optional<Order>> ConcurrentMarket::queryOrder(uint32_t symbol_id, uint64_t order_id)
 {
-    uint32_t submission_index = getSubmissionIndex(symbol_id);
+    uint32_t submission_index = submissionIndex(symbol_id);
     OrderBookHandler *orderbook_handler = orderbook_handlers[submission_index].get();
-    thread_pool.submitTask(submission_index, [=] { orderbook_handler->executeOrder(symbol_id, order_id, quantity, price); });
+    return thread_pool.submitWaitableTask(submission_index, [=] { return orderbook_handler->findOrder(symbol_id, order_id); });
 }
 
-void ConcurrentMarket::executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity)
+std::future<SymbolStatistics> ConcurrentMarket::queryStatistics(uint32_t symbol_id)
 {
-    uint32_t submission_index = getSubmissionIndex(symbol_id);
+    uint32_t submission_index = submissionIndex(symbol_id);
     OrderBookHandler *orderbook_handler = orderbook_handlers[submission_index].get();
-    thread_pool.submitTask(submission_index, [=] { orderbook_handler->executeOrder(symbol_id, order_id, quantity); });
+    return thread_pool.submitWaitableTask(submission_index, [=] { return orderbook_handler->statistics(symbol_id); });
 }
 
-uint32_t ConcurrentMarket::getSubmissionIndex(uint32_t symbol_id)
+std::future<std::vector<BestBidOffer>> ConcurrentMarket::queryBestBidOffers(const std::vector<uint32_t> &symbol_ids)
 {
-    auto it = id_to_submission_index.find(symbol_id);
-    return it == id_to_submission_index.end() ? 0 : it->second;
+    auto results_promise = std::make_shared<std::promise<std::vector<BestBidOffer>>>();
+    std::future<std::vector<BestBidOffer>> results_future = results_promise->get_future();
+    queryBestBidOffers(symbol_ids, [=](std::vector<BestBidOffer> results) { results_promise->set_value(std::move(results)); });
+    return results_future;
+}
+
+void ConcurrentMarket::queryBestBidOffers(
+    const std::vector<uint32_t> &symbol_ids, std::function<void(std::vector<BestBidOffer>)> callback)
+{
+    submitBatchQuery<BestBidOffer>(
+        symbol_ids, [](OrderBookHandler *orderbook_handler, uint32_t symbol_id) { return orderbook_handler->bestBidOffer(symbol_id); },
+        std::move(callback));
+}
+
+std::future<std::vector<SymbolStatistics>> ConcurrentMarket::queryStatistics(const std::vector<uint32_t> &symbol_ids)
+{
+    auto results_promise = std::make_shared<std::promise<std::vector<SymbolStatistics>>>();
+    std::future<std::vector<SymbolStatistics>> results_future = results_promise->get_future();
+    queryStatistics(symbol_ids, [=](std::vector<SymbolStatistics> results) { results_promise->set_value(std::move(results)); });
+    return results_future;
+}
+
+void ConcurrentMarket::queryStatistics(
+    const std::vector<uint32_t> &symbol_ids, std::function<void(std::vector<SymbolStatistics>)> callback)
+{
+    submitBatchQuery<SymbolStatistics>(
+        symbol_ids, [](OrderBookHandler *orderbook_handler, uint32_t symbol_id) { return orderbook_handler->statistics(symbol_id); },
+        std::move(callback));
+}
+
+uint64_t ConcurrentMarket::sequenceWatermark() const
+{
+    // The sequence number must be read first. A command with a sequence number at or below it has
+    // either been counted as submitted to its worker or is still marked as being queued, since the
+    // worker is marked before the sequence number is taken and unmarked after it is counted.
+    uint64_t watermark = sequence_number.load();
+    for (uint32_t i = 0; i < orderbook_handlers.size(); ++i)
+    {
+        const WorkerSequence &worker_sequence = worker_sequences[i];
+        bool queuing = worker_sequence.queuing.load();
+        uint64_t submitted = worker_sequence.submitted.load();
+        uint64_t completed = worker_sequence.completed.load(std::memory_order_acquire);
+        // A command that is being queued has a greater sequence number than every command the worker has applied.
+        // Otherwise, a worker that has caught up cannot emit any more events at or below the sequence number.
+        if (queuing || completed < submitted)
+            watermark = std::min(watermark, completed);
+    }
+    return watermark;
+}
+
+uint32_t ConcurrentMarket::submissionIndex(uint32_t symbol_id) const
+{
+    uint32_t submission_index = symbol_routes.find(symbol_id);
+    if (submission_index == SymbolRoutingTable::unknown_symbol)
+        submission_index = symbol_id % orderbook_handlers.size();
+    return submission_index;
+}
+
+void ConcurrentMarket::beginCommand(OrderBookHandler *orderbook_handler, uint64_t command_sequence_number)
+{
+    orderbook_handler->setSequenceNumber(command_sequence_number);
 }
 
 void ConcurrentMarket::updateSymbolSubmissionIndex()
@@ -90,15 +282,24 @@ void ConcurrentMarket::updateSymbolSubmissionIndex()
 
 std::string ConcurrentMarket::toString()
 {
-    std::string market_string;
-    std::vector<std::future<std::string>> futures(orderbook_handlers.size());
-    for (uint32_t i = 0; i < futures.size(); ++i)
+    std::vector<std::future<std::vector<BookSnapshot>>> snapshot_futures(orderbook_handlers.size());
+    for (uint32_t i = 0; i < snapshot_futures.size(); ++i)
     {
         OrderBookHandler *orderbook_handler = orderbook_handlers[i].get();
-        futures[i] = thread_pool.submitWaitableTask(i, [=] { return orderbook_handler->toString(); });
+        snapshot_futures[i] = thread_pool.submitWaitableTask(i, [=] { return orderbook_handler->snapshot(); });
+    }
+    // Format each book as soon as its worker has taken the snapshot, so that the books of idle
+    // workers are formatted while waiting on busy ones.
+    std::vector<std::future<std::string>> string_futures;
+    for (auto &snapshot_future : snapshot_futures)
+    {
+        auto book_snapshots = std::make_shared<std::vector<BookSnapshot>>(snapshot_future.get());
+        for (size_t j = 0; j < book_snapshots->size(); ++j)
+            string_futures.push_back(background_pool.submitTask([=] { return (*book_snapshots)[j].toString() + "\n"; }));
     }
-    for (auto &future : futures)
-        market_string += future.get();
+    std::string market_string;
+    for (auto &string_future : string_futures)
+        market_string += string_future.get();
     return market_string;
 }
 
@@ -109,6 +310,23 @@ void ConcurrentMarket::dumpMarket(const std::string &name)
     file.close();
 }
 
+void ConcurrentMarket::dumpMarketBinary(const std::string &name)
+{
+    BookDumpWriter writer{name};
+    std::vector<std::future<std::vector<BookSnapshot>>> snapshot_futures(orderbook_handlers.size());
+    for (uint32_t i = 0; i < snapshot_futures.size(); ++i)
+    {
+        OrderBookHandler *orderbook_handler = orderbook_handlers[i].get();
+        snapshot_futures[i] = thread_pool.submitWaitableTask(i, [=] { return orderbook_handler->snapshot(); });
+    }
+    for (auto &snapshot_future : snapshot_futures)
+    {
+        for (const auto &book_snapshot : snapshot_future.get())
+            writer.write(book_snapshot);
+    }
+    writer.flush();
+}
+
 std::ostream &operator<<(std::ostream &os, ConcurrentMarket &concurrent_market)
 {
     os << concurrent_market.toString();
@@ -2,80 +2,351 @@
 #include "map_orderbook.h"
 
 namespace RapidTrader {
-OrderBookHandler::OrderBookHandler(std::unique_ptr<EventHandler> event_handler_)
-    : event_handler(std::move(event_handler_))
+OrderBookHandler::OrderBookHandler(std::unique_ptr<EventHandler> event_handler_, std::shared_ptr<Clock> clock_)
+    : clock(std::move(clock_))
+    , market_halted(false)
+    , event_handler(std::move(event_handler_))
 {}
 
-void OrderBookHandler::addOrderBook(uint32_t symbol_id, std::string symbol_name)
+void OrderBookHandler::addOrderBook(uint32_t symbol_id, std::string symbol_name, size_t max_orders, size_t max_levels)
 {
     auto it = id_to_book.find(symbol_id);
     assert(it == id_to_book.end() && "Symbol already exists!");
-    id_to_book.insert({symbol_id, std::make_unique<MapOrderBook>(symbol_id, *event_handler)});
-    event_handler->handleSymbolAdded(SymbolAdded{symbol_id, std::move(symbol_name)});
+    auto book = std::make_unique<MapOrderBook>(symbol_id, *event_handler, *clock, max_orders, max_levels);
+    book->setRiskCheck(risk_check.get());
+    id_to_book.insert({symbol_id, std::move(book)});
+    event_handler->handleSymbolAdded(event_handler->stamp(SymbolAdded{symbol_id, std::move(symbol_name)}));
 }
 
 void OrderBookHandler::deleteOrderBook(uint32_t symbol_id, std::string symbol_name)
 {
     auto it = id_to_book.find(symbol_id);
     assert(it != id_to_book.end() && "Symbol does not exist!");
+    // The orders of the book leave the market along with it.
+    it->second->setRiskCheck(nullptr);
     id_to_book.erase(it);
-    event_handler->handleSymbolDeleted(SymbolDeleted{symbol_id, std::move(symbol_name)});
+    event_handler->handleSymbolDeleted(event_handler->stamp(SymbolDeleted{symbol_id, std::move(symbol_name)}));
+}
+
+OrderBook *OrderBookHandler::findBook(uint32_t symbol_id) const
+{
+    auto it = id_to_book.find(symbol_id);
+    return it == id_to_book.end() ? nullptr : it->second.get();
 }
 
 void OrderBookHandler::addOrder(const Order &order)
 {
+    if (market_halted)
+    {
+        event_handler->handleOrderRejected(event_handler->stamp(OrderRejected{order, RejectReason::Halted}));
+        return;
+    }
     auto it = id_to_book.find(order.getSymbolID());
-    assert(it != id_to_book.end() && "Symbol does not exist!");
-    OrderBook *book = it->second.get();
-    book->addOrder(order);
+    if (it == id_to_book.end())
+    {
+        event_handler->handleOrderRejected(event_handler->stamp(OrderRejected{order, RejectReason::UnknownSymbol}));
+        return;
+    }
+    it->second->addOrder(order);
 }
 
 void OrderBookHandler::deleteOrder(uint32_t symbol_id, uint64_t order_id)
 {
-    auto it = id_to_book.find(symbol_id);
-    assert(it != id_to_book.end() && "Symbol does not exist!");
-    OrderBook *book = it->second.get();
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
     book->deleteOrder(order_id);
 }
 
-void OrderBookHandler::cancelOrder(uint32_t symbol_id, uint64_t order_id, uint64_t cancelled_quantity)
+void OrderBookHandler::deleteOrders(uint32_t symbol_id)
 {
-    auto it = id_to_book.find(symbol_id);
-    assert(it != id_to_book.end() && "Symbol does not exist!");
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    book->deleteOrders();
+}
+
+void OrderBookHandler::deleteOrders(uint32_t symbol_id, OrderSide side)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    book->deleteOrders(side);
+}
+
+void OrderBookHandler::deleteOrders(uint32_t symbol_id, OrderSide side, Price min_price, Price max_price)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    assert(max_price >= min_price && "Max price must be at least min price!");
+    book->deleteOrders(side, min_price, max_price);
+}
+
+void OrderBookHandler::deleteOwnerOrders(uint32_t owner_id)
+{
+    assert(owner_id > 0 && "Owner ID must be positive!");
+    for (auto &[symbol_id, book] : id_to_book)
+        book->deleteOwnerOrders(owner_id);
+}
+
+void OrderBookHandler::expireOrders()
+{
+    for (auto &[symbol_id, book] : id_to_book)
+        book->expireOrders();
+}
+
+void OrderBookHandler::deleteDayOrders()
+{
+    for (auto &[symbol_id, book] : id_to_book)
+        book->deleteDayOrders();
+}
+
+void OrderBookHandler::cancelOrder(uint32_t symbol_id, uint64_t order_id, Quantity cancelled_quantity)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
     assert(cancelled_quantity > 0 && "Cancelled quantity must be positive!");
-    OrderBook *book = it->second.get();
     book->cancelOrder(order_id, cancelled_quantity);
 }
 
-void OrderBookHandler::replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, uint64_t new_price)
+void OrderBookHandler::replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, Price new_price)
 {
-    auto it = id_to_book.find(symbol_id);
-    assert(it != id_to_book.end() && "Symbol does not exist!");
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
     assert(new_order_id > 0 && "Order ID must be positive!");
     assert(new_price > 0 && "Price must be positive!");
-    OrderBook *book = it->second.get();
+    if (market_halted)
+    {
+        Order new_order = book->getOrder(order_id);
+        new_order.setOrderID(new_order_id);
+        new_order.setPrice(new_price);
+        event_handler->handleOrderRejected(event_handler->stamp(OrderRejected{new_order, RejectReason::Halted}));
+        return;
+    }
     book->replaceOrder(order_id, new_order_id, new_price);
 }
 
-void OrderBookHandler::executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity, uint64_t price)
+void OrderBookHandler::amendOrder(uint32_t symbol_id, uint64_t order_id, Quantity new_quantity, Price new_price)
 {
-    auto it = id_to_book.find(symbol_id);
-    assert(it != id_to_book.end() && "Symbol does not exist!");
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    assert(new_quantity > 0 && "Quantity must be positive!");
+    if (market_halted)
+    {
+        Order amended_order = book->getOrder(order_id);
+        amended_order.setOpenQuantity(new_quantity);
+        amended_order.setPrice(new_price);
+        event_handler->handleOrderRejected(event_handler->stamp(OrderRejected{amended_order, RejectReason::Halted}));
+        return;
+    }
+    book->amendOrder(order_id, new_quantity, new_price);
+}
+
+void OrderBookHandler::setSelfTradePrevention(uint32_t symbol_id, SelfTradePrevention mode)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    book->setSelfTradePrevention(mode);
+}
+
+void OrderBookHandler::setAllocationPolicy(uint32_t symbol_id, AllocationPolicy policy)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    book->setAllocationPolicy(policy);
+}
+
+void OrderBookHandler::haltSymbol(uint32_t symbol_id)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    book->halt();
+}
+
+void OrderBookHandler::resumeSymbol(uint32_t symbol_id)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    book->resume();
+}
+
+void OrderBookHandler::setPriceBand(uint32_t symbol_id, uint32_t band_bps, Price reference_price)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    book->setPriceBand(band_bps, reference_price);
+}
+
+void OrderBookHandler::setBarInterval(uint32_t symbol_id, uint64_t bar_interval)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    book->setBarInterval(bar_interval);
+}
+
+void OrderBookHandler::closeBars()
+{
+    for (auto &[symbol_id, book] : id_to_book)
+        book->closeBars();
+}
+
+void OrderBookHandler::haltMarket()
+{
+    market_halted = true;
+}
+
+void OrderBookHandler::resumeMarket()
+{
+    market_halted = false;
+}
+
+void OrderBookHandler::setRiskCheck(std::shared_ptr<RiskCheck> risk_check_)
+{
+    // The books release their orders from the previous risk stage, so it must outlive the switch.
+    std::swap(risk_check, risk_check_);
+    for (auto &[symbol_id, book] : id_to_book)
+        book->setRiskCheck(risk_check.get());
+}
+
+void OrderBookHandler::startAuction(uint32_t symbol_id)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    book->startAuction();
+}
+
+void OrderBookHandler::uncrossAuction(uint32_t symbol_id)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
+    book->uncrossAuction();
+}
+
+void OrderBookHandler::executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity, Price price)
+{
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
     assert(quantity > 0 && "Quantity must be positive!");
     assert(price > 0 && "Price must be positive!");
-    OrderBook *book = it->second.get();
     book->executeOrder(order_id, quantity, price);
 }
-void OrderBookHandler::executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity)
+void OrderBookHandler::executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity)
 {
-    auto it = id_to_book.find(symbol_id);
-    assert(it != id_to_book.end() && "Symbol does not exist!");
+    OrderBook *book = findBook(symbol_id);
+    if (!book)
+        return;
     assert(order_id > 0 && "Order ID must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    OrderBook *book = it->second.get();
     book->executeOrder(order_id, quantity);
 }
 
+Volume OrderBookHandler::bidVolumeAtOrAbove(uint32_t symbol_id, Price price) const
+{
+    const OrderBook *book = findBook(symbol_id);
+    return book ? book->bidVolumeAtOrAbove(price) : 0;
+}
+
+Volume OrderBookHandler::askVolumeAtOrBelow(uint32_t symbol_id, Price price) const
+{
+    const OrderBook *book = findBook(symbol_id);
+    return book ? book->askVolumeAtOrBelow(price) : 0;
+}
+
+uint64_t OrderBookHandler::numberOfGrowthEvents(uint32_t symbol_id) const
+{
+    const OrderBook *book = findBook(symbol_id);
+    return book ? book->numberOfGrowthEvents() : 0;
+}
+
+Price OrderBookHandler::auctionPrice(uint32_t symbol_id) const
+{
+    const OrderBook *book = findBook(symbol_id);
+    return book ? book->auctionPrice() : 0;
+}
+
+BestBidOffer OrderBookHandler::bestBidOffer(uint32_t symbol_id) const
+{
+    auto it = id_to_book.find(symbol_id);
+    if (it == id_to_book.end())
+    {
+        BestBidOffer best_bid_offer;
+        best_bid_offer.symbol_id = symbol_id;
+        return best_bid_offer;
+    }
+    return it->second->bestBidOffer();
+}
+
+BookDepth OrderBookHandler::depth(uint32_t symbol_id, size_t max_levels) const
+{
+    auto it = id_to_book.find(symbol_id);
+    if (it == id_to_book.end())
+    {
+        BookDepth book_depth;
+        book_depth.symbol_id = symbol_id;
+        return book_depth;
+    }
+    return it->second->depth(max_levels);
+}
+
+std::optional<Order> OrderBookHandler::findOrder(uint32_t symbol_id, uint64_t order_id) const
+{
+    auto it = id_to_book.find(symbol_id);
+    if (it == id_to_book.end() || !it->second->hasOrder(order_id))
+        return std::nullopt;
+    return it->second->getOrder(order_id);
+}
+
+SymbolStatistics OrderBookHandler::statistics(uint32_t symbol_id) const
+{
+    auto it = id_to_book.find(symbol_id);
+    if (it == id_to_book.end())
+    {
+        SymbolStatistics symbol_statistics;
+        symbol_statistics.symbol_id = symbol_id;
+        return symbol_statistics;
+    }
+    return it->second->statistics();
+}
+
+std::vector<BookSnapshot> OrderBookHandler::snapshot() const
+{
+    std::vector<BookSnapshot> book_snapshots;
+    book_snapshots.reserve(id_to_book.size());
+    for (const auto &[symbol_id, book_ptr] : id_to_book)
+    {
+        if (book_ptr)
+            book_snapshots.push_back(book_ptr->snapshot());
+    }
+    return book_snapshots;
+}
+
+void OrderBookHandler::dump(BookDumpWriter &writer) const
+{
+    for (const auto &[symbol_id, book_ptr] : id_to_book)
+    {
+        if (book_ptr)
+            writer.write(book_ptr->snapshot());
+    }
+}
+
+void OrderBookHandler::setSequenceNumber(uint64_t sequence_number)
+{
+    event_handler->sequence_number = sequence_number;
+}
+
 std::string OrderBookHandler::toString()
 {
     std::string book_handler_string;
@@ -87,19 +358,66 @@ std::string OrderBookHandler::toString()
     return book_handler_string;
 }
 
-Market::Market(std::unique_ptr<EventHandler> event_handler)
-    : orderbook_handler(std::make_unique<OrderBookHandler>(std::move(event_handler)))
+/**
+ * A clock that reads the clock of the market once per command and reports that time until
+ * the next command, so that a command is published and applied at the same time.
+ */
+class Market::CommandClock : public Clock
+{
+public:
+    explicit CommandClock(std::shared_ptr<Clock> clock_)
+        : clock(std::move(clock_))
+        , time(0)
+        , pinned(false)
+    {}
+
+    [[nodiscard]] uint64_t now() const override
+    {
+        if (!pinned)
+        {
+            time = clock->now();
+            pinned = true;
+        }
+        return time;
+    }
+
+    /**
+     * Starts a new command, which is applied at the next time that is read from the clock of the market.
+     */
+    void nextCommand()
+    {
+        pinned = false;
+    }
+
+private:
+    std::shared_ptr<Clock> clock;
+    // The time of the command that is being applied, valid if pinned is true.
+    mutable uint64_t time;
+    mutable bool pinned;
+};
+
+Market::Market(std::unique_ptr<EventHandler> event_handler, std::shared_ptr<Clock> clock_)
+    : clock(std::make_shared<CommandClock>(std::move(clock_)))
+    , orderbook_handler(std::make_unique<OrderBookHandler>(std::move(event_handler), clock))
+    , command_listener(nullptr)
+    , sequence_number(0)
 {}
 
-void Market::addSymbol(uint32_t symbol_id, const std::string &symbol_name)
+void Market::addSymbol(uint32_t symbol_id, const std::string &symbol_name, size_t max_orders, size_t max_levels)
 {
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::addSymbol(symbol_id, symbol_name, max_orders, max_levels));
     id_to_symbol.insert({symbol_id, std::make_unique<Symbol>(symbol_id, symbol_name)});
-    orderbook_handler->addOrderBook(symbol_id, symbol_name);
+    orderbook_handler->addOrderBook(symbol_id, symbol_name, max_orders, max_levels);
 }
 
 void Market::deleteSymbol(uint32_t symbol_id)
 {
     auto it = id_to_symbol.find(symbol_id);
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::deleteSymbol(symbol_id, it->second->name));
     orderbook_handler->deleteOrderBook(symbol_id, it->second->name);
     id_to_symbol.erase(symbol_id);
 }
@@ -111,34 +429,358 @@ bool Market::hasSymbol(uint32_t symbol_id) const
 
 void Market::addOrder(const Order &order)
 {
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::addOrder(order));
     orderbook_handler->addOrder(order);
 }
 
 void Market::deleteOrder(uint32_t symbol_id, uint64_t order_id)
 {
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::deleteOrder(symbol_id, order_id));
     orderbook_handler->deleteOrder(symbol_id, order_id);
 }
 
-void Market::cancelOrder(uint32_t symbol_id, uint64_t order_id, uint64_t cancelled_quantity)
+void Market::deleteOrders(uint32_t symbol_id)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::deleteOrders(symbol_id));
+    orderbook_handler->deleteOrders(symbol_id);
+}
+
+void Market::deleteOrders(uint32_t symbol_id, OrderSide side)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::deleteOrders(symbol_id, side));
+    orderbook_handler->deleteOrders(symbol_id, side);
+}
+
+void Market::deleteOrders(uint32_t symbol_id, OrderSide side, Price min_price, Price max_price)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::deleteOrders(symbol_id, side, min_price, max_price));
+    orderbook_handler->deleteOrders(symbol_id, side, min_price, max_price);
+}
+
+void Market::deleteOwnerOrders(uint32_t owner_id)
 {
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::deleteOwnerOrders(owner_id));
+    orderbook_handler->deleteOwnerOrders(owner_id);
+}
+
+void Market::expireOrders()
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::make(CommandType::ExpireOrders));
+    orderbook_handler->expireOrders();
+}
+
+void Market::deleteDayOrders()
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::make(CommandType::DeleteDayOrders));
+    orderbook_handler->deleteDayOrders();
+}
+
+void Market::cancelOrder(uint32_t symbol_id, uint64_t order_id, Quantity cancelled_quantity)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::cancelOrder(symbol_id, order_id, cancelled_quantity));
     orderbook_handler->cancelOrder(symbol_id, order_id, cancelled_quantity);
 }
 
-void Market::replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, uint64_t new_price)
+void Market::replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, Price new_price)
 {
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::replaceOrder(symbol_id, order_id, new_order_id, new_price));
     orderbook_handler->replaceOrder(symbol_id, order_id, new_order_id, new_price);
 }
 
-void Market::executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity, uint64_t price)
+void Market::amendOrder(uint32_t symbol_id, uint64_t order_id, Quantity new_quantity, Price new_price)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::amendOrder(symbol_id, order_id, new_quantity, new_price));
+    orderbook_handler->amendOrder(symbol_id, order_id, new_quantity, new_price);
+}
+
+void Market::setSelfTradePrevention(uint32_t symbol_id, SelfTradePrevention mode)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::setSelfTradePrevention(symbol_id, mode));
+    orderbook_handler->setSelfTradePrevention(symbol_id, mode);
+}
+
+void Market::setAllocationPolicy(uint32_t symbol_id, AllocationPolicy policy)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::setAllocationPolicy(symbol_id, policy));
+    orderbook_handler->setAllocationPolicy(symbol_id, policy);
+}
+
+void Market::haltSymbol(uint32_t symbol_id)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::make(CommandType::HaltSymbol, symbol_id));
+    orderbook_handler->haltSymbol(symbol_id);
+}
+
+void Market::resumeSymbol(uint32_t symbol_id)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::make(CommandType::ResumeSymbol, symbol_id));
+    orderbook_handler->resumeSymbol(symbol_id);
+}
+
+void Market::setPriceBand(uint32_t symbol_id, uint32_t band_bps, Price reference_price)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::setPriceBand(symbol_id, band_bps, reference_price));
+    orderbook_handler->setPriceBand(symbol_id, band_bps, reference_price);
+}
+
+void Market::setBarInterval(uint32_t symbol_id, uint64_t bar_interval)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::setBarInterval(symbol_id, bar_interval));
+    orderbook_handler->setBarInterval(symbol_id, bar_interval);
+}
+
+void Market::closeBars()
 {
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::make(CommandType::CloseBars));
+    orderbook_handler->closeBars();
+}
+
+void Market::haltMarket()
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::make(CommandType::HaltMarket));
+    orderbook_handler->haltMarket();
+}
+
+void Market::resumeMarket()
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::make(CommandType::ResumeMarket));
+    orderbook_handler->resumeMarket();
+}
+
+void Market::setRiskCheck(std::shared_ptr<RiskCheck> risk_check)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::setRiskCheck(risk_check != nullptr));
+    orderbook_handler->setRiskCheck(std::move(risk_check));
+}
+
+void Market::startAuction(uint32_t symbol_id)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::make(CommandType::StartAuction, symbol_id));
+    orderbook_handler->startAuction(symbol_id);
+}
+
+void Market::uncrossAuction(uint32_t symbol_id)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::make(CommandType::UncrossAuction, symbol_id));
+    orderbook_handler->uncrossAuction(symbol_id);
+}
+
+void Market::executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity, Price price)
+{
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::executeOrder(symbol_id, order_id, quantity, price));
     orderbook_handler->executeOrder(symbol_id, order_id, quantity, price);
 }
 
-void Market::executeOrder(uint32_t symbol_id, uint64_t order_id, uint64_t quantity)
+void Market::executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity)
 {
+    sequenceCommand();
+    if (command_listener)
+        publish(Command::executeOrder(symbol_id, order_id, quantity));
     orderbook_handler->executeOrder(symbol_id, order_id, quantity);
 }
 
+void Market::applyCommand(const Command &command, const std::shared_ptr<RiskCheck> &risk_check)
+{
+    // Apply the command under the sequence number that it was stamped with.
+    if (command.sequence_number > 0)
+        sequence_number = command.sequence_number - 1;
+    switch (command.type)
+    {
+    case CommandType::AddSymbol:
+        addSymbol(command.symbol_id, command.symbol_name, command.max_orders, command.max_levels);
+        break;
+    case CommandType::DeleteSymbol:
+        deleteSymbol(command.symbol_id);
+        break;
+    case CommandType::AddOrder:
+        addOrder(command.order.toOrder());
+        break;
+    case CommandType::DeleteOrder:
+        deleteOrder(command.symbol_id, command.order_id);
+        break;
+    case CommandType::DeleteOrders:
+        deleteOrders(command.symbol_id);
+        break;
+    case CommandType::DeleteSideOrders:
+        deleteOrders(command.symbol_id, command.side);
+        break;
+    case CommandType::DeletePriceRangeOrders:
+        deleteOrders(command.symbol_id, command.side, command.price, command.max_price);
+        break;
+    case CommandType::DeleteOwnerOrders:
+        deleteOwnerOrders(command.owner_id);
+        break;
+    case CommandType::ExpireOrders:
+        expireOrders();
+        break;
+    case CommandType::DeleteDayOrders:
+        deleteDayOrders();
+        break;
+    case CommandType::CancelOrder:
+        cancelOrder(command.symbol_id, command.order_id, command.quantity);
+        break;
+    case CommandType::ReplaceOrder:
+        replaceOrder(command.symbol_id, command.order_id, command.new_order_id, command.price);
+        break;
+    case CommandType::AmendOrder:
+        amendOrder(command.symbol_id, command.order_id, command.quantity, command.price);
+        break;
+    case CommandType::ExecuteOrder:
+        executeOrder(command.symbol_id, command.order_id, command.quantity);
+        break;
+    case CommandType::ExecuteOrderAtPrice:
+        executeOrder(command.symbol_id, command.order_id, command.quantity, command.price);
+        break;
+    case CommandType::SetSelfTradePrevention:
+        setSelfTradePrevention(command.symbol_id, static_cast<SelfTradePrevention>(command.mode));
+        break;
+    case CommandType::SetAllocationPolicy:
+        setAllocationPolicy(command.symbol_id, static_cast<AllocationPolicy>(command.mode));
+        break;
+    case CommandType::StartAuction:
+        startAuction(command.symbol_id);
+        break;
+    case CommandType::UncrossAuction:
+        uncrossAuction(command.symbol_id);
+        break;
+    case CommandType::HaltSymbol:
+        haltSymbol(command.symbol_id);
+        break;
+    case CommandType::ResumeSymbol:
+        resumeSymbol(command.symbol_id);
+        break;
+    case CommandType::SetPriceBand:
+        setPriceBand(command.symbol_id, command.band_bps, command.price);
+        break;
+    case CommandType::HaltMarket:
+        haltMarket();
+        break;
+    case CommandType::ResumeMarket:
+        resumeMarket();
+        break;
+    case CommandType::SetBarInterval:
+        setBarInterval(command.symbol_id, command.bar_interval);
+        break;
+    case CommandType::CloseBars:
+        closeBars();
+        break;
+    case CommandType::SetRiskCheck:
+        assert((command.mode == 0 || risk_check) && "The command installs a risk stage but none was provided!");
+        setRiskCheck(command.mode != 0 ? risk_check : nullptr);
+        break;
+    case CommandType::Sync:
+    case CommandType::Stop:
+        assert(false && "Control commands cannot be applied to a market!");
+        break;
+    }
+}
+
+void Market::setCommandListener(CommandListener *listener)
+{
+    command_listener = listener;
+}
+
+void Market::sequenceCommand()
+{
+    clock->nextCommand();
+    orderbook_handler->setSequenceNumber(++sequence_number);
+}
+
+void Market::publish(Command command)
+{
+    command.sequence_number = sequence_number;
+    command.timestamp = clock->now();
+    command_listener->handleCommand(command);
+}
+
+Volume Market::bidVolumeAtOrAbove(uint32_t symbol_id, Price price) const
+{
+    return orderbook_handler->bidVolumeAtOrAbove(symbol_id, price);
+}
+
+Volume Market::askVolumeAtOrBelow(uint32_t symbol_id, Price price) const
+{
+    return orderbook_handler->askVolumeAtOrBelow(symbol_id, price);
+}
+
+uint64_t Market::numberOfGrowthEvents(uint32_t symbol_id) const
+{
+    return orderbook_handler->numberOfGrowthEvents(symbol_id);
+}
+
+Price Market::auctionPrice(uint32_t symbol_id) const
+{
+    return orderbook_handler->auctionPrice(symbol_id);
+}
+
+BestBidOffer Market::bestBidOffer(uint32_t symbol_id) const
+{
+    return orderbook_handler->bestBidOffer(symbol_id);
+}
+
+BookDepth Market::depth(uint32_t symbol_id, size_t max_levels) const
+{
+    return orderbook_handler->depth(symbol_id, max_levels);
+}
+
+std::optional<Order> Market::findOrder(uint32_t symbol_id, uint64_t order_id) const
+{
+    return orderbook_handler->findOrder(symbol_id, order_id);
+}
+
+SymbolStatistics Market::statistics(uint32_t symbol_id) const
+{
+    return orderbook_handler->statistics(symbol_id);
+}
+
 // LCOV_EXCL_START
 std::string Market::toString() const
 {
@@ -158,4 +800,11 @@ void Market::dumpMarket(const std::string &name) const
     file.close();
 }
 // LCOV_EXCL_END
+
+void Market::dumpMarketBinary(const std::string &name) const
+{
+    BookDumpWriter writer{name};
+    orderbook_handler->dump(writer);
+    writer.flush();
+}
 } // namespace RapidTrader
\ No newline at end of file
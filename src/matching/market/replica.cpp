@@ -0,0 +1,190 @@
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "market/replica.h"
+
+namespace RapidTrader {
+// The number of commands that the replica reads from the socket at a time.
+static constexpr size_t replica_read_commands = 64;
+
+/**
+ * A clock that reports the times at which the primary received the commands that are
+ * being replayed until it is switched to the system clock.
+ */
+class Replica::ReplayClock : public Clock
+{
+public:
+    [[nodiscard]] uint64_t now() const override
+    {
+        return live.load(std::memory_order_acquire) ? system_clock.now() : replay_clock.now();
+    }
+
+    void setTime(uint64_t time)
+    {
+        replay_clock.setTime(time);
+    }
+
+    void goLive()
+    {
+        live.store(true, std::memory_order_release);
+    }
+
+private:
+    ManualClock replay_clock;
+    SystemClock system_clock;
+    std::atomic_bool live{false};
+};
+
+ReplicaPublisher::ReplicaPublisher(int socket_fd_, ReplicationMode mode_, size_t queue_capacity)
+    : socket_fd(socket_fd_)
+    , mode(mode_)
+    , queue(queue_capacity)
+    , published_commands(0)
+    , sent_commands(0)
+    , dropped_commands(0)
+    , published_sequence(0)
+    , sent_sequence(0)
+    , running(true)
+{
+    if (mode == ReplicationMode::Async)
+        sender = std::thread(&ReplicaPublisher::sendCommands, this);
+}
+
+ReplicaPublisher::~ReplicaPublisher()
+{
+    running.store(false, std::memory_order_release);
+    if (sender.joinable())
+        sender.join();
+    if (socket_fd >= 0)
+        close(socket_fd);
+}
+
+void ReplicaPublisher::handleCommand(const Command &command)
+{
+    published_sequence.store(command.sequence_number, std::memory_order_release);
+    published_commands.fetch_add(1, std::memory_order_acq_rel);
+    if (mode == ReplicationMode::Sync)
+        send(command);
+    else if (!queue.tryPush(command))
+        dropped_commands.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void ReplicaPublisher::flush() const
+{
+    while (backlog() > 0)
+        std::this_thread::yield();
+}
+
+uint64_t ReplicaPublisher::backlog() const
+{
+    uint64_t published = published_commands.load(std::memory_order_acquire);
+    return published - sent_commands.load(std::memory_order_acquire) - dropped_commands.load(std::memory_order_acquire);
+}
+
+void ReplicaPublisher::send(const Command &command)
+{
+    const char *data = reinterpret_cast<const char *>(&command);
+    size_t remaining = sizeof(Command);
+    while (socket_fd >= 0 && remaining > 0)
+    {
+        ssize_t written = ::send(socket_fd, data, remaining, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+        {
+            // The replica has disconnected.
+            close(socket_fd);
+            socket_fd = -1;
+            break;
+        }
+        data += written;
+        remaining -= written;
+    }
+    if (remaining > 0)
+    {
+        dropped_commands.fetch_add(1, std::memory_order_acq_rel);
+        return;
+    }
+    sent_sequence.store(command.sequence_number, std::memory_order_release);
+    sent_commands.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void ReplicaPublisher::sendCommands()
+{
+    Command command{};
+    while (true)
+    {
+        if (queue.tryPop(command))
+            send(command);
+        else if (!running.load(std::memory_order_acquire))
+            break;
+        else
+            std::this_thread::yield();
+    }
+}
+
+Replica::Replica(int socket_fd_, std::unique_ptr<EventHandler> event_handler, std::shared_ptr<RiskCheck> risk_check_)
+    : socket_fd(socket_fd_)
+    , clock(std::make_shared<ReplayClock>())
+    , risk_check(std::move(risk_check_))
+    , market(std::make_unique<Market>(std::move(event_handler), clock))
+    , buffer(replica_read_commands * sizeof(Command))
+    , buffered(0)
+    , applied_sequence(0)
+    , lag_nanoseconds(0)
+    , gap(false)
+{}
+
+Replica::~Replica()
+{
+    if (socket_fd >= 0)
+        close(socket_fd);
+}
+
+size_t Replica::poll()
+{
+    assert(market && "The replica has been promoted!");
+    size_t num_applied = 0;
+    SystemClock system_clock;
+    while (socket_fd >= 0)
+    {
+        ssize_t received = recv(socket_fd, buffer.data() + buffered, buffer.size() - buffered, MSG_DONTWAIT);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            break;
+        buffered += received;
+        size_t offset = 0;
+        for (; buffered - offset >= sizeof(Command); offset += sizeof(Command))
+        {
+            Command command;
+            std::memcpy(&command, buffer.data() + offset, sizeof(Command));
+            gap = gap || command.sequence_number != applied_sequence + 1;
+            if (gap)
+                continue;
+            clock->setTime(command.timestamp);
+            market->applyCommand(command, risk_check);
+            applied_sequence = command.sequence_number;
+            uint64_t now = system_clock.now();
+            lag_nanoseconds = now > command.timestamp ? now - command.timestamp : 0;
+            ++num_applied;
+        }
+        // Keep any partially received command for the next read.
+        std::memmove(buffer.data(), buffer.data() + offset, buffered - offset);
+        buffered -= offset;
+    }
+    return num_applied;
+}
+
+std::unique_ptr<Market> Replica::promote()
+{
+    poll();
+    if (socket_fd >= 0)
+        close(socket_fd);
+    socket_fd = -1;
+    clock->goLive();
+    return std::move(market);
+}
+} // namespace RapidTrader
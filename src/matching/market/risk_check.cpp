@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cassert>
+#include "market/risk_check.h"
+
+namespace RapidTrader {
+AccountRiskCheck::AccountRiskCheck(size_t max_accounts, uint64_t window_duration_)
+    : accounts(max_accounts)
+    , window_duration(window_duration_)
+{
+    assert(window_duration > 0 && "Rate window duration must be positive!");
+}
+
+void AccountRiskCheck::setLimits(uint32_t owner_id, const RiskLimits &limits)
+{
+    assert(owner_id > 0 && owner_id < accounts.size() && "Account does not exist!");
+    AccountLock lock{accounts[owner_id]};
+    accounts[owner_id].limits = limits;
+}
+
+int64_t AccountRiskCheck::getPosition(uint32_t owner_id) const
+{
+    assert(owner_id > 0 && owner_id < accounts.size() && "Account does not exist!");
+    AccountLock lock{accounts[owner_id]};
+    return accounts[owner_id].position;
+}
+
+uint64_t AccountRiskCheck::getOpenQuantity(uint32_t owner_id, OrderSide side) const
+{
+    assert(owner_id > 0 && owner_id < accounts.size() && "Account does not exist!");
+    const Account &account = accounts[owner_id];
+    AccountLock lock{account};
+    return side == OrderSide::Bid ? account.open_bid_quantity : account.open_ask_quantity;
+}
+
+bool AccountRiskCheck::rejectOrder(
+    const Order &order, Quantity replaced_quantity, Price reference_price, const Clock &clock, RejectReason &reason)
+{
+    uint32_t owner_id = order.getOwnerID();
+    if (owner_id == 0)
+        return false;
+    if (owner_id >= accounts.size())
+    {
+        reason = RejectReason::UnknownAccount;
+        return true;
+    }
+    Account &account = accounts[owner_id];
+    AccountLock lock{account};
+    const RiskLimits &limits = account.limits;
+    uint64_t &open_quantity = openQuantity(account, order.getSide());
+    // The quantity that the account would have open on the side of the order if it is accepted.
+    uint64_t new_open_quantity = open_quantity - std::min<uint64_t>(open_quantity, replaced_quantity) + order.getOpenQuantity();
+    // The position that the account would hold if all of its open orders on the side were executed.
+    auto exposure = static_cast<int64_t>(new_open_quantity);
+    int64_t position = order.isBid() ? account.position + exposure : account.position - exposure;
+    if (limits.max_position != 0 && static_cast<uint64_t>(position < 0 ? -position : position) > limits.max_position)
+    {
+        reason = RejectReason::PositionLimit;
+        return true;
+    }
+    if (limits.max_order_notional != 0)
+    {
+        // Market orders do not have a price, so they are valued at the reference price of the book.
+        Price price = order.getPrice() != 0 ? order.getPrice() : order.getStopPrice() != 0 ? order.getStopPrice() : reference_price;
+        // Compared by division, since the notional value of an order may not fit in a price or a quantity.
+        if (price == 0 || order.getOpenQuantity() > limits.max_order_notional / price)
+        {
+            reason = RejectReason::NotionalLimit;
+            return true;
+        }
+    }
+    if (limits.max_orders_per_window != 0)
+    {
+        uint64_t now = clock.now();
+        if (now - account.window_start >= window_duration)
+        {
+            account.window_start = now;
+            account.orders_in_window = 0;
+        }
+        if (account.orders_in_window == limits.max_orders_per_window)
+        {
+            reason = RejectReason::OrderRateLimit;
+            return true;
+        }
+        ++account.orders_in_window;
+    }
+    open_quantity = new_open_quantity;
+    return false;
+}
+
+void AccountRiskCheck::orderAccepted(const Order &order)
+{
+    uint32_t owner_id = order.getOwnerID();
+    if (owner_id == 0 || owner_id >= accounts.size())
+        return;
+    Account &account = accounts[owner_id];
+    AccountLock lock{account};
+    openQuantity(account, order.getSide()) += order.getOpenQuantity();
+}
+
+void AccountRiskCheck::orderExecuted(const Order &order)
+{
+    uint32_t owner_id = order.getOwnerID();
+    if (owner_id == 0 || owner_id >= accounts.size())
+        return;
+    Account &account = accounts[owner_id];
+    AccountLock lock{account};
+    Quantity quantity = order.getLastExecutedQuantity();
+    account.position += order.isBid() ? static_cast<int64_t>(quantity) : -static_cast<int64_t>(quantity);
+    uint64_t &open_quantity = openQuantity(account, order.getSide());
+    open_quantity -= std::min<uint64_t>(open_quantity, quantity);
+}
+
+void AccountRiskCheck::orderReleased(const Order &order, Quantity quantity)
+{
+    uint32_t owner_id = order.getOwnerID();
+    if (owner_id == 0 || owner_id >= accounts.size())
+        return;
+    Account &account = accounts[owner_id];
+    AccountLock lock{account};
+    uint64_t &open_quantity = openQuantity(account, order.getSide());
+    open_quantity -= std::min<uint64_t>(open_quantity, quantity);
+}
+
+AccountRiskCheck::AccountLock::AccountLock(const Account &account_)
+    : account(account_)
+{
+    while (account.locked.exchange(true, std::memory_order_acquire))
+    {
+        // Wait without writing to the cache line until the lock looks free.
+        while (account.locked.load(std::memory_order_relaxed))
+            ;
+    }
+}
+
+AccountRiskCheck::AccountLock::~AccountLock()
+{
+    account.locked.store(false, std::memory_order_release);
+}
+} // namespace RapidTrader
@@ -0,0 +1,195 @@
+#include "market/sequenced_event_merger.h"
+#include "event_handler/event_handler.h"
+
+namespace RapidTrader {
+/**
+ * Sends a copy of each event of a worker thread to the merger.
+ */
+class SequencedEventMerger::WorkerEventHandler : public EventHandler
+{
+public:
+    explicit WorkerEventHandler(MpscQueue<SequencedEvent> &events_)
+        : events(events_)
+    {}
+
+protected:
+    void handleOrderAdded(const OrderAdded &event) override
+    {
+        events.push(event);
+    }
+
+    void handleOrderDeleted(const OrderDeleted &event) override
+    {
+        events.push(event);
+    }
+
+    void handleOrdersDeleted(const OrdersDeleted &event) override
+    {
+        events.push(event);
+    }
+
+    void handleOrdersExecuted(const OrdersExecuted &event) override
+    {
+        events.push(event);
+    }
+
+    void handleOrderUpdated(const OrderUpdated &event) override
+    {
+        events.push(event);
+    }
+
+    void handleOrderExecuted(const ExecutedOrder &event) override
+    {
+        events.push(event);
+    }
+
+    void handleTrade(const Trade &event) override
+    {
+        events.push(event);
+    }
+
+    void handleOrderRejected(const OrderRejected &event) override
+    {
+        events.push(event);
+    }
+
+    void handleSymbolAdded(const SymbolAdded &event) override
+    {
+        events.push(event);
+    }
+
+    void handleSymbolDeleted(const SymbolDeleted &event) override
+    {
+        events.push(event);
+    }
+
+    void handleTradeBar(const TradeBar &event) override
+    {
+        events.push(event);
+    }
+
+private:
+    // The queue that the events of the worker are sent to the merger through.
+    MpscQueue<SequencedEvent> &events;
+};
+
+/**
+ * @param event an event that was sent by a worker thread.
+ * @return the sequence number of the event.
+ */
+template<typename SequencedEvent>
+static uint64_t sequenceNumberOf(const SequencedEvent &event)
+{
+    return std::visit(
+        [](const auto &alternative) -> uint64_t {
+            if constexpr (std::is_same_v<std::decay_t<decltype(alternative)>, std::monostate>)
+                return 0;
+            else
+                return alternative.sequence_number;
+        },
+        event);
+}
+
+SequencedEventMerger::SequencedEventMerger(std::unique_ptr<EventHandler> event_handler_, uint32_t num_workers, size_t queue_capacity)
+    : event_handler(std::move(event_handler_))
+    , pending_events(num_workers)
+    , created_event_handlers(false)
+{
+    assert(num_workers > 0 && "The number of workers must be positive!");
+    worker_queues.reserve(num_workers);
+    for (uint32_t i = 0; i < num_workers; ++i)
+        worker_queues.push_back(std::make_unique<MpscQueue<SequencedEvent>>(queue_capacity));
+}
+
+SequencedEventMerger::~SequencedEventMerger() = default;
+
+std::vector<std::unique_ptr<EventHandler>> SequencedEventMerger::createEventHandlers()
+{
+    assert(!created_event_handlers && "The event handlers have already been created!");
+    created_event_handlers = true;
+    std::vector<std::unique_ptr<EventHandler>> event_handlers;
+    event_handlers.reserve(worker_queues.size());
+    for (auto &worker_queue : worker_queues)
+        event_handlers.push_back(std::make_unique<WorkerEventHandler>(*worker_queue));
+    return event_handlers;
+}
+
+size_t SequencedEventMerger::poll(const ConcurrentMarket &market)
+{
+    // The watermark must be read before the queues are drained, so that every event at or
+    // below it has already been sent to the merger.
+    uint64_t watermark = market.sequenceWatermark();
+    SequencedEvent event;
+    for (uint32_t i = 0; i < worker_queues.size(); ++i)
+    {
+        while (worker_queues[i]->tryPop(event))
+            pending_events[i].push_back(std::move(event));
+    }
+    size_t num_delivered = 0;
+    while (true)
+    {
+        // The events of each worker are in sequence order, so the next event is at the front of one of
+        // the workers. Ties are broken by the lowest worker index.
+        uint32_t next_worker = 0;
+        uint64_t next_sequence_number = 0;
+        bool found = false;
+        for (uint32_t i = 0; i < pending_events.size(); ++i)
+        {
+            if (pending_events[i].empty())
+                continue;
+            uint64_t sequence_number = sequenceNumberOf(pending_events[i].front());
+            if (sequence_number <= watermark && (!found || sequence_number < next_sequence_number))
+            {
+                next_worker = i;
+                next_sequence_number = sequence_number;
+                found = true;
+            }
+        }
+        if (!found)
+            break;
+        deliver(pending_events[next_worker].front());
+        pending_events[next_worker].pop_front();
+        ++num_delivered;
+    }
+    return num_delivered;
+}
+
+size_t SequencedEventMerger::pending() const
+{
+    size_t num_pending = 0;
+    for (const auto &events : pending_events)
+        num_pending += events.size();
+    return num_pending;
+}
+
+void SequencedEventMerger::deliver(const SequencedEvent &event)
+{
+    std::visit(
+        [this](const auto &alternative) {
+            using EventType = std::decay_t<decltype(alternative)>;
+            if constexpr (std::is_same_v<EventType, OrderAdded>)
+                event_handler->handleOrderAdded(alternative);
+            else if constexpr (std::is_same_v<EventType, OrderDeleted>)
+                event_handler->handleOrderDeleted(alternative);
+            else if constexpr (std::is_same_v<EventType, OrderUpdated>)
+                event_handler->handleOrderUpdated(alternative);
+            else if constexpr (std::is_same_v<EventType, ExecutedOrder>)
+                event_handler->handleOrderExecuted(alternative);
+            else if constexpr (std::is_same_v<EventType, Trade>)
+                event_handler->handleTrade(alternative);
+            else if constexpr (std::is_same_v<EventType, OrderRejected>)
+                event_handler->handleOrderRejected(alternative);
+            else if constexpr (std::is_same_v<EventType, OrdersDeleted>)
+                event_handler->handleOrdersDeleted(alternative);
+            else if constexpr (std::is_same_v<EventType, OrdersExecuted>)
+                event_handler->handleOrdersExecuted(alternative);
+            else if constexpr (std::is_same_v<EventType, SymbolAdded>)
+                event_handler->handleSymbolAdded(alternative);
+            else if constexpr (std::is_same_v<EventType, SymbolDeleted>)
+                event_handler->handleSymbolDeleted(alternative);
+            else if constexpr (std::is_same_v<EventType, TradeBar>)
+                event_handler->handleTradeBar(alternative);
+        },
+        event);
+}
+} // namespace RapidTrader
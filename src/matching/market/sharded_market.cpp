@@ -0,0 +1,479 @@
+#include <cassert>
+#include <csignal>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#    include <sys/prctl.h>
+#endif
+#include "market/sharded_market.h"
+#include "market/market.h"
+#include "event_handler/event_handler.h"
+
+namespace RapidTrader {
+/**
+ * Copies a symbol name into a fixed size buffer.
+ *
+ * @param destination the buffer to copy the name into, require that it is zero-initialized.
+ * @param symbol_name the name of the symbol, require that it fits in the buffer.
+ */
+template<size_t N>
+static void copySymbolName(char (&destination)[N], const std::string &symbol_name)
+{
+    assert(symbol_name.size() < N && "Symbol name is too long!");
+    symbol_name.copy(destination, N - 1);
+}
+
+/**
+ * Sends the events of the orderbooks of a shard to the router.
+ */
+class ShardEventWriter : public EventHandler
+{
+public:
+    explicit ShardEventWriter(SharedMemoryRing<ShardEvent> &events_)
+        : events(events_)
+    {}
+
+protected:
+    void handleOrderAdded(const OrderAdded &event) override
+    {
+        pushOrderEvent(ShardEventType::OrderAdded, event);
+    }
+
+    void handleOrderDeleted(const OrderDeleted &event) override
+    {
+        pushOrderEvent(ShardEventType::OrderDeleted, event);
+    }
+
+    void handleOrdersDeleted(const OrdersDeleted &event) override
+    {
+        pushOrdersEvent(ShardEventType::OrdersDeleted, event);
+    }
+
+    void handleOrdersExecuted(const OrdersExecuted &event) override
+    {
+        pushOrdersEvent(ShardEventType::OrdersExecuted, event);
+    }
+
+    void handleOrderUpdated(const OrderUpdated &event) override
+    {
+        pushOrderEvent(ShardEventType::OrderUpdated, event);
+    }
+
+    void handleOrderExecuted(const ExecutedOrder &event) override
+    {
+        pushOrderEvent(ShardEventType::OrderExecuted, event);
+    }
+
+    void handleTrade(const Trade &trade) override
+    {
+        ShardEvent event{};
+        event.sequence_number = trade.sequence_number;
+        event.type = ShardEventType::Trade;
+        event.symbol_id = trade.symbol_id;
+        event.trade = TradeRecord{trade.aggressor_id, trade.passive_id, trade.price, trade.quantity, trade.aggressor_open_quantity,
+            trade.passive_open_quantity, trade.aggressor_side};
+        events.push(event);
+    }
+
+    void handleOrderRejected(const OrderRejected &event) override
+    {
+        pushOrderEvent(ShardEventType::OrderRejected, event, event.reason);
+    }
+
+    void handleSymbolAdded(const SymbolAdded &event) override
+    {
+        pushSymbolEvent(ShardEventType::SymbolAdded, event);
+    }
+
+    void handleSymbolDeleted(const SymbolDeleted &event) override
+    {
+        pushSymbolEvent(ShardEventType::SymbolDeleted, event);
+    }
+
+    void handleTradeBar(const TradeBar &bar) override
+    {
+        ShardEvent event{};
+        event.sequence_number = bar.sequence_number;
+        event.type = ShardEventType::TradeBar;
+        event.symbol_id = bar.symbol_id;
+        event.bar = TradeBarRecord{bar.start_time, bar.end_time, bar.open_price, bar.high_price, bar.low_price, bar.close_price, bar.volume,
+            bar.num_trades};
+        events.push(event);
+    }
+
+private:
+    void pushOrderEvent(ShardEventType type, const OrderEvent &order_event, RejectReason reason = RejectReason::Halted)
+    {
+        ShardEvent event{};
+        event.sequence_number = order_event.sequence_number;
+        event.type = type;
+        event.symbol_id = order_event.order.getSymbolID();
+        event.order = OrderRecord::fromOrder(order_event.order);
+        event.reason = reason;
+        events.push(event);
+    }
+
+    template<typename OrdersEvent>
+    void pushOrdersEvent(ShardEventType type, const OrdersEvent &orders_event)
+    {
+        ShardEvent event{};
+        event.sequence_number = orders_event.sequence_number;
+        event.type = type;
+        event.symbol_id = orders_event.symbol_id;
+        event.num_orders = static_cast<uint32_t>(orders_event.orders.size());
+        events.push(event);
+        for (const auto &order : orders_event.orders)
+        {
+            event.num_orders = 0;
+            event.order = OrderRecord::fromOrder(order);
+            events.push(event);
+        }
+    }
+
+    template<typename SymbolEvent>
+    void pushSymbolEvent(ShardEventType type, const SymbolEvent &symbol_event)
+    {
+        ShardEvent event{};
+        event.sequence_number = symbol_event.sequence_number;
+        event.type = type;
+        event.symbol_id = symbol_event.symbol_id;
+        copySymbolName(event.symbol_name, symbol_event.name);
+        events.push(event);
+    }
+
+    // The ring that events are sent to the router through.
+    SharedMemoryRing<ShardEvent> &events;
+};
+
+ShardedMarket::Shard::Shard(std::unique_ptr<EventHandler> event_handler_, size_t ring_capacity)
+    : commands(std::make_unique<SharedMemoryRing<Command>>(ring_capacity))
+    , events(std::make_unique<SharedMemoryRing<ShardEvent>>(ring_capacity))
+    , event_handler(std::move(event_handler_))
+    , pid(0)
+    , exited(false)
+    , exit_status(0)
+{}
+
+ShardedMarket::ShardedMarket(std::vector<std::unique_ptr<EventHandler>> &event_handlers, uint8_t num_shards, size_t ring_capacity)
+    : symbol_shard_index(0)
+    , sequence_number(0)
+{
+    assert(num_shards > 0 && "The number of shards must be positive!");
+    assert(event_handlers.size() == num_shards && "The number of event handlers must be equal to the number of shards!");
+    shards.reserve(num_shards);
+    for (uint32_t i = 0; i < num_shards; ++i)
+    {
+        shards.emplace_back(std::move(event_handlers[i]), ring_capacity);
+        pid_t pid = fork();
+        if (pid < 0)
+            throw std::system_error(errno, std::generic_category(), "Failed to fork shard");
+        if (pid == 0)
+            runShard(shards.back());
+        shards.back().pid = pid;
+    }
+}
+
+ShardedMarket::~ShardedMarket()
+{
+    Command stop = Command::make(CommandType::Stop);
+    ShardEvent event{};
+    for (auto &shard : shards)
+    {
+        // Keep draining the events of the shard so that it is never stuck waiting to send one.
+        while (!shard.commands->tryPush(stop) && isRunning(shard))
+            while (shard.events->tryPop(event))
+                ;
+    }
+    for (auto &shard : shards)
+    {
+        while (isRunning(shard))
+        {
+            while (shard.events->tryPop(event))
+                ;
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ShardedMarket::addSymbol(uint32_t symbol_id, const std::string &symbol_name, size_t max_orders, size_t max_levels)
+{
+    assert(id_to_shard.find(symbol_id) == id_to_shard.end() && "Symbol already exists!");
+    Command command = Command::addSymbol(symbol_id, symbol_name, max_orders, max_levels);
+    id_to_symbol.insert({symbol_id, std::make_unique<Symbol>(symbol_id, symbol_name)});
+    id_to_shard.insert({symbol_id, symbol_shard_index});
+    submit(symbol_shard_index, command);
+    symbol_shard_index = (symbol_shard_index + 1) % shards.size();
+}
+
+void ShardedMarket::deleteSymbol(uint32_t symbol_id)
+{
+    auto it = id_to_shard.find(symbol_id);
+    assert(it != id_to_shard.end() && "Symbol does not exist!");
+    submit(it->second, Command::deleteSymbol(symbol_id, id_to_symbol.find(symbol_id)->second->name));
+    id_to_shard.erase(it);
+    id_to_symbol.erase(symbol_id);
+}
+
+void ShardedMarket::addOrder(const Order &order)
+{
+    // An order for an unknown symbol is sent to a shard that will reject it.
+    auto it = id_to_shard.find(order.getSymbolID());
+    submit(it == id_to_shard.end() ? order.getSymbolID() % shards.size() : it->second, Command::addOrder(order));
+}
+
+void ShardedMarket::deleteOrder(uint32_t symbol_id, uint64_t order_id)
+{
+    submitSymbolCommand(Command::deleteOrder(symbol_id, order_id));
+}
+
+void ShardedMarket::deleteOrders(uint32_t symbol_id)
+{
+    submitSymbolCommand(Command::deleteOrders(symbol_id));
+}
+
+void ShardedMarket::cancelOrder(uint32_t symbol_id, uint64_t order_id, Quantity cancelled_quantity)
+{
+    submitSymbolCommand(Command::cancelOrder(symbol_id, order_id, cancelled_quantity));
+}
+
+void ShardedMarket::replaceOrder(uint32_t symbol_id, uint64_t order_id, uint64_t new_order_id, Price new_price)
+{
+    submitSymbolCommand(Command::replaceOrder(symbol_id, order_id, new_order_id, new_price));
+}
+
+void ShardedMarket::amendOrder(uint32_t symbol_id, uint64_t order_id, Quantity new_quantity, Price new_price)
+{
+    submitSymbolCommand(Command::amendOrder(symbol_id, order_id, new_quantity, new_price));
+}
+
+void ShardedMarket::executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity, Price price)
+{
+    submitSymbolCommand(Command::executeOrder(symbol_id, order_id, quantity, price));
+}
+
+void ShardedMarket::executeOrder(uint32_t symbol_id, uint64_t order_id, Quantity quantity)
+{
+    submitSymbolCommand(Command::executeOrder(symbol_id, order_id, quantity));
+}
+
+void ShardedMarket::startAuction(uint32_t symbol_id)
+{
+    submitSymbolCommand(Command::make(CommandType::StartAuction, symbol_id));
+}
+
+void ShardedMarket::uncrossAuction(uint32_t symbol_id)
+{
+    submitSymbolCommand(Command::make(CommandType::UncrossAuction, symbol_id));
+}
+
+void ShardedMarket::haltSymbol(uint32_t symbol_id)
+{
+    submitSymbolCommand(Command::make(CommandType::HaltSymbol, symbol_id));
+}
+
+void ShardedMarket::resumeSymbol(uint32_t symbol_id)
+{
+    submitSymbolCommand(Command::make(CommandType::ResumeSymbol, symbol_id));
+}
+
+void ShardedMarket::setBarInterval(uint32_t symbol_id, uint64_t bar_interval)
+{
+    submitSymbolCommand(Command::setBarInterval(symbol_id, bar_interval));
+}
+
+void ShardedMarket::closeBars()
+{
+    Command command = Command::make(CommandType::CloseBars);
+    for (uint32_t i = 0; i < shards.size(); ++i)
+        submit(i, command);
+}
+
+void ShardedMarket::pollEvents()
+{
+    for (auto &shard : shards)
+        pollEvents(shard);
+}
+
+void ShardedMarket::sync()
+{
+    Command command = Command::make(CommandType::Sync);
+    for (uint32_t i = 0; i < shards.size(); ++i)
+        submit(i, command);
+    for (auto &shard : shards)
+    {
+        // A shard that has exited may still have sent the sync before it did.
+        bool running = true;
+        while (!pollEvents(shard))
+        {
+            if (!running)
+                reportExit(shard);
+            running = isRunning(shard);
+            std::this_thread::yield();
+        }
+    }
+}
+
+void ShardedMarket::runShard(Shard &shard)
+{
+#ifdef __linux__
+    // Do not outlive the router.
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+    Market market{std::make_unique<ShardEventWriter>(*shard.events)};
+    Command command{};
+    while (true)
+    {
+        if (!shard.commands->tryPop(command))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        if (command.type == CommandType::Sync)
+        {
+            ShardEvent event{};
+            event.type = ShardEventType::Synced;
+            shard.events->push(event);
+        }
+        else if (command.type == CommandType::Stop)
+        {
+            // Skip the destructors of the state that was copied from the router.
+            _exit(0);
+        }
+        else
+        {
+            market.applyCommand(command);
+        }
+    }
+}
+
+bool ShardedMarket::isRunning(Shard &shard)
+{
+    if (shard.exited)
+        return false;
+    int status = 0;
+    if (waitpid(shard.pid, &status, WNOHANG) == 0)
+        return true;
+    shard.exited = true;
+    shard.exit_status = status;
+    return false;
+}
+
+void ShardedMarket::reportExit(const Shard &shard)
+{
+    throw std::runtime_error(
+        "Shard process " + std::to_string(shard.pid) + " exited unexpectedly with status " + std::to_string(shard.exit_status));
+}
+
+void ShardedMarket::submit(uint32_t shard_index, Command command)
+{
+    if (command.type != CommandType::Sync)
+        command.sequence_number = ++sequence_number;
+    Shard &shard = shards[shard_index];
+    bool running = true;
+    while (!shard.commands->tryPush(command))
+    {
+        if (!running)
+            reportExit(shard);
+        // The shard may be waiting for space to send its events.
+        pollEvents(shard);
+        running = isRunning(shard);
+        std::this_thread::yield();
+    }
+}
+
+void ShardedMarket::submitSymbolCommand(const Command &command)
+{
+    auto it = id_to_shard.find(command.symbol_id);
+    assert(it != id_to_shard.end() && "Symbol does not exist!");
+    if (it == id_to_shard.end())
+        return;
+    submit(it->second, command);
+}
+
+bool ShardedMarket::pollEvents(Shard &shard)
+{
+    bool synced = false;
+    EventHandler &event_handler = *shard.event_handler;
+    ShardEvent event{};
+    while (shard.events->tryPop(event))
+    {
+        event_handler.sequence_number = event.sequence_number;
+        switch (event.type)
+        {
+        case ShardEventType::OrderAdded:
+            event_handler.handleOrderAdded(event_handler.stamp(OrderAdded{event.order.toOrder()}));
+            break;
+        case ShardEventType::OrderDeleted:
+            event_handler.handleOrderDeleted(event_handler.stamp(OrderDeleted{event.order.toOrder()}));
+            break;
+        case ShardEventType::OrderUpdated:
+            event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{event.order.toOrder()}));
+            break;
+        case ShardEventType::OrderExecuted:
+            event_handler.handleOrderExecuted(event_handler.stamp(ExecutedOrder{event.order.toOrder()}));
+            break;
+        case ShardEventType::Trade:
+        {
+            const TradeRecord &trade = event.trade;
+            event_handler.handleTrade(event_handler.stamp(Trade{event.symbol_id, trade.aggressor_id, trade.passive_id, trade.price,
+                trade.quantity, trade.aggressor_side, trade.aggressor_open_quantity, trade.passive_open_quantity}));
+            break;
+        }
+        case ShardEventType::OrderRejected:
+            event_handler.handleOrderRejected(event_handler.stamp(OrderRejected{event.order.toOrder(), event.reason}));
+            break;
+        case ShardEventType::OrdersDeleted:
+        case ShardEventType::OrdersExecuted:
+        {
+            // The shard sends the orders right after the event, so they will arrive shortly.
+            std::vector<Order> orders;
+            orders.reserve(event.num_orders);
+            ShardEvent order_event{};
+            bool running = true;
+            while (orders.size() < event.num_orders)
+            {
+                if (shard.events->tryPop(order_event))
+                {
+                    orders.push_back(order_event.order.toOrder());
+                    continue;
+                }
+                if (!running)
+                    reportExit(shard);
+                running = isRunning(shard);
+                std::this_thread::yield();
+            }
+            if (event.type == ShardEventType::OrdersDeleted)
+                event_handler.handleOrdersDeleted(event_handler.stamp(OrdersDeleted{event.symbol_id, std::move(orders)}));
+            else
+                event_handler.handleOrdersExecuted(event_handler.stamp(OrdersExecuted{event.symbol_id, std::move(orders)}));
+            break;
+        }
+        case ShardEventType::SymbolAdded:
+            event_handler.handleSymbolAdded(event_handler.stamp(SymbolAdded{event.symbol_id, event.symbol_name}));
+            break;
+        case ShardEventType::SymbolDeleted:
+            event_handler.handleSymbolDeleted(event_handler.stamp(SymbolDeleted{event.symbol_id, event.symbol_name}));
+            break;
+        case ShardEventType::TradeBar:
+        {
+            const TradeBarRecord &record = event.bar;
+            TradeBar bar{event.symbol_id, record.start_time, record.end_time};
+            bar.open_price = record.open_price;
+            bar.high_price = record.high_price;
+            bar.low_price = record.low_price;
+            bar.close_price = record.close_price;
+            bar.volume = record.volume;
+            bar.num_trades = record.num_trades;
+            event_handler.handleTradeBar(event_handler.stamp(bar));
+            break;
+        }
+        case ShardEventType::Synced:
+            synced = true;
+            break;
+        }
+    }
+    return synced;
+}
+} // namespace RapidTrader
@@ -0,0 +1,81 @@
+#include <cassert>
+#include <thread>
+#include "market/symbol_routing_table.h"
+
+namespace RapidTrader {
+SymbolRoutingTable::SymbolRoutingTable(uint32_t dense_limit_)
+    : dense_limit(dense_limit_)
+    , chunks(new std::atomic<Chunk *>[dense_limit_ >> chunk_bits])
+    , sparse_table(nullptr)
+    , reader_epoch(0)
+{
+    assert((dense_limit & chunk_mask) == 0 && "Dense limit must be a multiple of the chunk size!");
+    for (uint32_t i = 0; i < dense_limit >> chunk_bits; ++i)
+        chunks[i].store(nullptr, std::memory_order_relaxed);
+    publish(std::make_unique<SparseTable>());
+}
+
+SymbolRoutingTable::~SymbolRoutingTable()
+{
+    for (uint32_t i = 0; i < dense_limit >> chunk_bits; ++i)
+        delete chunks[i].load(std::memory_order_relaxed);
+    delete sparse_table.load(std::memory_order_relaxed);
+}
+
+void SymbolRoutingTable::insert(uint32_t symbol_id, uint32_t route)
+{
+    assert(route != unknown_symbol && "Invalid route!");
+    assert(find(symbol_id) == unknown_symbol && "Symbol already exists!");
+    if (symbol_id < dense_limit)
+    {
+        Chunk *chunk = chunks[symbol_id >> chunk_bits].load(std::memory_order_relaxed);
+        if (chunk == nullptr)
+        {
+            chunk = new Chunk;
+            for (auto &entry : *chunk)
+                entry.store(unknown_symbol, std::memory_order_relaxed);
+            chunks[symbol_id >> chunk_bits].store(chunk, std::memory_order_release);
+        }
+        (*chunk)[symbol_id & chunk_mask].store(route, std::memory_order_release);
+        return;
+    }
+    auto table = std::make_unique<SparseTable>(*sparse_table.load(std::memory_order_relaxed));
+    table->insert({symbol_id, route});
+    publish(std::move(table));
+}
+
+void SymbolRoutingTable::erase(uint32_t symbol_id)
+{
+    assert(find(symbol_id) != unknown_symbol && "Symbol does not exist!");
+    if (symbol_id < dense_limit)
+    {
+        Chunk *chunk = chunks[symbol_id >> chunk_bits].load(std::memory_order_relaxed);
+        (*chunk)[symbol_id & chunk_mask].store(unknown_symbol, std::memory_order_release);
+        return;
+    }
+    auto table = std::make_unique<SparseTable>(*sparse_table.load(std::memory_order_relaxed));
+    table->erase(symbol_id);
+    publish(std::move(table));
+}
+
+void SymbolRoutingTable::publish(std::unique_ptr<SparseTable> table)
+{
+    std::unique_ptr<const SparseTable> retired{sparse_table.exchange(table.release())};
+    if (retired)
+        waitForReaders();
+}
+
+void SymbolRoutingTable::waitForReaders()
+{
+    // A reader that joins a count after the count has been seen to drain loads the new table. Each
+    // count is drained while new readers join the other one, and readers that loaded the epoch just
+    // before it moved are waited for when their count is drained.
+    for (int phase = 0; phase < 2; ++phase)
+    {
+        uint64_t epoch = reader_epoch.load(std::memory_order_relaxed);
+        reader_epoch.store(epoch + 1);
+        while (reader_counts[epoch & 1].count.load() != 0)
+            std::this_thread::yield();
+    }
+}
+} // namespace RapidTrader
@@ -0,0 +1,166 @@
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include "book_dump.h"
+
+namespace RapidTrader {
+// The number of bytes that the writer buffers before writing them to the file.
+constexpr size_t book_dump_buffer_size = size_t{1} << 20;
+
+// The number of kinds of level in a book.
+constexpr size_t num_level_kinds = 6;
+
+/**
+ * @param book a snapshot of a book.
+ * @param kind the index of a kind of level, require that it is less than num_level_kinds.
+ * @return the levels of the kind in the book, in the order that the kinds are dumped.
+ */
+template<typename Snapshot>
+static auto levelsOf(Snapshot &book, size_t kind) -> decltype(&book.bid_levels)
+{
+    decltype(&book.bid_levels) levels[] = {&book.bid_levels, &book.ask_levels, &book.stop_bid_levels, &book.stop_ask_levels,
+        &book.trailing_stop_bid_levels, &book.trailing_stop_ask_levels};
+    return levels[kind];
+}
+
+BookDumpWriter::BookDumpWriter(const std::string &name)
+    : file(std::fopen(name.c_str(), "wb"))
+{
+    if (!file)
+        throw std::system_error(errno, std::generic_category(), "Failed to create dump " + name);
+    buffer.reserve(book_dump_buffer_size);
+    appendBytes(book_dump_magic, sizeof(book_dump_magic));
+    append(book_dump_version);
+    append(uint32_t{0});
+}
+
+BookDumpWriter::~BookDumpWriter()
+{
+    // Destructors must not throw, so a failure to write the last books is only visible to a
+    // caller that flushes before the writer is destroyed.
+    if (!buffer.empty())
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+    std::fclose(file);
+}
+
+void BookDumpWriter::write(const BookSnapshot &book)
+{
+    append(book.symbol_id);
+    append(uint32_t{0});
+    append(static_cast<uint64_t>(book.last_traded_price));
+    for (size_t kind = 0; kind < num_level_kinds; ++kind)
+        append(static_cast<uint64_t>(levelsOf(book, kind)->size()));
+    for (size_t kind = 0; kind < num_level_kinds; ++kind)
+    {
+        for (const auto &level : *levelsOf(book, kind))
+        {
+            append(static_cast<uint64_t>(level.price));
+            append(static_cast<uint64_t>(level.volume));
+        }
+    }
+}
+
+void BookDumpWriter::flush()
+{
+    if (!buffer.empty() && std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size())
+        throw std::system_error(errno, std::generic_category(), "Failed to write dump");
+    buffer.clear();
+    if (std::fflush(file) != 0)
+        throw std::system_error(errno, std::generic_category(), "Failed to write dump");
+}
+
+void BookDumpWriter::append(uint64_t value)
+{
+    appendBytes(&value, sizeof(value));
+}
+
+void BookDumpWriter::append(uint32_t value)
+{
+    appendBytes(&value, sizeof(value));
+}
+
+void BookDumpWriter::appendBytes(const void *bytes, size_t num_bytes)
+{
+    if (buffer.size() + num_bytes > book_dump_buffer_size)
+        flush();
+    const char *first = static_cast<const char *>(bytes);
+    buffer.insert(buffer.end(), first, first + num_bytes);
+}
+
+BookDumpReader::BookDumpReader(const std::string &name)
+    : file(std::fopen(name.c_str(), "rb"))
+{
+    if (!file)
+        throw std::system_error(errno, std::generic_category(), "Failed to open dump " + name);
+    char magic[sizeof(book_dump_magic)];
+    if (readBytes(magic, sizeof(magic)) != sizeof(magic) || std::memcmp(magic, book_dump_magic, sizeof(magic)) != 0)
+    {
+        std::fclose(file);
+        throw std::runtime_error(name + " is not a book dump");
+    }
+    uint32_t version = 0;
+    if (readBytes(&version, sizeof(version)) != sizeof(version) || version != book_dump_version)
+    {
+        std::fclose(file);
+        throw std::runtime_error(name + " has an unsupported book dump version");
+    }
+    uint32_t reserved;
+    readBytes(&reserved, sizeof(reserved));
+}
+
+BookDumpReader::~BookDumpReader()
+{
+    std::fclose(file);
+}
+
+bool BookDumpReader::read(BookSnapshot &book)
+{
+    uint32_t symbol_id;
+    size_t num_bytes = readBytes(&symbol_id, sizeof(symbol_id));
+    if (num_bytes == 0)
+        return false;
+    if (num_bytes != sizeof(symbol_id))
+        throw std::runtime_error("Book dump ends in the middle of a book");
+    book.symbol_id = symbol_id;
+    readUint32();
+    book.last_traded_price = static_cast<Price>(readUint64());
+    uint64_t num_levels[num_level_kinds];
+    for (uint64_t &num_kind_levels : num_levels)
+        num_kind_levels = readUint64();
+    for (size_t kind = 0; kind < num_level_kinds; ++kind)
+    {
+        std::vector<BookSnapshot::LevelSnapshot> &levels = *levelsOf(book, kind);
+        levels.clear();
+        levels.reserve(num_levels[kind]);
+        for (uint64_t i = 0; i < num_levels[kind]; ++i)
+        {
+            Price price = static_cast<Price>(readUint64());
+            Volume volume = static_cast<Volume>(readUint64());
+            levels.push_back({price, volume});
+        }
+    }
+    return true;
+}
+
+size_t BookDumpReader::readBytes(void *bytes, size_t num_bytes)
+{
+    return std::fread(bytes, 1, num_bytes, file);
+}
+
+uint64_t BookDumpReader::readUint64()
+{
+    uint64_t value;
+    if (readBytes(&value, sizeof(value)) != sizeof(value))
+        throw std::runtime_error("Book dump ends in the middle of a book");
+    return value;
+}
+
+uint32_t BookDumpReader::readUint32()
+{
+    uint32_t value;
+    if (readBytes(&value, sizeof(value)) != sizeof(value))
+        throw std::runtime_error("Book dump ends in the middle of a book");
+    return value;
+}
+} // namespace RapidTrader
@@ -0,0 +1,37 @@
+#include "book_snapshot.h"
+
+namespace RapidTrader {
+// LCOV_EXCL_START
+/**
+ * Appends the string representation of some levels to a string.
+ *
+ * @param levels the levels to append.
+ * @param book_string the string to append to.
+ */
+static void appendLevels(const std::vector<BookSnapshot::LevelSnapshot> &levels, std::string &book_string)
+{
+    for (const auto &level : levels)
+        book_string += std::to_string(level.price) + " X " + std::to_string(level.volume) + "\n";
+}
+
+std::string BookSnapshot::toString() const
+{
+    std::string book_string;
+    book_string += "SYMBOL ID : " + std::to_string(symbol_id) + "\n";
+    book_string += "LAST TRADED PRICE: " + std::to_string(last_traded_price) + "\n";
+    book_string += "BID ORDERS\n";
+    appendLevels(bid_levels, book_string);
+    book_string += "ASK ORDERS\n";
+    appendLevels(ask_levels, book_string);
+    book_string += "BID STOP ORDERS\n";
+    appendLevels(stop_bid_levels, book_string);
+    book_string += "ASK STOP ORDERS\n";
+    appendLevels(stop_ask_levels, book_string);
+    book_string += "BID TRAILING STOP ORDERS\n";
+    appendLevels(trailing_stop_bid_levels, book_string);
+    book_string += "ASK TRAILING STOP ORDERS\n";
+    appendLevels(trailing_stop_ask_levels, book_string);
+    return book_string;
+}
+// LCOV_EXCL_STOP
+} // namespace RapidTrader
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cassert>
+#include "depth_index.h"
+
+namespace RapidTrader {
+// The number of prices covered by the window when the first volume is added.
+static constexpr size_t initial_window = 64;
+
+// The share of the maximum window size that the outliers must reach before the window is first re-centred.
+static constexpr size_t recentre_divisor = 16;
+
+DepthIndex::DepthIndex(size_t max_window_)
+    : below_volume(0)
+    , recentre_outliers(std::max<size_t>(max_window_ / recentre_divisor, 1))
+    , base(0)
+    , total_volume(0)
+    , max_window(max_window_)
+{
+    assert(max_window > 0 && (max_window & (max_window - 1)) == 0 && "Maximum window size must be a positive power of two!");
+}
+
+void DepthIndex::add(Price price, Volume volume)
+{
+    total_volume += volume;
+    if (!cover(price))
+    {
+        outliers[price] += volume;
+        if (price < base)
+            below_volume += volume;
+        if (outliers.size() > recentre_outliers)
+            recentre(price);
+        return;
+    }
+    size_t index = price - base;
+    volumes[index] += volume;
+    for (size_t i = index + 1; i < tree.size(); i += i & (~i + 1))
+        tree[i] += volume;
+}
+
+void DepthIndex::remove(Price price, Volume volume)
+{
+    assert(total_volume >= volume && "Cannot remove more volume than the index contains!");
+    total_volume -= volume;
+    if (!inWindow(price))
+    {
+        auto outliers_it = outliers.find(price);
+        assert(outliers_it != outliers.end() && outliers_it->second >= volume && "Cannot remove more volume than exists at price!");
+        outliers_it->second -= volume;
+        if (outliers_it->second == 0)
+            outliers.erase(outliers_it);
+        if (price < base)
+            below_volume -= volume;
+        return;
+    }
+    size_t index = price - base;
+    assert(volumes[index] >= volume && "Cannot remove more volume than exists at price!");
+    volumes[index] -= volume;
+    for (size_t i = index + 1; i < tree.size(); i += i & (~i + 1))
+        tree[i] -= volume;
+}
+
+Volume DepthIndex::volumeAtOrBelow(Price price) const
+{
+    if (inWindow(price))
+        return below_volume + prefixSum(price - base);
+    if (price < base)
+    {
+        Volume volume = 0;
+        for (auto outliers_it = outliers.begin(); outliers_it != outliers.end() && outliers_it->first <= price; ++outliers_it)
+            volume += outliers_it->second;
+        return volume;
+    }
+    // Above the window, so only the outliers above the price are left out.
+    Volume volume = total_volume;
+    for (auto outliers_it = outliers.rbegin(); outliers_it != outliers.rend() && outliers_it->first > price; ++outliers_it)
+        volume -= outliers_it->second;
+    return volume;
+}
+
+Volume DepthIndex::volumeAtOrAbove(Price price) const
+{
+    return price == 0 ? total_volume : total_volume - volumeAtOrBelow(price - 1);
+}
+
+bool DepthIndex::cover(Price price)
+{
+    if (inWindow(price))
+        return true;
+    if (volumes.empty())
+    {
+        // Start with a small window centered on the first price.
+        size_t window = std::min(initial_window, max_window);
+        base = price > window / 2 ? price - window / 2 : 0;
+        volumes.assign(window, 0);
+        tree.assign(window + 1, 0);
+        return true;
+    }
+    uint64_t low = std::min<uint64_t>(base, price);
+    uint64_t high = std::max<uint64_t>(base + volumes.size() - 1, price);
+    uint64_t span = high - low + 1;
+    size_t window = volumes.size();
+    while (window < span && window <= max_window)
+        window *= 2;
+    if (window > max_window)
+        return false;
+    // Leave the extra room on the side that the window is growing towards.
+    uint64_t new_base = price < base ? (high + 1 > window ? high + 1 - window : 0) : base;
+    std::vector<Volume> new_volumes(window, 0);
+    std::copy(volumes.begin(), volumes.end(), new_volumes.begin() + (base - new_base));
+    volumes = std::move(new_volumes);
+    Price old_base = base;
+    base = static_cast<Price>(new_base);
+    // Move any outliers that the window now covers into the window.
+    auto outliers_it = outliers.lower_bound(base);
+    while (outliers_it != outliers.end() && inWindow(outliers_it->first))
+    {
+        if (outliers_it->first < old_base)
+            below_volume -= outliers_it->second;
+        volumes[outliers_it->first - base] += outliers_it->second;
+        outliers_it = outliers.erase(outliers_it);
+    }
+    rebuild();
+    return true;
+}
+
+void DepthIndex::recentre(Price price)
+{
+    for (size_t index = 0; index < volumes.size(); ++index)
+    {
+        if (volumes[index] != 0)
+            outliers[base + index] += volumes[index];
+    }
+    base = price > max_window / 2 ? static_cast<Price>(price - max_window / 2) : 0;
+    volumes.assign(max_window, 0);
+    below_volume = 0;
+    auto outliers_it = outliers.begin();
+    for (; outliers_it != outliers.end() && outliers_it->first < base; ++outliers_it)
+        below_volume += outliers_it->second;
+    while (outliers_it != outliers.end() && inWindow(outliers_it->first))
+    {
+        volumes[outliers_it->first - base] += outliers_it->second;
+        outliers_it = outliers.erase(outliers_it);
+    }
+    rebuild();
+    recentre_outliers = std::max(recentre_outliers, 2 * outliers.size());
+}
+
+void DepthIndex::rebuild()
+{
+    tree.assign(volumes.size() + 1, 0);
+    for (size_t i = 1; i < tree.size(); ++i)
+    {
+        tree[i] += volumes[i - 1];
+        size_t parent = i + (i & (~i + 1));
+        if (parent < tree.size())
+            tree[parent] += tree[i];
+    }
+}
+
+Volume DepthIndex::prefixSum(size_t index) const
+{
+    Volume volume = 0;
+    for (size_t i = index + 1; i > 0; i -= i & (~i + 1))
+        volume += tree[i];
+    return volume;
+}
+} // namespace RapidTrader
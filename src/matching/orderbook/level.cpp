@@ -2,12 +2,14 @@
 #include "level.h"
 
 namespace RapidTrader {
-Level::Level(uint64_t price_, LevelSide side_, uint32_t symbol_id_)
-    : price(price_)
+Level::Level(Price price_, LevelSide side_, uint32_t symbol_id_, DepthIndex *depth_)
+    : depth(depth_)
+    , price(price_)
     , side(side_)
     , symbol_id(symbol_id_)
 {
     volume = 0;
+    displayed_volume = 0;
 }
 
 const list<Order> &Level::getOrders() const
@@ -25,6 +27,8 @@ void Level::addOrder(Order &order)
     assert(order.isAsk() ? side == LevelSide::Ask : side == LevelSide::Bid && "Order is on different side than level!");
     assert(order.getSymbolID() == symbol_id && "Order does not have the same symbol ID as the level!");
     volume += order.getOpenQuantity();
+    displayed_volume += order.getVisibleQuantity();
+    depthAdded(order.getOpenQuantity());
     orders.push_back(order);
     VALIDATE_LEVEL;
 }
@@ -34,6 +38,8 @@ void Level::popFront()
     assert(!orders.empty() && "Cannot pop from empty level!");
     Order &order_to_remove = orders.front();
     volume -= order_to_remove.getOpenQuantity();
+    displayed_volume -= order_to_remove.getVisibleQuantity();
+    depthRemoved(order_to_remove.getOpenQuantity());
     orders.pop_front();
     VALIDATE_LEVEL;
 };
@@ -43,6 +49,8 @@ void Level::popBack()
     assert(!orders.empty() && "Cannot pop from empty level!");
     Order &order_to_remove = orders.back();
     volume -= order_to_remove.getOpenQuantity();
+    displayed_volume -= order_to_remove.getVisibleQuantity();
+    depthRemoved(order_to_remove.getOpenQuantity());
     orders.pop_back();
     VALIDATE_LEVEL;
 }
@@ -50,14 +58,41 @@ void Level::popBack()
 void Level::deleteOrder(const Order &order)
 {
     volume -= order.getOpenQuantity();
+    displayed_volume -= order.getVisibleQuantity();
+    depthRemoved(order.getOpenQuantity());
     orders.erase(boost::intrusive::list<Order>::s_iterator_to(order));
     VALIDATE_LEVEL;
 }
 
-void Level::reduceVolume(uint64_t amount)
+void Level::moveToBack(Order &order)
+{
+    orders.splice(orders.end(), orders, boost::intrusive::list<Order>::s_iterator_to(order));
+    VALIDATE_LEVEL;
+}
+
+void Level::clear()
+{
+    depthRemoved(volume);
+    volume = 0;
+    displayed_volume = 0;
+    orders.clear();
+}
+
+void Level::reduceVolume(Quantity amount, Quantity displayed_amount)
 {
     assert(volume >= amount && "Cannot reduce level volume by amount greater than its current volume!");
+    assert(displayed_amount <= amount && "Cannot reduce displayed volume by more than the volume!");
     volume -= amount;
+    displayed_volume -= displayed_amount;
+    depthRemoved(amount);
+    VALIDATE_LEVEL;
+}
+
+void Level::replenishOrder(Order &order)
+{
+    displayed_volume -= order.getVisibleQuantity();
+    order.replenish();
+    displayed_volume += order.getVisibleQuantity();
     VALIDATE_LEVEL;
 }
 
@@ -89,7 +124,8 @@ std::ostream &operator<<(std::ostream &os, const Level &level)
 
 void Level::validateLevel() const
 {
-    uint64_t actual_volume = 0;
+    Volume actual_volume = 0;
+    Volume actual_displayed_volume = 0;
     for (const auto &order : orders)
     {
         assert(side == LevelSide::Ask ? order.isAsk() : order.isBid() && "Order side does not match level side!");
@@ -99,8 +135,10 @@ void Level::validateLevel() const
             assert(order.getPrice() == price && "Order price does not match price of the level!");
         assert(!order.isMarket() && "Level should never contain market orders!");
         actual_volume += order.getOpenQuantity();
+        actual_displayed_volume += order.getVisibleQuantity();
     }
     assert(actual_volume == volume && "Level has incorrect volume!");
+    assert(actual_displayed_volume == displayed_volume && "Level has incorrect displayed volume!");
 }
 } // namespace RapidTrader
 // LCOV_EXCL_STOP
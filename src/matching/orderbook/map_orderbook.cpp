@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include "map_orderbook.h"
@@ -5,17 +6,91 @@
 #include "log.h"
 
 namespace RapidTrader {
-MapOrderBook::MapOrderBook(uint32_t symbol_id_, EventHandler &event_handler_)
-    : symbol_id(symbol_id_)
+// The resolution of the timer wheel that expires GTD orders, one millisecond.
+static constexpr uint64_t expiry_tick_duration = 1000000;
+
+// A map node holds the key-value pair along with the color and parent, left, and right pointers.
+static constexpr size_t level_node_size = sizeof(LevelMap::value_type) + 4 * sizeof(void *);
+
+/**
+ * @param orders an order index.
+ * @return a count of the storage that the index has allocated, which only increases when the index grows.
+ */
+static size_t orderIndexAllocations(const OrderIndex &orders)
+{
+#ifdef RAPID_TRADER_DENSE_ORDER_INDEX
+    return orders.numberOfAllocatedPages();
+#else
+    // The hash map never shrinks when orders are erased, so its size only changes when it grows.
+    return orders.mask() + 1;
+#endif
+}
+
+MapOrderBook::MapOrderBook(uint32_t symbol_id_, EventHandler &event_handler_, const Clock &clock_, size_t max_orders, size_t max_levels)
+    : level_pool(level_node_size)
+    , expiry_wheel(expiry_tick_duration, clock_.now())
+    , ask_levels(PoolAllocator<LevelMap::value_type>(&level_pool))
+    , bid_levels(PoolAllocator<LevelMap::value_type>(&level_pool))
+    , stop_ask_levels(PoolAllocator<LevelMap::value_type>(&level_pool))
+    , stop_bid_levels(PoolAllocator<LevelMap::value_type>(&level_pool))
+    , trailing_stop_ask_levels(PoolAllocator<LevelMap::value_type>(&level_pool))
+    , trailing_stop_bid_levels(PoolAllocator<LevelMap::value_type>(&level_pool))
+    , symbol_id(symbol_id_)
     , event_handler(event_handler_)
+    , clock(clock_)
+    , risk_check(nullptr)
     , last_traded_price(0)
     , trailing_bid_price(0)
-    , trailing_ask_price(std::numeric_limits<uint64_t>::max())
-{}
+    , trailing_ask_price(std::numeric_limits<Price>::max())
+    , growth_events(0)
+    , capacity_hinted(max_orders > 0 || max_levels > 0)
+    , self_trade_prevention(SelfTradePrevention::None)
+    , allocation_policy(AllocationPolicy::Fifo)
+    , in_auction(false)
+    , halted(false)
+    , price_band_bps(0)
+    , price_band_reference(0)
+    , num_trades(0)
+    , traded_volume(0)
+    , traded_notional(0)
+    , open_price(0)
+    , high_price(0)
+    , low_price(0)
+    , bar_interval(0)
+    , open_bar(symbol_id_, 0, 0)
+{
+    if (max_orders > 0)
+        orders.reserve(max_orders);
+    if (max_levels > 0)
+        level_pool.reserve(max_levels);
+    index_allocations = orderIndexAllocations(orders);
+    pool_allocations = level_pool.getAllocatedBlocks();
+}
 
 void MapOrderBook::addOrder(Order order)
 {
-    event_handler.handleOrderAdded(OrderAdded{order});
+    RejectReason reason;
+    if (rejectOrder(order, 0, reason))
+    {
+        event_handler.handleOrderRejected(event_handler.stamp(OrderRejected{order, reason}));
+        return;
+    }
+    acceptOrder(order);
+}
+
+void MapOrderBook::acceptOrder(Order &order)
+{
+    // Expired orders must leave the book before they can be matched against.
+    uint64_t now = clock.now();
+    deleteExpiredOrders(now);
+    event_handler.handleOrderAdded(event_handler.stamp(OrderAdded{order}));
+    if (order.isGtd() && order.getExpiryTime() <= now)
+    {
+        reportRelease(order, order.getOpenQuantity());
+        event_handler.handleOrderDeleted(event_handler.stamp(OrderDeleted{order}));
+        VALIDATE_ORDERBOOK;
+        return;
+    }
     switch (order.getType())
     {
     case OrderType::Limit:
@@ -35,48 +110,109 @@ void MapOrderBook::addOrder(Order order)
     VALIDATE_ORDERBOOK;
 }
 
-void MapOrderBook::executeOrder(uint64_t order_id, uint64_t quantity, uint64_t price)
+bool MapOrderBook::rejectOrder(const Order &order, Quantity replaced_quantity, RejectReason &reason)
+{
+    if (halted)
+    {
+        reason = RejectReason::Halted;
+        return true;
+    }
+    Price reference_price = price_band_reference == 0 ? last_traded_price : price_band_reference;
+    if (price_band_bps != 0 && reference_price != 0 && order.isLimit())
+    {
+        // Split the reference price so that the band can be calculated without overflowing.
+        Price band = reference_price / 10000 * price_band_bps + reference_price % 10000 * price_band_bps / 10000;
+        Price lower_bound = reference_price > band ? reference_price - band : 0;
+        Price max_price = std::numeric_limits<Price>::max();
+        Price upper_bound = max_price - reference_price > band ? reference_price + band : max_price;
+        if (order.getPrice() < lower_bound || order.getPrice() > upper_bound)
+        {
+            reason = RejectReason::OutsidePriceBand;
+            return true;
+        }
+    }
+    // The risk stage is checked last since it records the orders that it accepts.
+    return risk_check && risk_check->rejectOrder(order, replaced_quantity, reference_price, clock, reason);
+}
+
+void MapOrderBook::setRiskCheck(RiskCheck *risk_check_)
+{
+    if (risk_check == risk_check_)
+        return;
+    // Every resting order is in a level, and the levels can be walked whichever order index is used.
+    for (const LevelMap *levels :
+        {&bid_levels, &ask_levels, &stop_bid_levels, &stop_ask_levels, &trailing_stop_bid_levels, &trailing_stop_ask_levels})
+    {
+        for (const auto &[price, level] : *levels)
+        {
+            for (const Order &order : level.getOrders())
+            {
+                if (risk_check)
+                    risk_check->orderReleased(order, order.getOpenQuantity());
+                if (risk_check_)
+                    risk_check_->orderAccepted(order);
+            }
+        }
+    }
+    risk_check = risk_check_;
+}
+
+void MapOrderBook::executeOrder(uint64_t order_id, Quantity quantity, Price price)
 {
     auto orders_it = orders.find(order_id);
     Level &executing_level = orders_it->second.level_it->second;
     Order &executing_order = orders_it->second.order;
-    uint64_t executing_quantity = std::min(quantity, executing_order.getOpenQuantity());
+    Quantity executing_quantity = std::min(quantity, executing_order.getOpenQuantity());
+    // A manual execution may execute the hidden quantity of an iceberg order.
+    Quantity visible_quantity = executing_order.getVisibleQuantity();
     executing_order.execute(price, executing_quantity);
+    recordTrade(price, executing_quantity);
     last_traded_price = price;
-    event_handler.handleOrderExecuted(ExecutedOrder{executing_order});
-    executing_level.reduceVolume(executing_order.getLastExecutedQuantity());
+    event_handler.handleOrderExecuted(event_handler.stamp(ExecutedOrder{executing_order}));
+    reportExecution(executing_order);
+    executing_level.reduceVolume(executing_order.getLastExecutedQuantity(), visible_quantity - executing_order.getVisibleQuantity());
     if (executing_order.isFilled())
         deleteOrder(order_id, true);
+    else if (executing_order.getVisibleQuantity() == 0)
+        replenishOrder(executing_order, executing_level);
     activateStopOrders();
     VALIDATE_ORDERBOOK;
 }
 
-void MapOrderBook::executeOrder(uint64_t order_id, uint64_t quantity)
+void MapOrderBook::executeOrder(uint64_t order_id, Quantity quantity)
 {
     auto orders_it = orders.find(order_id);
     Level &executing_level = orders_it->second.level_it->second;
     Order &executing_order = orders_it->second.order;
-    uint64_t executing_quantity = std::min(quantity, executing_order.getOpenQuantity());
-    uint64_t executing_price = executing_order.getPrice();
+    Quantity executing_quantity = std::min(quantity, executing_order.getOpenQuantity());
+    Price executing_price = executing_order.getPrice();
+    Quantity visible_quantity = executing_order.getVisibleQuantity();
     executing_order.execute(executing_price, executing_quantity);
+    recordTrade(executing_price, executing_quantity);
     last_traded_price = executing_price;
-    event_handler.handleOrderExecuted(ExecutedOrder{executing_order});
-    executing_level.reduceVolume(executing_order.getLastExecutedQuantity());
+    event_handler.handleOrderExecuted(event_handler.stamp(ExecutedOrder{executing_order}));
+    reportExecution(executing_order);
+    executing_level.reduceVolume(executing_order.getLastExecutedQuantity(), visible_quantity - executing_order.getVisibleQuantity());
     if (executing_order.isFilled())
         deleteOrder(order_id, true);
+    else if (executing_order.getVisibleQuantity() == 0)
+        replenishOrder(executing_order, executing_level);
     activateStopOrders();
     VALIDATE_ORDERBOOK;
 }
 
-void MapOrderBook::cancelOrder(uint64_t order_id, uint64_t quantity)
+void MapOrderBook::cancelOrder(uint64_t order_id, Quantity quantity)
 {
     auto orders_it = orders.find(order_id);
     Level &cancelling_level = orders_it->second.level_it->second;
     Order &cancelling_order = orders_it->second.order;
-    uint64_t pre_cancellation_quantity = cancelling_order.getOpenQuantity();
+    Quantity pre_cancellation_quantity = cancelling_order.getOpenQuantity();
+    Quantity pre_cancellation_visible_quantity = cancelling_order.getVisibleQuantity();
     cancelling_order.setQuantity(quantity);
-    event_handler.handleOrderUpdated(OrderUpdated{cancelling_order});
-    cancelling_level.reduceVolume(pre_cancellation_quantity - cancelling_order.getOpenQuantity());
+    reportRelease(cancelling_order, pre_cancellation_quantity - cancelling_order.getOpenQuantity());
+    event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{cancelling_order}));
+    cancelling_level.reduceVolume(pre_cancellation_quantity - cancelling_order.getOpenQuantity(),
+        pre_cancellation_visible_quantity - cancelling_order.getVisibleQuantity());
     if (cancelling_order.isFilled())
         deleteOrder(order_id, true);
     activateStopOrders();
@@ -85,50 +221,244 @@ void MapOrderBook::cancelOrder(uint64_t order_id, uint64_t quantity)
 
 void MapOrderBook::deleteOrder(uint64_t order_id)
 {
+    const Order &order = orders.find(order_id)->second.order;
+    reportRelease(order, order.getOpenQuantity());
     deleteOrder(order_id, true);
     activateStopOrders();
     VALIDATE_ORDERBOOK;
 }
 
-void MapOrderBook::deleteOrder(uint64_t order_id, bool notification)
+void MapOrderBook::deleteOrders()
 {
-    auto orders_it = orders.find(order_id);
-    auto &levels_it = orders_it->second.level_it;
-    Order &deleting_order = orders_it->second.order;
-    if (notification)
-        event_handler.handleOrderDeleted(OrderDeleted{orders_it->second.order});
-    levels_it->second.deleteOrder(deleting_order);
-    if (levels_it->second.empty())
+    std::vector<Order> deleted_orders;
+    deleted_orders.reserve(orders.size());
+    for (LevelMap *levels :
+        {&bid_levels, &ask_levels, &stop_bid_levels, &stop_ask_levels, &trailing_stop_bid_levels, &trailing_stop_ask_levels})
+        deleteLevels(*levels, levels->begin(), levels->end(), deleted_orders);
+    if (!deleted_orders.empty())
+        event_handler.handleOrdersDeleted(event_handler.stamp(OrdersDeleted{symbol_id, std::move(deleted_orders)}));
+    VALIDATE_ORDERBOOK;
+}
+
+void MapOrderBook::deleteOrders(OrderSide side)
+{
+    deleteOrders(side, 0, std::numeric_limits<Price>::max());
+}
+
+void MapOrderBook::deleteOrders(OrderSide side, Price min_price, Price max_price)
+{
+    assert(max_price >= min_price && "Max price must be at least min price!");
+    std::vector<Order> deleted_orders;
+    bool ask = side == OrderSide::Ask;
+    for (LevelMap *levels : {ask ? &ask_levels : &bid_levels, ask ? &stop_ask_levels : &stop_bid_levels,
+             ask ? &trailing_stop_ask_levels : &trailing_stop_bid_levels})
+        deleteLevels(*levels, levels->lower_bound(min_price), levels->upper_bound(max_price), deleted_orders);
+    if (!deleted_orders.empty())
+        event_handler.handleOrdersDeleted(event_handler.stamp(OrdersDeleted{symbol_id, std::move(deleted_orders)}));
+    VALIDATE_ORDERBOOK;
+}
+
+void MapOrderBook::deleteOwnerOrders(uint32_t owner_id)
+{
+    auto owner_orders_it = owner_orders.find(owner_id);
+    if (owner_orders_it == owner_orders.end())
+        return;
+    OwnerOrders &owned = owner_orders_it->second;
+    std::vector<Order> deleted_orders;
+    while (!owned.empty())
     {
-        switch (deleting_order.getType())
+        Order &order = owned.front();
+        deleted_orders.push_back(order);
+        reportRelease(order, order.getOpenQuantity());
+        auto orders_it = orders.find(order.getOrderID());
+        removeFromLevel(orders_it->second);
+        // Erasing the order unlinks it from the list of orders of its owner.
+        orders.erase(orders_it);
+    }
+    owner_orders.erase(owner_orders_it);
+    if (!deleted_orders.empty())
+        event_handler.handleOrdersDeleted(event_handler.stamp(OrdersDeleted{symbol_id, std::move(deleted_orders)}));
+    VALIDATE_ORDERBOOK;
+}
+
+void MapOrderBook::deleteLevels(LevelMap &levels, LevelMap::iterator first, LevelMap::iterator last, std::vector<Order> &deleted_orders)
+{
+    for (auto levels_it = first; levels_it != last; ++levels_it)
+    {
+        size_t level_start = deleted_orders.size();
+        for (const Order &order : levels_it->second.getOrders())
         {
-        case OrderType::Limit:
-            deleting_order.isAsk() ? ask_levels.erase(levels_it) : bid_levels.erase(levels_it);
-            break;
-        case OrderType::Stop:
-        case OrderType::StopLimit:
-            deleting_order.isAsk() ? stop_ask_levels.erase(levels_it) : stop_bid_levels.erase(levels_it);
-            break;
-        case OrderType::TrailingStop:
-        case OrderType::TrailingStopLimit:
-            deleting_order.isAsk() ? trailing_stop_ask_levels.erase(levels_it) : trailing_stop_bid_levels.erase(levels_it);
-            break;
-        default:
-            assert(false && "Invalid order type!");
+            deleted_orders.push_back(order);
+            reportRelease(order, order.getOpenQuantity());
         }
+        // The orders must be unlinked from the level before they are erased from the index.
+        levels_it->second.clear();
+        for (size_t i = level_start; i < deleted_orders.size(); ++i)
+            orders.erase(orders.find(deleted_orders[i].getOrderID()));
+    }
+    levels.erase(first, last);
+}
+
+void MapOrderBook::expireOrders()
+{
+    deleteExpiredOrders(clock.now());
+    VALIDATE_ORDERBOOK;
+}
+
+void MapOrderBook::deleteDayOrders()
+{
+    deleteExpiryList(day_orders);
+    VALIDATE_ORDERBOOK;
+}
+
+void MapOrderBook::deleteExpiredOrders(uint64_t now)
+{
+    ExpiryList expired;
+    expiry_wheel.advance(now, expired);
+    deleteExpiryList(expired);
+}
+
+void MapOrderBook::deleteExpiryList(ExpiryList &expiring)
+{
+    if (expiring.empty())
+        return;
+    std::vector<Order> deleted_orders;
+    while (!expiring.empty())
+    {
+        Order &order = expiring.front();
+        expiring.pop_front();
+        deleted_orders.push_back(order);
+        reportRelease(order, order.getOpenQuantity());
+        auto orders_it = orders.find(order.getOrderID());
+        removeFromLevel(orders_it->second);
+        orders.erase(orders_it);
     }
+    event_handler.handleOrdersDeleted(event_handler.stamp(OrdersDeleted{symbol_id, std::move(deleted_orders)}));
+}
+
+void MapOrderBook::deleteOrder(uint64_t order_id, bool notification)
+{
+    auto orders_it = orders.find(order_id);
+    if (notification)
+        event_handler.handleOrderDeleted(event_handler.stamp(OrderDeleted{orders_it->second.order}));
+    removeFromLevel(orders_it->second);
     orders.erase(orders_it);
 }
 
-void MapOrderBook::replaceOrder(uint64_t order_id, uint64_t new_order_id, uint64_t new_price)
+LevelMap &MapOrderBook::getLevels(const Order &order)
+{
+    switch (order.getType())
+    {
+    case OrderType::Stop:
+    case OrderType::StopLimit:
+        return order.isAsk() ? stop_ask_levels : stop_bid_levels;
+    case OrderType::TrailingStop:
+    case OrderType::TrailingStopLimit:
+        return order.isAsk() ? trailing_stop_ask_levels : trailing_stop_bid_levels;
+    default:
+        assert(order.isLimit() && "Invalid order type!");
+        return order.isAsk() ? ask_levels : bid_levels;
+    }
+}
+
+DepthIndex *MapOrderBook::getDepth(const Order &order)
+{
+    if (!order.isLimit())
+        return nullptr;
+    return order.isAsk() ? &ask_depth : &bid_depth;
+}
+
+void MapOrderBook::removeFromLevel(OrderWrapper &wrapper)
+{
+    auto &levels_it = wrapper.level_it;
+    levels_it->second.deleteOrder(wrapper.order);
+    if (levels_it->second.empty())
+        getLevels(wrapper.order).erase(levels_it);
+}
+
+void MapOrderBook::replaceOrder(uint64_t order_id, uint64_t new_order_id, Price new_price)
 {
     auto orders_it = orders.find(order_id);
     Order new_order = orders_it->second.order;
     new_order.setOrderID(new_order_id);
     new_order.setPrice(new_price);
+    // The original order stays in the book if the new order would be rejected. Otherwise, the risk
+    // stage has already moved the open quantity of the original order to the new order.
+    RejectReason reason;
+    if (rejectOrder(new_order, orders_it->second.order.getOpenQuantity(), reason))
+    {
+        event_handler.handleOrderRejected(event_handler.stamp(OrderRejected{new_order, reason}));
+        return;
+    }
     deleteOrder(order_id, true);
-    addOrder(new_order);
-    activateStopOrders();
+    acceptOrder(new_order);
+}
+
+void MapOrderBook::amendOrder(uint64_t order_id, Quantity new_quantity, Price new_price)
+{
+    auto orders_it = orders.find(order_id);
+    OrderWrapper &wrapper = orders_it->second;
+    Order &amending_order = wrapper.order;
+    Quantity open_quantity = amending_order.getOpenQuantity();
+    bool reprice = amending_order.isLimit() && new_price != amending_order.getPrice();
+    // A halt applies to every amendment, while the price band and the risk stage only apply to an
+    // amendment that adds risk by repricing the order or increasing its quantity. The order is left
+    // as it was if the amendment is rejected.
+    bool checked = halted || reprice || new_quantity > open_quantity;
+    RejectReason reason;
+    if (checked)
+    {
+        Order amended_order = amending_order;
+        amended_order.setOpenQuantity(new_quantity);
+        amended_order.setPrice(new_price);
+        if (rejectOrder(amended_order, open_quantity, reason))
+        {
+            event_handler.handleOrderRejected(event_handler.stamp(OrderRejected{amended_order, reason}));
+            return;
+        }
+    }
+    // Reducing the quantity of an order does not affect its priority, so it can be amended in place.
+    if (!reprice && new_quantity <= open_quantity)
+    {
+        // The risk stage has not seen an amendment that only reduces the quantity of the order.
+        if (!checked)
+            reportRelease(amending_order, open_quantity - new_quantity);
+        Quantity visible_quantity = amending_order.getVisibleQuantity();
+        amending_order.setOpenQuantity(new_quantity);
+        amending_order.setPrice(new_price);
+        wrapper.level_it->second.reduceVolume(open_quantity - new_quantity, visible_quantity - amending_order.getVisibleQuantity());
+        event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{amending_order}));
+        VALIDATE_ORDERBOOK;
+        return;
+    }
+    // Otherwise, the order loses its priority and is moved to the back of its (possibly new) level.
+    removeFromLevel(wrapper);
+    amending_order.setOpenQuantity(new_quantity);
+    amending_order.setPrice(new_price);
+    event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{amending_order}));
+    if (reprice)
+    {
+        match(amending_order);
+        if (amending_order.isFilled())
+        {
+            event_handler.handleOrderDeleted(event_handler.stamp(OrderDeleted{amending_order}));
+            // Matching may have erased other orders from the index, so the iterator must be looked up again.
+            orders.erase(orders.find(order_id));
+            activateStopOrders();
+            VALIDATE_ORDERBOOK;
+            return;
+        }
+    }
+    amending_order.replenish();
+    Price level_price = amending_order.isLimit() ? amending_order.getPrice() : amending_order.getStopPrice();
+    LevelSide level_side = amending_order.isAsk() ? LevelSide::Ask : LevelSide::Bid;
+    wrapper.level_it = getLevels(amending_order)
+                           .try_emplace(level_price, level_price, level_side, symbol_id, getDepth(amending_order))
+                           .first;
+    wrapper.level_it->second.addOrder(amending_order);
+    checkGrowth();
+    if (reprice)
+        activateStopOrders();
     VALIDATE_ORDERBOOK;
 }
 
@@ -137,49 +467,80 @@ void MapOrderBook::addLimitOrder(Order &order)
 
     match(order);
     if (!order.isFilled() && !order.isIoc() && !order.isFok())
+    {
+        // An iceberg order displays a full tranche once it rests in the book.
+        order.replenish();
         insertLimitOrder(order);
+    }
     else
-        event_handler.handleOrderDeleted(OrderDeleted{order});
+    {
+        reportRelease(order, order.getOpenQuantity());
+        event_handler.handleOrderDeleted(event_handler.stamp(OrderDeleted{order}));
+    }
 }
 
 void MapOrderBook::insertLimitOrder(const Order &order)
 {
     if (order.isAsk())
     {
-        auto level_it = ask_levels.emplace_hint(ask_levels.begin(), std::piecewise_construct, std::make_tuple(order.getPrice()),
-            std::make_tuple(order.getPrice(), LevelSide::Ask, symbol_id));
-        auto [orders_it, success] = orders.emplace(order.getOrderID(), OrderWrapper{order, level_it});
-        level_it->second.addOrder(orders_it->second.order);
+        auto level_it =
+            ask_levels.try_emplace(ask_levels.begin(), order.getPrice(), order.getPrice(), LevelSide::Ask, symbol_id, &ask_depth);
+        insertOrder(order, level_it);
     }
     else
     {
-        auto level_it = bid_levels.emplace_hint(bid_levels.end(), std::piecewise_construct, std::make_tuple(order.getPrice()),
-            std::make_tuple(order.getPrice(), LevelSide::Bid, symbol_id));
-        auto [orders_it, success] = orders.emplace(order.getOrderID(), OrderWrapper{order, level_it});
-        level_it->second.addOrder(orders_it->second.order);
+        auto level_it = bid_levels.try_emplace(bid_levels.end(), order.getPrice(), order.getPrice(), LevelSide::Bid, symbol_id, &bid_depth);
+        insertOrder(order, level_it);
     }
 }
 
+void MapOrderBook::insertOrder(const Order &order, LevelMap::iterator level_it)
+{
+    auto [orders_it, success] = orders.emplace(order.getOrderID(), OrderWrapper{order, level_it});
+    level_it->second.addOrder(orders_it->second.order);
+    if (order.getOwnerID() != 0)
+        owner_orders[order.getOwnerID()].push_back(orders_it->second.order);
+    if (order.isGtd())
+        expiry_wheel.schedule(orders_it->second.order);
+    else if (order.isDay())
+        day_orders.push_back(orders_it->second.order);
+    checkGrowth();
+}
+
+void MapOrderBook::checkGrowth()
+{
+    size_t new_index_allocations = orderIndexAllocations(orders);
+    size_t new_pool_allocations = level_pool.getAllocatedBlocks();
+    if (new_index_allocations == index_allocations && new_pool_allocations == pool_allocations)
+        return;
+    ++growth_events;
+    if (capacity_hinted)
+        LOG_WARN("Orderbook for symbol {} exceeded its capacity hint and had to grow.", symbol_id);
+    index_allocations = new_index_allocations;
+    pool_allocations = new_pool_allocations;
+}
+
 void MapOrderBook::addMarketOrder(Order &order)
 {
-    order.setPrice(order.isAsk() ? 0 : std::numeric_limits<uint64_t>::max());
+    order.setPrice(order.isAsk() ? 0 : std::numeric_limits<Price>::max());
     match(order);
-    event_handler.handleOrderDeleted(OrderDeleted{order});
+    reportRelease(order, order.getOpenQuantity());
+    event_handler.handleOrderDeleted(event_handler.stamp(OrderDeleted{order}));
 }
 
 void MapOrderBook::addStopOrder(Order &order)
 {
     if (order.isTrailingStop() || order.isTrailingStopLimit())
         calculateStopPrice(order);
-    uint64_t market_price = order.isAsk() ? lastTradedPriceBid() : lastTradedPriceAsk();
-    uint64_t order_stop_price = order.getStopPrice();
+    Price market_price = order.isAsk() ? lastTradedPriceBid() : lastTradedPriceAsk();
+    Price order_stop_price = order.getStopPrice();
     uint8_t match = (order.isAsk() && market_price <= order_stop_price) + (order.isBid() && market_price >= order_stop_price);
     if (match)
     {
         order.setType((order.isStop() || order.isTrailingStop()) ? OrderType::Market : OrderType::Limit);
         order.setStopPrice(0);
         order.setTrailAmount(0);
-        event_handler.handleOrderUpdated(OrderUpdated{order});
+        event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{order}));
         order.isMarket() ? addMarketOrder(order) : addLimitOrder(order);
         return;
     }
@@ -190,21 +551,13 @@ void MapOrderBook::insertStopOrder(const Order &order)
 {
     if (order.isAsk())
     {
-        auto level_it = stop_ask_levels
-                            .emplace(std::piecewise_construct, std::make_tuple(order.getStopPrice()),
-                                std::make_tuple(order.getStopPrice(), LevelSide::Ask, symbol_id))
-                            .first;
-        auto [orders_it, success] = orders.emplace(order.getOrderID(), OrderWrapper{order, level_it});
-        level_it->second.addOrder(orders_it->second.order);
+        auto level_it = stop_ask_levels.try_emplace(order.getStopPrice(), order.getStopPrice(), LevelSide::Ask, symbol_id).first;
+        insertOrder(order, level_it);
     }
     else
     {
-        auto level_it = stop_bid_levels
-                            .emplace(std::piecewise_construct, std::make_tuple(order.getStopPrice()),
-                                std::make_tuple(order.getStopPrice(), LevelSide::Bid, symbol_id))
-                            .first;
-        auto [orders_it, success] = orders.emplace(order.getOrderID(), OrderWrapper{order, level_it});
-        level_it->second.addOrder(orders_it->second.order);
+        auto level_it = stop_bid_levels.try_emplace(order.getStopPrice(), order.getStopPrice(), LevelSide::Bid, symbol_id).first;
+        insertOrder(order, level_it);
     }
 }
 
@@ -212,46 +565,36 @@ void MapOrderBook::insertTrailingStopOrder(const Order &order)
 {
     if (order.isAsk())
     {
-        auto level_it = trailing_stop_ask_levels
-                            .emplace(std::piecewise_construct, std::make_tuple(order.getStopPrice()),
-                                std::make_tuple(order.getStopPrice(), LevelSide::Ask, symbol_id))
-                            .first;
-        auto [orders_it, success] = orders.emplace(order.getOrderID(), OrderWrapper{order, level_it});
-        level_it->second.addOrder(orders_it->second.order);
-        orders_it->second.level_it = level_it;
+        auto level_it = trailing_stop_ask_levels.try_emplace(order.getStopPrice(), order.getStopPrice(), LevelSide::Ask, symbol_id).first;
+        insertOrder(order, level_it);
     }
     else
     {
-        auto level_it = trailing_stop_bid_levels
-                            .emplace(std::piecewise_construct, std::make_tuple(order.getStopPrice()),
-                                std::make_tuple(order.getStopPrice(), LevelSide::Bid, symbol_id))
-                            .first;
-        auto [orders_it, success] = orders.emplace(order.getOrderID(), OrderWrapper{order, level_it});
-        level_it->second.addOrder(orders_it->second.order);
-        orders_it->second.level_it = level_it;
+        auto level_it = trailing_stop_bid_levels.try_emplace(order.getStopPrice(), order.getStopPrice(), LevelSide::Bid, symbol_id).first;
+        insertOrder(order, level_it);
     }
 }
 
-uint64_t MapOrderBook::calculateStopPrice(Order &order)
+Price MapOrderBook::calculateStopPrice(Order &order)
 {
     if (order.isAsk())
     {
-        uint64_t market_price = lastTradedPriceBid();
-        uint64_t trail_amount = order.getTrailAmount();
+        Price market_price = lastTradedPriceBid();
+        Price trail_amount = order.getTrailAmount();
         // Set the new stop price to zero if the trail amount meets or exceeds the market price.
-        uint64_t new_stop_price = market_price > trail_amount ? market_price - trail_amount : 0;
+        Price new_stop_price = market_price > trail_amount ? market_price - trail_amount : 0;
         order.setStopPrice(new_stop_price);
         return new_stop_price;
     }
     else
     {
-        uint64_t market_price = lastTradedPriceAsk();
-        uint64_t trail_amount = order.getTrailAmount();
-        // Set the new stop price to max 64-bit integer value if the sum of trail amount and the market
-        // price exceeds the max 64-bit integer value.
-        uint64_t new_stop_price = market_price < (std::numeric_limits<uint64_t>::max() - trail_amount)
-                                      ? market_price + trail_amount
-                                      : std::numeric_limits<uint64_t>::max();
+        Price market_price = lastTradedPriceAsk();
+        Price trail_amount = order.getTrailAmount();
+        // Set the new stop price to the max price value if the sum of trail amount and the market
+        // price exceeds the max price value.
+        Price new_stop_price = market_price < (std::numeric_limits<Price>::max() - trail_amount)
+                                   ? market_price + trail_amount
+                                   : std::numeric_limits<Price>::max();
         order.setStopPrice(new_stop_price);
         return new_stop_price;
     }
@@ -259,6 +602,15 @@ uint64_t MapOrderBook::calculateStopPrice(Order &order)
 
 void MapOrderBook::activateStopOrders()
 {
+    // Most commands do not move the market far enough to affect any stop orders.
+    // Skip the activation scan in that case - the trailing prices are updated exactly
+    // as a pass that activates and updates nothing would update them.
+    if (!stopOrdersTriggered())
+    {
+        trailing_bid_price = last_traded_price;
+        trailing_ask_price = last_traded_price;
+        return;
+    }
     bool activate = true;
     // Activating stop orders may result in trades which may result in more stop orders being activated.
     // Continue activating restart orders until there are none left or none can be activated.
@@ -271,11 +623,35 @@ void MapOrderBook::activateStopOrders()
     }
 }
 
+bool MapOrderBook::stopOrdersTriggered() const
+{
+    bool bid_triggered = (!stop_bid_levels.empty() || !trailing_stop_bid_levels.empty()) && nearestBidTrigger() <= lastTradedPriceAsk();
+    bool ask_triggered = (!stop_ask_levels.empty() || !trailing_stop_ask_levels.empty()) && nearestAskTrigger() >= lastTradedPriceBid();
+    bool bid_trailing = !trailing_stop_bid_levels.empty() && trailing_ask_price > lastTradedPriceAsk();
+    bool ask_trailing = !trailing_stop_ask_levels.empty() && trailing_bid_price < lastTradedPriceBid();
+    return bid_triggered || ask_triggered || bid_trailing || ask_trailing;
+}
+
+Price MapOrderBook::nearestBidTrigger() const
+{
+    Price stop_price = stop_bid_levels.empty() ? std::numeric_limits<Price>::max() : stop_bid_levels.begin()->first;
+    Price trailing_stop_price =
+        trailing_stop_bid_levels.empty() ? std::numeric_limits<Price>::max() : trailing_stop_bid_levels.begin()->first;
+    return std::min(stop_price, trailing_stop_price);
+}
+
+Price MapOrderBook::nearestAskTrigger() const
+{
+    Price stop_price = stop_ask_levels.empty() ? 0 : stop_ask_levels.rbegin()->first;
+    Price trailing_stop_price = trailing_stop_ask_levels.empty() ? 0 : trailing_stop_ask_levels.rbegin()->first;
+    return std::max(stop_price, trailing_stop_price);
+}
+
 bool MapOrderBook::activateBidStopOrders()
 {
     bool activated_orders = false;
     auto stop_levels_it = stop_bid_levels.begin();
-    uint64_t last_ask_price = lastTradedPriceAsk();
+    Price last_ask_price = lastTradedPriceAsk();
     while (stop_levels_it != stop_bid_levels.end() && stop_levels_it->first <= last_ask_price)
     {
         activated_orders = true;
@@ -298,7 +674,7 @@ bool MapOrderBook::activateBidStopOrders()
 bool MapOrderBook::activateAskStopOrders()
 {
     bool activated_orders = false;
-    uint64_t last_bid_price = lastTradedPriceBid();
+    Price last_bid_price = lastTradedPriceBid();
     auto stop_levels_it = stop_ask_levels.rbegin();
     while (stop_levels_it != stop_ask_levels.rend() && stop_levels_it->first >= last_bid_price)
     {
@@ -328,13 +704,13 @@ void MapOrderBook::activateStopOrder(Order order)
     if (order.isStop() || order.isTrailingStop())
     {
         order.setType(OrderType::Market);
-        event_handler.handleOrderUpdated(OrderUpdated{order});
+        event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{order}));
         addMarketOrder(order);
     }
     else
     {
         order.setType(OrderType::Limit);
-        event_handler.handleOrderUpdated(OrderUpdated{order});
+        event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{order}));
         addLimitOrder(order);
     }
 }
@@ -346,7 +722,7 @@ void MapOrderBook::updateBidStopOrders()
         trailing_ask_price = last_traded_price;
         return;
     }
-    std::map<uint64_t, Level> new_trailing_levels;
+    LevelMap new_trailing_levels{PoolAllocator<LevelMap::value_type>(&level_pool)};
     auto trailing_levels_it = trailing_stop_bid_levels.begin();
     // Update the stop price of all existing trailing stop orders.
     while (trailing_levels_it != trailing_stop_bid_levels.end())
@@ -354,17 +730,18 @@ void MapOrderBook::updateBidStopOrders()
         while (!trailing_levels_it->second.empty())
         {
             Order &stop_order = trailing_levels_it->second.front();
-            uint64_t new_stop_price = calculateStopPrice(stop_order);
-            auto new_trailing_levels_it = new_trailing_levels.emplace_hint(new_trailing_levels.begin(), std::piecewise_construct,
-                std::make_tuple(new_stop_price), std::make_tuple(new_stop_price, LevelSide::Bid, symbol_id));
+            Price new_stop_price = calculateStopPrice(stop_order);
+            auto new_trailing_levels_it = new_trailing_levels.try_emplace(
+                new_trailing_levels.begin(), new_stop_price, new_stop_price, LevelSide::Bid, symbol_id);
             orders.find(stop_order.getOrderID())->second.level_it = new_trailing_levels_it;
             trailing_levels_it->second.popFront();
             new_trailing_levels_it->second.addOrder(stop_order);
-            event_handler.handleOrderUpdated(OrderUpdated{stop_order});
+            event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{stop_order}));
         }
         ++trailing_levels_it;
     }
     std::swap(trailing_stop_bid_levels, new_trailing_levels);
+    checkGrowth();
     trailing_ask_price = last_traded_price;
 }
 
@@ -375,7 +752,7 @@ void MapOrderBook::updateAskStopOrders()
         trailing_bid_price = last_traded_price;
         return;
     }
-    std::map<uint64_t, Level> new_trailing_levels;
+    LevelMap new_trailing_levels{PoolAllocator<LevelMap::value_type>(&level_pool)};
     auto trailing_levels_it = trailing_stop_ask_levels.begin();
     // Update the stop price of all existing trailing stop orders.
     while (trailing_levels_it != trailing_stop_ask_levels.end())
@@ -383,25 +760,42 @@ void MapOrderBook::updateAskStopOrders()
         while (!trailing_levels_it->second.empty())
         {
             Order &stop_order = trailing_levels_it->second.front();
-            uint64_t new_stop_price = calculateStopPrice(stop_order);
-            auto new_trailing_levels_it = new_trailing_levels.emplace_hint(new_trailing_levels.end(), std::piecewise_construct,
-                std::make_tuple(new_stop_price), std::make_tuple(new_stop_price, LevelSide::Ask, symbol_id));
+            Price new_stop_price = calculateStopPrice(stop_order);
+            auto new_trailing_levels_it = new_trailing_levels.try_emplace(
+                new_trailing_levels.end(), new_stop_price, new_stop_price, LevelSide::Ask, symbol_id);
             orders.find(stop_order.getOrderID())->second.level_it = new_trailing_levels_it;
             trailing_levels_it->second.popFront();
             new_trailing_levels_it->second.addOrder(stop_order);
-            event_handler.handleOrderUpdated(OrderUpdated{stop_order});
+            event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{stop_order}));
         }
         ++trailing_levels_it;
     }
     std::swap(trailing_stop_ask_levels, new_trailing_levels);
+    checkGrowth();
     trailing_bid_price = last_traded_price;
 }
 
 void MapOrderBook::match(Order &order)
 {
+    if (in_auction)
+        return;
     // Order is a FOK order that cannot be filled.
     if (order.isFok() && !canMatchOrder(order))
         return;
+    // Only orders with an owner can self-trade. The owner is left as zero when
+    // self-trade prevention is disabled so that the check never passes.
+    uint32_t owner_id = self_trade_prevention == SelfTradePrevention::None ? 0 : order.getOwnerID();
+    switch (allocation_policy)
+    {
+    case AllocationPolicy::Fifo:
+        break;
+    case AllocationPolicy::ProRata:
+        matchProRata<false>(order, owner_id);
+        return;
+    case AllocationPolicy::TopOrderProRata:
+        matchProRata<true>(order, owner_id);
+        return;
+    }
     if (order.isAsk())
     {
         auto bid_levels_it = bid_levels.rbegin();
@@ -410,11 +804,21 @@ void MapOrderBook::match(Order &order)
         {
             Level &bid_level = bid_levels_it->second;
             Order &bid_order = bid_level.front();
-            uint64_t executing_price = bid_order.getPrice();
-            executeOrders(ask_order, bid_order, executing_price);
-            bid_level.reduceVolume(bid_order.getLastExecutedQuantity());
+            if (owner_id != 0 && bid_order.getOwnerID() == owner_id)
+            {
+                preventSelfTrade(ask_order, bid_order, bid_level);
+                bid_levels_it = bid_levels.rbegin();
+                continue;
+            }
+            Price executing_price = bid_order.getPrice();
+            // Only the displayed quantity of a resting order can be matched.
+            Quantity matched_quantity = std::min(ask_order.getOpenQuantity(), bid_order.getVisibleQuantity());
+            executeOrders(ask_order, bid_order, executing_price, matched_quantity);
+            bid_level.reduceVolume(matched_quantity, matched_quantity);
             if (bid_order.isFilled())
                 deleteOrder(bid_order.getOrderID(), true);
+            else if (bid_order.getVisibleQuantity() == 0)
+                replenishOrder(bid_order, bid_level);
             // Reset the level iterator - iterator may be invalidated if the order is deleted.
             bid_levels_it = bid_levels.rbegin();
         }
@@ -427,85 +831,482 @@ void MapOrderBook::match(Order &order)
         {
             Level &ask_level = ask_levels_it->second;
             Order &ask_order = ask_level.front();
-            uint64_t executing_price = ask_order.getPrice();
-            executeOrders(ask_order, bid_order, executing_price);
-            ask_level.reduceVolume(ask_order.getLastExecutedQuantity());
+            if (owner_id != 0 && ask_order.getOwnerID() == owner_id)
+            {
+                preventSelfTrade(bid_order, ask_order, ask_level);
+                ask_levels_it = ask_levels.begin();
+                continue;
+            }
+            Price executing_price = ask_order.getPrice();
+            Quantity matched_quantity = std::min(bid_order.getOpenQuantity(), ask_order.getVisibleQuantity());
+            executeOrders(bid_order, ask_order, executing_price, matched_quantity);
+            ask_level.reduceVolume(matched_quantity, matched_quantity);
             if (ask_order.isFilled())
                 deleteOrder(ask_order.getOrderID(), true);
+            else if (ask_order.getVisibleQuantity() == 0)
+                replenishOrder(ask_order, ask_level);
             // Reset the level iterator - iterator may be invalidated if the order is deleted.
             ask_levels_it = ask_levels.begin();
         }
     }
 }
 
-void MapOrderBook::executeOrders(Order &ask, Order &bid, uint64_t executing_price)
+template<bool TopOrderPriority>
+void MapOrderBook::matchProRata(Order &order, uint32_t owner_id)
+{
+    LevelMap &levels = order.isAsk() ? bid_levels : ask_levels;
+    // The price of the last level that a top order was filled at - prices are always positive.
+    Price top_order_price = 0;
+    while (!levels.empty() && !order.isFilled())
+    {
+        Level &level = order.isAsk() ? levels.rbegin()->second : levels.begin()->second;
+        if (order.isAsk() ? level.getPrice() < order.getPrice() : level.getPrice() > order.getPrice())
+            break;
+        // Levels may be deleted while matching, so the best level is looked up again after each step.
+        if (owner_id != 0 && preventSelfTrades(order, level, owner_id))
+            continue;
+        if constexpr (TopOrderPriority)
+        {
+            if (level.getPrice() != top_order_price)
+            {
+                top_order_price = level.getPrice();
+                Order &top_order = level.front();
+                executeResting(order, top_order, level, std::min(order.getOpenQuantity(), top_order.getVisibleQuantity()));
+                if (top_order.isFilled())
+                    deleteOrder(top_order.getOrderID(), true);
+                else if (top_order.getVisibleQuantity() == 0)
+                    replenishOrder(top_order, level);
+                continue;
+            }
+        }
+        allocateLevel(order, level);
+    }
+}
+
+/**
+ * Shares a quantity between orders in proportion to their quantities, rounding each share down.
+ * The quantity that is left over after rounding is allocated one at a time in order.
+ *
+ * @param quantities the quantity of each order, require that each quantity is positive.
+ * @param shares the share of each order, written by the function.
+ * @param n the number of orders.
+ * @param quantity the quantity to share, require that it is less than the sum of the quantities.
+ * @param total the sum of the quantities.
+ */
+static void allocateProRata(const Quantity *quantities, Quantity *shares, size_t n, Quantity quantity, Volume total)
 {
-    // Calculate the minimum quantity to match.
-    uint64_t matched_quantity = std::min(ask.getOpenQuantity(), bid.getOpenQuantity());
-    bid.execute(executing_price, matched_quantity);
-    ask.execute(executing_price, matched_quantity);
-    event_handler.handleOrderExecuted(ExecutedOrder{bid});
-    event_handler.handleOrderExecuted(ExecutedOrder{ask});
+    // The shares are computed in floating point so that the loop can be vectorised, which
+    // may round a share up by one - any excess is taken back from the last orders.
+    const double ratio = static_cast<double>(quantity) / static_cast<double>(total);
+    Volume allocated = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        shares[i] = static_cast<Quantity>(static_cast<double>(quantities[i]) * ratio);
+        allocated += shares[i];
+    }
+    for (size_t i = n; allocated > quantity; --i)
+    {
+        Quantity excess = static_cast<Quantity>(std::min<Volume>(allocated - quantity, shares[i - 1]));
+        shares[i - 1] -= excess;
+        allocated -= excess;
+    }
+    // Every share is below its quantity, so this takes a single pass unless the shares were rounded down further.
+    while (allocated < quantity)
+    {
+        for (size_t i = 0; i < n && allocated < quantity; ++i)
+        {
+            if (shares[i] < quantities[i])
+            {
+                ++shares[i];
+                ++allocated;
+            }
+        }
+    }
+}
+
+void MapOrderBook::allocateLevel(Order &order, Level &level)
+{
+    allocation_orders.clear();
+    allocation_quantities.clear();
+    Volume visible_volume = 0;
+    for (Order &resting_order : level.getOrders())
+    {
+        allocation_orders.push_back(&resting_order);
+        allocation_quantities.push_back(resting_order.getVisibleQuantity());
+        visible_volume += resting_order.getVisibleQuantity();
+    }
+    size_t n = allocation_orders.size();
+    allocations.resize(n);
+    if (order.getOpenQuantity() >= visible_volume)
+        std::copy(allocation_quantities.begin(), allocation_quantities.end(), allocations.begin());
+    else
+        allocateProRata(allocation_quantities.data(), allocations.data(), n, order.getOpenQuantity(), visible_volume);
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (allocations[i] > 0)
+            executeResting(order, *allocation_orders[i], level, allocations[i]);
+    }
+    // Icebergs are replenished before any orders are deleted since the level is deleted along with its last order.
+    for (size_t i = 0; i < n; ++i)
+    {
+        Order &resting_order = *allocation_orders[i];
+        if (allocations[i] > 0 && !resting_order.isFilled() && resting_order.getVisibleQuantity() == 0)
+            replenishOrder(resting_order, level);
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (allocations[i] > 0 && allocation_orders[i]->isFilled())
+            deleteOrder(allocation_orders[i]->getOrderID(), true);
+    }
+}
+
+void MapOrderBook::executeResting(Order &incoming, Order &resting, Level &level, Quantity matched_quantity)
+{
+    executeOrders(incoming, resting, resting.getPrice(), matched_quantity);
+    // Only the displayed quantity of a resting order is matched.
+    level.reduceVolume(matched_quantity, matched_quantity);
+}
+
+void MapOrderBook::executeOrders(Order &aggressor, Order &passive, Price executing_price, Quantity matched_quantity)
+{
+    aggressor.execute(executing_price, matched_quantity);
+    passive.execute(executing_price, matched_quantity);
+    recordTrade(executing_price, matched_quantity);
+    event_handler.handleTrade(event_handler.stamp(Trade{symbol_id, aggressor.getOrderID(), passive.getOrderID(), executing_price,
+        matched_quantity, aggressor.getSide(), aggressor.getOpenQuantity(), passive.getOpenQuantity()}));
+    reportExecution(aggressor);
+    reportExecution(passive);
     last_traded_price = executing_price;
 }
 
+void MapOrderBook::recordTrade(Price price, Quantity quantity)
+{
+    ++num_trades;
+    traded_volume += quantity;
+    traded_notional += static_cast<double>(price) * static_cast<double>(quantity);
+    if (num_trades == 1)
+        open_price = high_price = low_price = price;
+    high_price = std::max(high_price, price);
+    low_price = std::min(low_price, price);
+    if (bar_interval == 0)
+        return;
+    uint64_t now = clock.now();
+    if (open_bar.num_trades != 0 && now >= open_bar.end_time)
+        sendBar();
+    if (open_bar.num_trades == 0)
+    {
+        open_bar.start_time = now - now % bar_interval;
+        open_bar.end_time = open_bar.start_time + bar_interval;
+        open_bar.open_price = open_bar.high_price = open_bar.low_price = price;
+    }
+    open_bar.high_price = std::max(open_bar.high_price, price);
+    open_bar.low_price = std::min(open_bar.low_price, price);
+    open_bar.close_price = price;
+    open_bar.volume += quantity;
+    ++open_bar.num_trades;
+}
+
+void MapOrderBook::sendBar()
+{
+    event_handler.handleTradeBar(event_handler.stamp(open_bar));
+    open_bar = TradeBar{symbol_id, 0, 0};
+}
+
+void MapOrderBook::setBarInterval(uint64_t bar_interval_)
+{
+    if (open_bar.num_trades != 0)
+        sendBar();
+    bar_interval = bar_interval_;
+}
+
+void MapOrderBook::closeBars()
+{
+    if (open_bar.num_trades != 0 && clock.now() >= open_bar.end_time)
+        sendBar();
+}
+
+void MapOrderBook::uncrossAuction()
+{
+    in_auction = false;
+    Price price = auctionPrice();
+    if (price == 0)
+    {
+        VALIDATE_ORDERBOOK;
+        return;
+    }
+    std::vector<Order> executed_orders;
+    std::vector<Order> deleted_orders;
+    // Execute the best bid against the best ask at the auction price until one side no longer crosses it.
+    while (!bid_levels.empty() && !ask_levels.empty() && bid_levels.rbegin()->first >= price && ask_levels.begin()->first <= price)
+    {
+        Level &bid_level = bid_levels.rbegin()->second;
+        Level &ask_level = ask_levels.begin()->second;
+        Order &bid_order = bid_level.front();
+        Order &ask_order = ask_level.front();
+        // Hidden quantity takes part in the auction.
+        Quantity matched_quantity = std::min(bid_order.getOpenQuantity(), ask_order.getOpenQuantity());
+        Quantity bid_visible_quantity = bid_order.getVisibleQuantity();
+        Quantity ask_visible_quantity = ask_order.getVisibleQuantity();
+        bid_order.execute(price, matched_quantity);
+        ask_order.execute(price, matched_quantity);
+        recordTrade(price, matched_quantity);
+        bid_level.reduceVolume(matched_quantity, bid_visible_quantity - bid_order.getVisibleQuantity());
+        ask_level.reduceVolume(matched_quantity, ask_visible_quantity - ask_order.getVisibleQuantity());
+        executed_orders.push_back(bid_order);
+        executed_orders.push_back(ask_order);
+        reportExecution(bid_order);
+        reportExecution(ask_order);
+        for (auto [order, level] : {std::pair{&bid_order, &bid_level}, std::pair{&ask_order, &ask_level}})
+        {
+            if (order->isFilled())
+            {
+                deleted_orders.push_back(*order);
+                deleteOrder(order->getOrderID(), false);
+            }
+            else if (order->getVisibleQuantity() == 0)
+            {
+                level->replenishOrder(*order);
+            }
+        }
+    }
+    last_traded_price = price;
+    event_handler.handleOrdersExecuted(event_handler.stamp(OrdersExecuted{symbol_id, std::move(executed_orders)}));
+    if (!deleted_orders.empty())
+        event_handler.handleOrdersDeleted(event_handler.stamp(OrdersDeleted{symbol_id, std::move(deleted_orders)}));
+    activateStopOrders();
+    VALIDATE_ORDERBOOK;
+}
+
+Price MapOrderBook::auctionPrice() const
+{
+    if (bid_levels.empty() || ask_levels.empty() || bid_levels.rbegin()->first < ask_levels.begin()->first)
+        return 0;
+    Price best_bid = bid_levels.rbegin()->first;
+    Price best_ask = ask_levels.begin()->first;
+    Price auction_price = 0;
+    Volume max_volume = 0;
+    Volume min_imbalance = 0;
+    Price min_distance = 0;
+    auto consider = [&](Price price) {
+        Volume bid_volume = bid_depth.volumeAtOrAbove(price);
+        Volume ask_volume = ask_depth.volumeAtOrBelow(price);
+        Volume volume = std::min(bid_volume, ask_volume);
+        Volume imbalance = bid_volume > ask_volume ? bid_volume - ask_volume : ask_volume - bid_volume;
+        Price distance = price > last_traded_price ? price - last_traded_price : last_traded_price - price;
+        bool better = auction_price == 0 || volume > max_volume || (volume == max_volume && imbalance < min_imbalance) ||
+                      (volume == max_volume && imbalance == min_imbalance &&
+                          (distance < min_distance || (distance == min_distance && price < auction_price)));
+        if (better)
+        {
+            auction_price = price;
+            max_volume = volume;
+            min_imbalance = imbalance;
+            min_distance = distance;
+        }
+    };
+    // The executed volume only changes at the price of a level, so only the prices of the
+    // crossed levels need to be considered.
+    for (auto bid_levels_it = bid_levels.rbegin(); bid_levels_it != bid_levels.rend() && bid_levels_it->first >= best_ask; ++bid_levels_it)
+        consider(bid_levels_it->first);
+    for (auto ask_levels_it = ask_levels.begin(); ask_levels_it != ask_levels.end() && ask_levels_it->first <= best_bid; ++ask_levels_it)
+        consider(ask_levels_it->first);
+    return auction_price;
+}
+
+void MapOrderBook::replenishOrder(Order &order, Level &level)
+{
+    level.replenishOrder(order);
+    level.moveToBack(order);
+    event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{order}));
+}
+
+void MapOrderBook::preventSelfTrade(Order &incoming, Order &resting, Level &resting_level)
+{
+    switch (self_trade_prevention)
+    {
+    case SelfTradePrevention::None:
+        break;
+    case SelfTradePrevention::CancelNewest:
+        reportRelease(incoming, incoming.getOpenQuantity());
+        incoming.cancel(incoming.getOpenQuantity());
+        break;
+    case SelfTradePrevention::CancelOldest:
+        reportRelease(resting, resting.getOpenQuantity());
+        deleteOrder(resting.getOrderID(), true);
+        break;
+    case SelfTradePrevention::CancelBoth:
+        reportRelease(incoming, incoming.getOpenQuantity());
+        incoming.cancel(incoming.getOpenQuantity());
+        reportRelease(resting, resting.getOpenQuantity());
+        deleteOrder(resting.getOrderID(), true);
+        break;
+    case SelfTradePrevention::Decrement:
+        Quantity cancelled_quantity = std::min(incoming.getOpenQuantity(), resting.getOpenQuantity());
+        Quantity visible_quantity = resting.getVisibleQuantity();
+        reportRelease(incoming, cancelled_quantity);
+        reportRelease(resting, cancelled_quantity);
+        incoming.cancel(cancelled_quantity);
+        resting.cancel(cancelled_quantity);
+        resting_level.reduceVolume(cancelled_quantity, visible_quantity - resting.getVisibleQuantity());
+        if (resting.isFilled())
+            deleteOrder(resting.getOrderID(), true);
+        else
+            event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{resting}));
+        // An incoming order with no open quantity left is deleted by the caller.
+        if (!incoming.isFilled())
+            event_handler.handleOrderUpdated(event_handler.stamp(OrderUpdated{incoming}));
+        break;
+    }
+}
+
+bool MapOrderBook::preventSelfTrades(Order &incoming, Level &level, uint32_t owner_id)
+{
+    allocation_orders.clear();
+    for (Order &resting_order : level.getOrders())
+    {
+        if (resting_order.getOwnerID() == owner_id)
+            allocation_orders.push_back(&resting_order);
+    }
+    // The level is only deleted along with the last of these orders, so it stays valid inside the loop.
+    for (Order *resting_order : allocation_orders)
+    {
+        if (incoming.isFilled())
+            break;
+        preventSelfTrade(incoming, *resting_order, level);
+    }
+    return !allocation_orders.empty();
+}
+
 bool MapOrderBook::canMatchOrder(const Order &order) const
 {
-    uint64_t price = order.getPrice();
-    uint64_t quantity_required = order.getOpenQuantity();
-    uint64_t quantity_available = 0;
+    Volume quantity_available =
+        order.isAsk() ? bid_depth.volumeAtOrAbove(order.getPrice()) : ask_depth.volumeAtOrBelow(order.getPrice());
+    if (quantity_available < order.getOpenQuantity())
+        return false;
+    // The resting orders of the owner are never traded with when self-trade prevention is enabled.
+    uint32_t owner_id = self_trade_prevention == SelfTradePrevention::None ? 0 : order.getOwnerID();
+    if (owner_id == 0)
+        return true;
+    auto owner_orders_it = owner_orders.find(owner_id);
+    if (owner_orders_it == owner_orders.end() || owner_orders_it->second.empty())
+        return true;
+    return canMatchOrderWithoutSelfTrade(order, owner_id);
+}
+
+bool MapOrderBook::canMatchOrderWithoutSelfTrade(const Order &order, uint32_t owner_id) const
+{
+    // Only cancelling the resting order lets the order trade past it. Every other mode cancels
+    // some of the order itself, so the order cannot be filled once it reaches a level with an
+    // order of its owner - even if it might have been filled before reaching that order.
+    bool skip_owner_orders = self_trade_prevention == SelfTradePrevention::CancelOldest;
+    Volume quantity_available = 0;
+    auto consume = [&](const Level &level) {
+        for (const Order &resting_order : level.getOrders())
+        {
+            if (resting_order.getOwnerID() != owner_id)
+                quantity_available += resting_order.getOpenQuantity();
+            else if (!skip_owner_orders)
+                return false;
+        }
+        return true;
+    };
     if (order.isAsk())
     {
-        auto bid_levels_it = bid_levels.rbegin();
-        while (bid_levels_it != bid_levels.rend() && bid_levels_it->first >= price)
+        for (auto levels_it = bid_levels.rbegin();
+             levels_it != bid_levels.rend() && levels_it->first >= order.getPrice() && quantity_available < order.getOpenQuantity();
+             ++levels_it)
         {
-            uint64_t level_volume = bid_levels_it->second.getVolume();
-            uint64_t quantity_needed = quantity_required - quantity_available;
-            quantity_available += std::min(level_volume, quantity_needed);
-            if (quantity_available >= quantity_required)
-                return true;
+            if (!consume(levels_it->second))
+                return false;
         }
     }
     else
     {
-        auto ask_levels_it = ask_levels.begin();
-        while (ask_levels_it != ask_levels.end() && ask_levels_it->first <= price)
+        for (auto levels_it = ask_levels.begin();
+             levels_it != ask_levels.end() && levels_it->first <= order.getPrice() && quantity_available < order.getOpenQuantity();
+             ++levels_it)
         {
-            uint64_t level_volume = ask_levels_it->second.getVolume();
-            uint64_t quantity_needed = quantity_required - quantity_available;
-            quantity_available += std::min(level_volume, quantity_needed);
-            if (quantity_available >= quantity_required)
-                return true;
+            if (!consume(levels_it->second))
+                return false;
         }
     }
-    return false;
+    return quantity_available >= order.getOpenQuantity();
 }
 
 // LCOV_EXCL_START
+BookSnapshot MapOrderBook::snapshot() const
+{
+    auto copy_levels = [](const LevelMap &levels, std::vector<BookSnapshot::LevelSnapshot> &level_snapshots) {
+        level_snapshots.reserve(levels.size());
+        for (const auto &[price, level] : levels)
+            level_snapshots.push_back({price, level.getDisplayedVolume()});
+    };
+    BookSnapshot book_snapshot;
+    book_snapshot.symbol_id = symbol_id;
+    book_snapshot.last_traded_price = last_traded_price;
+    copy_levels(bid_levels, book_snapshot.bid_levels);
+    copy_levels(ask_levels, book_snapshot.ask_levels);
+    copy_levels(stop_bid_levels, book_snapshot.stop_bid_levels);
+    copy_levels(stop_ask_levels, book_snapshot.stop_ask_levels);
+    copy_levels(trailing_stop_bid_levels, book_snapshot.trailing_stop_bid_levels);
+    copy_levels(trailing_stop_ask_levels, book_snapshot.trailing_stop_ask_levels);
+    return book_snapshot;
+}
+
+BestBidOffer MapOrderBook::bestBidOffer() const
+{
+    BestBidOffer best_bid_offer;
+    best_bid_offer.symbol_id = symbol_id;
+    if (!bid_levels.empty())
+    {
+        best_bid_offer.bid_price = bid_levels.rbegin()->first;
+        best_bid_offer.bid_volume = bid_levels.rbegin()->second.getDisplayedVolume();
+    }
+    if (!ask_levels.empty())
+    {
+        best_bid_offer.ask_price = ask_levels.begin()->first;
+        best_bid_offer.ask_volume = ask_levels.begin()->second.getDisplayedVolume();
+    }
+    return best_bid_offer;
+}
+
+BookDepth MapOrderBook::depth(size_t max_levels) const
+{
+    auto copy_levels = [=](auto first, auto last, std::vector<BookSnapshot::LevelSnapshot> &level_snapshots) {
+        for (; first != last && level_snapshots.size() < max_levels; ++first)
+            level_snapshots.push_back({first->first, first->second.getDisplayedVolume()});
+    };
+    BookDepth book_depth;
+    book_depth.symbol_id = symbol_id;
+    book_depth.bid_levels.reserve(std::min(max_levels, bid_levels.size()));
+    book_depth.ask_levels.reserve(std::min(max_levels, ask_levels.size()));
+    copy_levels(bid_levels.rbegin(), bid_levels.rend(), book_depth.bid_levels);
+    copy_levels(ask_levels.begin(), ask_levels.end(), book_depth.ask_levels);
+    return book_depth;
+}
+
+SymbolStatistics MapOrderBook::statistics() const
+{
+    SymbolStatistics symbol_statistics;
+    symbol_statistics.symbol_id = symbol_id;
+    symbol_statistics.last_traded_price = last_traded_price;
+    symbol_statistics.num_orders = orders.size();
+    symbol_statistics.num_bid_levels = bid_levels.size();
+    symbol_statistics.num_ask_levels = ask_levels.size();
+    symbol_statistics.halted = halted;
+    symbol_statistics.in_auction = in_auction;
+    symbol_statistics.num_trades = num_trades;
+    symbol_statistics.traded_volume = traded_volume;
+    symbol_statistics.open_price = open_price;
+    symbol_statistics.high_price = high_price;
+    symbol_statistics.low_price = low_price;
+    symbol_statistics.vwap = traded_volume == 0 ? 0 : traded_notional / static_cast<double>(traded_volume);
+    return symbol_statistics;
+}
+
 std::string MapOrderBook::toString() const
 {
-    std::string book_string;
-    book_string += "SYMBOL ID : " + std::to_string(symbol_id) + "\n";
-    book_string += "LAST TRADED PRICE: " + std::to_string(last_traded_price) + "\n";
-    book_string += "BID ORDERS\n";
-    for (const auto &[price, level] : bid_levels)
-        book_string += level.toString();
-    book_string += "ASK ORDERS\n";
-    for (const auto &[price, level] : ask_levels)
-        book_string += level.toString();
-    book_string += "BID STOP ORDERS\n";
-    for (const auto &[price, level] : stop_bid_levels)
-        book_string += level.toString();
-    book_string += "ASK STOP ORDERS\n";
-    for (const auto &[price, level] : stop_ask_levels)
-        book_string += level.toString();
-    book_string += "BID TRAILING STOP ORDERS\n";
-    for (const auto &[price, level] : trailing_stop_bid_levels)
-        book_string += level.toString();
-    book_string += "ASK TRAILING STOP ORDERS\n";
-    for (const auto &[price, level] : trailing_stop_ask_levels)
-        book_string += level.toString();
-    return book_string;
+    return snapshot().toString();
 }
 
 void MapOrderBook::dumpBook(const std::string &path) const
@@ -530,9 +1331,19 @@ void MapOrderBook::validateOrderBook() const
 
 void MapOrderBook::validateLimitOrders() const
 {
-    uint64_t current_best_ask = ask_levels.empty() ? std::numeric_limits<uint64_t>::max() : ask_levels.begin()->first;
-    uint64_t current_best_bid = bid_levels.empty() ? 0 : bid_levels.rbegin()->first;
-    assert(current_best_ask > current_best_bid && "Best bid price should never be lower than best ask price!");
+    Price current_best_ask = ask_levels.empty() ? std::numeric_limits<Price>::max() : ask_levels.begin()->first;
+    Price current_best_bid = bid_levels.empty() ? 0 : bid_levels.rbegin()->first;
+    // The book may only be crossed during an auction.
+    assert((in_auction || current_best_ask > current_best_bid) && "Best bid price should never be lower than best ask price!");
+
+    Volume ask_volume = 0;
+    for (const auto &[price, level] : ask_levels)
+        ask_volume += level.getVolume();
+    assert(ask_volume == ask_depth.totalVolume() && "Ask depth index has incorrect volume!");
+    Volume bid_volume = 0;
+    for (const auto &[price, level] : bid_levels)
+        bid_volume += level.getVolume();
+    assert(bid_volume == bid_depth.totalVolume() && "Bid depth index has incorrect volume!");
 
     for (const auto &[price, level] : ask_levels)
     {
@@ -0,0 +1,28 @@
+#include <cassert>
+#include "node_pool.h"
+
+namespace RapidTrader {
+NodePool::NodePool(size_t block_size_)
+    : free_list(nullptr)
+    , capacity(0)
+    , allocated_blocks(0)
+{
+    assert(block_size_ > 0 && "Block size must be positive!");
+    // Round the block size up so that every block in a chunk is suitably aligned.
+    size_t alignment = alignof(std::max_align_t);
+    block_size = std::max(block_size_, sizeof(FreeBlock));
+    block_size = (block_size + alignment - 1) / alignment * alignment;
+}
+
+void NodePool::grow(size_t num_blocks)
+{
+    // Memory allocated by new is suitably aligned for any fundamental type.
+    auto chunk = std::make_unique<std::byte[]>(num_blocks * block_size);
+    // Push the blocks onto the free list in reverse so that they are handed out in address order.
+    for (size_t i = num_blocks; i > 0; --i)
+        deallocate(chunk.get() + (i - 1) * block_size);
+    chunks.push_back(std::move(chunk));
+    capacity += num_blocks;
+    allocated_blocks += num_blocks;
+}
+} // namespace RapidTrader
@@ -2,146 +2,206 @@
 #include "order.h"
 
 namespace RapidTrader {
-Order::Order(OrderType type_, OrderSide side_, OrderTimeInForce time_in_force_, uint32_t symbol_id_, uint64_t price_, uint64_t stop_price_,
-    uint64_t trail_amount_, uint64_t quantity_, uint64_t id_)
-    : type(type_)
-    , side(side_)
-    , time_in_force(time_in_force_)
-    , symbol_id(symbol_id_)
+Order::Order(OrderType type_, OrderSide side_, OrderTimeInForce time_in_force_, uint32_t symbol_id_, Price price_, Price stop_price_,
+    Price trail_amount_, Quantity quantity_, uint64_t id_, uint32_t owner_id_, uint64_t expiry_time_)
+    : id(id_)
+    , expiry_time(expiry_time_)
     , price(price_)
     , stop_price(stop_price_)
     , trail_amount(trail_amount_)
     , quantity(quantity_)
-    , id(id_)
+    , symbol_id(symbol_id_)
+    , owner_id(owner_id_)
+    , type(type_)
+    , side(side_)
+    , time_in_force(time_in_force_)
 {
     last_executed_price = 0;
     executed_quantity = 0;
     open_quantity = quantity;
     last_executed_price = 0;
     last_executed_quantity = 0;
+    display_quantity = 0;
+    visible_quantity = 0;
     VALIDATE_ORDER;
 }
 
-Order Order::marketAskOrder(uint64_t order_id, uint32_t symbol_id, uint64_t quantity, OrderTimeInForce time_in_force)
+Order Order::marketAskOrder(uint64_t order_id, uint32_t symbol_id, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id)
+{
+    assert((time_in_force == OrderTimeInForce::FOK || time_in_force == OrderTimeInForce::IOC) &&
+           "Market orders must have FOK or IOC time in force!");
+    assert(order_id > 0 && "Order ID must be positive!");
+    assert(symbol_id > 0 && "Symbol ID must be positive!");
+    assert(quantity > 0 && "Quantity must be positive!");
+    return Order{OrderType::Market, OrderSide::Ask, time_in_force, symbol_id, 0, 0, 0, quantity, order_id, owner_id};
+}
+
+Order Order::marketBidOrder(uint64_t order_id, uint32_t symbol_id, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id)
+{
+    assert((time_in_force == OrderTimeInForce::FOK || time_in_force == OrderTimeInForce::IOC) &&
+           "Market orders must have FOK or IOC time in force!");
+    assert(order_id > 0 && "Order ID must be positive!");
+    assert(symbol_id > 0 && "Symbol ID must be positive!");
+    assert(quantity > 0 && "Quantity must be positive!");
+    return Order{OrderType::Market, OrderSide::Bid, time_in_force, symbol_id, 0, 0, 0, quantity, order_id, owner_id};
+}
+
+Order Order::limitAskOrder(
+    uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id)
 {
-    assert(time_in_force != OrderTimeInForce::GTC && "Market orders cannot gave GTC time in force!");
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
+    assert(price > 0 && "Price must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::Market, OrderSide::Ask, time_in_force, symbol_id, 0, 0, 0, quantity, order_id};
+    return Order{OrderType::Limit, OrderSide::Ask, time_in_force, symbol_id, price, 0, 0, quantity, order_id, owner_id};
 }
 
-Order Order::marketBidOrder(uint64_t order_id, uint32_t symbol_id, uint64_t quantity, OrderTimeInForce time_in_force)
+Order Order::limitBidOrder(
+    uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id)
 {
-    assert(time_in_force != OrderTimeInForce::GTC && "Market orders cannot gave GTC time in force!");
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
+    assert(price > 0 && "Price must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::Market, OrderSide::Bid, time_in_force, symbol_id, 0, 0, 0, quantity, order_id};
+    return Order{OrderType::Limit, OrderSide::Bid, time_in_force, symbol_id, price, 0, 0, quantity, order_id, owner_id};
 }
 
-Order Order::limitAskOrder(uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t quantity, OrderTimeInForce time_in_force)
+Order Order::gtdAskOrder(
+    uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, uint64_t expiry_time, uint32_t owner_id)
 {
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
     assert(price > 0 && "Price must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::Limit, OrderSide::Ask, time_in_force, symbol_id, price, 0, 0, quantity, order_id};
+    assert(expiry_time > 0 && "Expiry time must be positive!");
+    return Order{
+        OrderType::Limit, OrderSide::Ask, OrderTimeInForce::GTD, symbol_id, price, 0, 0, quantity, order_id, owner_id, expiry_time};
 }
 
-Order Order::limitBidOrder(uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t quantity, OrderTimeInForce time_in_force)
+Order Order::gtdBidOrder(
+    uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, uint64_t expiry_time, uint32_t owner_id)
 {
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
     assert(price > 0 && "Price must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::Limit, OrderSide::Bid, time_in_force, symbol_id, price, 0, 0, quantity, order_id};
+    assert(expiry_time > 0 && "Expiry time must be positive!");
+    return Order{
+        OrderType::Limit, OrderSide::Bid, OrderTimeInForce::GTD, symbol_id, price, 0, 0, quantity, order_id, owner_id, expiry_time};
+}
+
+Order Order::icebergAskOrder(uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, Quantity display_quantity,
+    OrderTimeInForce time_in_force, uint32_t owner_id)
+{
+    assert(display_quantity > 0 && display_quantity <= quantity && "Display quantity must be positive and at most quantity!");
+    Order order = limitAskOrder(order_id, symbol_id, price, quantity, time_in_force, owner_id);
+    order.display_quantity = display_quantity;
+    order.visible_quantity = display_quantity;
+    return order;
+}
+
+Order Order::icebergBidOrder(uint64_t order_id, uint32_t symbol_id, Price price, Quantity quantity, Quantity display_quantity,
+    OrderTimeInForce time_in_force, uint32_t owner_id)
+{
+    assert(display_quantity > 0 && display_quantity <= quantity && "Display quantity must be positive and at most quantity!");
+    Order order = limitBidOrder(order_id, symbol_id, price, quantity, time_in_force, owner_id);
+    order.display_quantity = display_quantity;
+    order.visible_quantity = display_quantity;
+    return order;
 }
 
-Order Order::stopAskOrder(uint64_t order_id, uint32_t symbol_id, uint64_t stop_price, uint64_t quantity, OrderTimeInForce time_in_force)
+Order Order::stopAskOrder(
+    uint64_t order_id, uint32_t symbol_id, Price stop_price, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id)
 {
-    assert(time_in_force != OrderTimeInForce::GTC && "Stop orders cannot gave GTC time in force!");
+    assert((time_in_force == OrderTimeInForce::FOK || time_in_force == OrderTimeInForce::IOC) &&
+           "Stop orders must have FOK or IOC time in force!");
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
     assert(stop_price > 0 && "Price must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::Stop, OrderSide::Ask, time_in_force, symbol_id, 0, stop_price, 0, quantity, order_id};
+    return Order{OrderType::Stop, OrderSide::Ask, time_in_force, symbol_id, 0, stop_price, 0, quantity, order_id, owner_id};
 }
 
-Order Order::stopBidOrder(uint64_t order_id, uint32_t symbol_id, uint64_t stop_price, uint64_t quantity, OrderTimeInForce time_in_force)
+Order Order::stopBidOrder(
+    uint64_t order_id, uint32_t symbol_id, Price stop_price, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id)
 {
-    assert(time_in_force != OrderTimeInForce::GTC && "Stop orders cannot gave GTC time in force!");
+    assert((time_in_force == OrderTimeInForce::FOK || time_in_force == OrderTimeInForce::IOC) &&
+           "Stop orders must have FOK or IOC time in force!");
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
     assert(stop_price > 0 && "Stop Price must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::Stop, OrderSide::Bid, time_in_force, symbol_id, 0, stop_price, 0, quantity, order_id};
+    return Order{OrderType::Stop, OrderSide::Bid, time_in_force, symbol_id, 0, stop_price, 0, quantity, order_id, owner_id};
 }
 
-Order Order::stopLimitAskOrder(
-    uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t stop_price, uint64_t quantity, OrderTimeInForce time_in_force)
+Order Order::stopLimitAskOrder(uint64_t order_id, uint32_t symbol_id, Price price, Price stop_price, Quantity quantity,
+    OrderTimeInForce time_in_force, uint32_t owner_id)
 {
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
     assert(price > 0 && "Price must be positive!");
     assert(stop_price > 0 && "Stop Price must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::StopLimit, OrderSide::Ask, time_in_force, symbol_id, price, stop_price, 0, quantity, order_id};
+    return Order{OrderType::StopLimit, OrderSide::Ask, time_in_force, symbol_id, price, stop_price, 0, quantity, order_id, owner_id};
 }
 
-Order Order::stopLimitBidOrder(
-    uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t stop_price, uint64_t quantity, OrderTimeInForce time_in_force)
+Order Order::stopLimitBidOrder(uint64_t order_id, uint32_t symbol_id, Price price, Price stop_price, Quantity quantity,
+    OrderTimeInForce time_in_force, uint32_t owner_id)
 {
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
     assert(price > 0 && "Price must be positive!");
     assert(stop_price > 0 && "Stop Price must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::StopLimit, OrderSide::Bid, time_in_force, symbol_id, price, stop_price, 0, quantity, order_id};
+    return Order{OrderType::StopLimit, OrderSide::Bid, time_in_force, symbol_id, price, stop_price, 0, quantity, order_id, owner_id};
 }
 
 Order Order::trailingStopAskOrder(
-    uint64_t order_id, uint32_t symbol_id, uint64_t trail_amount, uint64_t quantity, OrderTimeInForce time_in_force)
+    uint64_t order_id, uint32_t symbol_id, Price trail_amount, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id)
 {
-    assert(time_in_force != OrderTimeInForce::GTC && "Stop orders cannot gave GTC time in force!");
+    assert((time_in_force == OrderTimeInForce::FOK || time_in_force == OrderTimeInForce::IOC) &&
+           "Stop orders must have FOK or IOC time in force!");
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
     assert(trail_amount > 0 && "Stop Price must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::TrailingStop, OrderSide::Ask, time_in_force, symbol_id, 0, 0, trail_amount, quantity, order_id};
+    return Order{OrderType::TrailingStop, OrderSide::Ask, time_in_force, symbol_id, 0, 0, trail_amount, quantity, order_id, owner_id};
 }
 
 Order Order::trailingStopBidOrder(
-    uint64_t order_id, uint32_t symbol_id, uint64_t trail_amount, uint64_t quantity, OrderTimeInForce time_in_force)
+    uint64_t order_id, uint32_t symbol_id, Price trail_amount, Quantity quantity, OrderTimeInForce time_in_force, uint32_t owner_id)
 {
-    assert(time_in_force != OrderTimeInForce::GTC && "Stop orders cannot gave GTC time in force!");
+    assert((time_in_force == OrderTimeInForce::FOK || time_in_force == OrderTimeInForce::IOC) &&
+           "Stop orders must have FOK or IOC time in force!");
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
     assert(trail_amount > 0 && "Stop Price must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::TrailingStop, OrderSide::Bid, time_in_force, symbol_id, 0, 0, trail_amount, quantity, order_id};
+    return Order{OrderType::TrailingStop, OrderSide::Bid, time_in_force, symbol_id, 0, 0, trail_amount, quantity, order_id, owner_id};
 }
 
-Order Order::trailingStopLimitAskOrder(
-    uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t trail_amount, uint64_t quantity, OrderTimeInForce time_in_force)
+Order Order::trailingStopLimitAskOrder(uint64_t order_id, uint32_t symbol_id, Price price, Price trail_amount, Quantity quantity,
+    OrderTimeInForce time_in_force, uint32_t owner_id)
 {
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
     assert(price > 0 && "Price must be positive!");
     assert(trail_amount > 0 && "Trail amount must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::TrailingStopLimit, OrderSide::Ask, time_in_force, symbol_id, price, 0, trail_amount, quantity, order_id};
+    return Order{
+        OrderType::TrailingStopLimit, OrderSide::Ask, time_in_force, symbol_id, price, 0, trail_amount, quantity, order_id, owner_id};
 }
 
-Order Order::trailingStopLimitBidOrder(
-    uint64_t order_id, uint32_t symbol_id, uint64_t price, uint64_t trail_amount, uint64_t quantity, OrderTimeInForce time_in_force)
+Order Order::trailingStopLimitBidOrder(uint64_t order_id, uint32_t symbol_id, Price price, Price trail_amount, Quantity quantity,
+    OrderTimeInForce time_in_force, uint32_t owner_id)
 {
     assert(order_id > 0 && "Order ID must be positive!");
     assert(symbol_id > 0 && "Symbol ID must be positive!");
     assert(price > 0 && "Price must be positive!");
     assert(trail_amount > 0 && "Trail amount must be positive!");
     assert(quantity > 0 && "Quantity must be positive!");
-    return Order{OrderType::TrailingStopLimit, OrderSide::Bid, time_in_force, symbol_id, price, 0, trail_amount, quantity, order_id};
+    return Order{
+        OrderType::TrailingStopLimit, OrderSide::Bid, time_in_force, symbol_id, price, 0, trail_amount, quantity, order_id, owner_id};
 }
 
 // LCOV_EXCL_START
@@ -191,6 +251,10 @@ static std::string timeInForceToString(OrderTimeInForce tof)
         return "FOK";
     case OrderTimeInForce::IOC:
         return "IOC";
+    case OrderTimeInForce::GTD:
+        return "GTD";
+    case OrderTimeInForce::DAY:
+        return "DAY";
     default:
         assert(false && "Invalid order time in force!");
     }
@@ -202,12 +266,17 @@ std::string Order::toString() const
     std::string order_string;
     order_string += "Symbol ID: " + std::to_string(symbol_id) + "\n";
     order_string += "Order ID: " + std::to_string(id) + "\n";
+    order_string += "Owner ID: " + std::to_string(owner_id) + "\n";
     order_string += "Type: " + typeToString(type) + "\n";
     order_string += "Side: " + sideToString(side) + "\n";
     order_string += "TOF: " + timeInForceToString(time_in_force) + "\n";
     order_string += "Price: " + std::to_string(price) + "\n";
     order_string += "Quantity: " + std::to_string(quantity) + "\n";
     order_string += "Open Quantity: " + std::to_string(open_quantity) + "\n";
+    if (isGtd())
+        order_string += "Expiry Time: " + std::to_string(expiry_time) + "\n";
+    if (isIceberg())
+        order_string += "Display Quantity: " + std::to_string(display_quantity) + "\n";
     return order_string;
 }
 
@@ -224,7 +293,10 @@ void Order::validateOrder() const
         assert(price > 0 && "Limit, stop limit, and trailing stop limit orders must have a positive price!");
     // Market orders, stop orders, and trailing stop orders can only have time in force FOK or IOC.
     if (type == OrderType::Market || type == OrderType::Stop || type == OrderType::TrailingStop)
-        assert(time_in_force != OrderTimeInForce::GTC && "Market and stop orders cannot have GTC time in force!");
+        assert((time_in_force == OrderTimeInForce::FOK || time_in_force == OrderTimeInForce::IOC) &&
+               "Market and stop orders must have FOK or IOC time in force!");
+    // Only GTD orders have an expiry time, and they must have one.
+    assert((time_in_force == OrderTimeInForce::GTD) == (expiry_time > 0) && "GTD orders, and only GTD orders, must have an expiry time!");
     // All orders must have positive quantity.
     assert(quantity > 0 && "Orders must have a positive quantity!");
     // Last executed quantity and executed quantity should never exceed the quantity of the order.
@@ -0,0 +1,38 @@
+#include "order_record.h"
+
+namespace RapidTrader {
+OrderRecord OrderRecord::fromOrder(const Order &order)
+{
+    OrderRecord record{};
+    record.id = order.id;
+    record.expiry_time = order.expiry_time;
+    record.price = order.price;
+    record.stop_price = order.stop_price;
+    record.trail_amount = order.trail_amount;
+    record.last_executed_price = order.last_executed_price;
+    record.quantity = order.quantity;
+    record.executed_quantity = order.executed_quantity;
+    record.open_quantity = order.open_quantity;
+    record.last_executed_quantity = order.last_executed_quantity;
+    record.display_quantity = order.display_quantity;
+    record.visible_quantity = order.visible_quantity;
+    record.symbol_id = order.symbol_id;
+    record.owner_id = order.owner_id;
+    record.type = order.type;
+    record.side = order.side;
+    record.time_in_force = order.time_in_force;
+    return record;
+}
+
+Order OrderRecord::toOrder() const
+{
+    Order order{type, side, time_in_force, symbol_id, price, stop_price, trail_amount, quantity, id, owner_id, expiry_time};
+    order.last_executed_price = last_executed_price;
+    order.executed_quantity = executed_quantity;
+    order.open_quantity = open_quantity;
+    order.last_executed_quantity = last_executed_quantity;
+    order.display_quantity = display_quantity;
+    order.visible_quantity = visible_quantity;
+    return order;
+}
+} // namespace RapidTrader
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <cassert>
+#include "timer_wheel.h"
+
+namespace RapidTrader {
+TimerWheel::TimerWheel(uint64_t tick_duration_, uint64_t start_time)
+    : tick_duration(tick_duration_)
+{
+    assert(tick_duration > 0 && "Tick duration must be positive!");
+    current_tick = start_time / tick_duration;
+}
+
+void TimerWheel::schedule(Order &order)
+{
+    assert(order.isGtd() && "Only GTD orders can be scheduled to expire!");
+    // The current tick has already been expired, so the earliest an order can expire is the next tick.
+    place(order, std::max(toTick(order.getExpiryTime()), current_tick + 1));
+}
+
+void TimerWheel::advance(uint64_t now, ExpiryList &expired)
+{
+    uint64_t target_tick = now / tick_duration;
+    while (current_tick < target_tick)
+    {
+        current_tick = nextTick(target_tick);
+        // Cascade the slots of the higher levels that start at the new tick, lowest level first.
+        for (uint32_t level = 1; level < num_levels; ++level)
+        {
+            uint32_t shift = slot_bits * level;
+            if ((current_tick & ((uint64_t{1} << shift) - 1)) != 0)
+                break;
+            cascade(wheel[level][(current_tick >> shift) & slot_mask]);
+            if (level == num_levels - 1 && (current_tick & ((uint64_t{1} << (shift + slot_bits)) - 1)) == 0)
+                cascade(overflow);
+        }
+        ExpiryList &slot = wheel[0][current_tick & slot_mask];
+        expired.splice(expired.end(), slot);
+    }
+}
+
+void TimerWheel::place(Order &order, uint64_t tick)
+{
+    for (uint32_t level = 0; level < num_levels; ++level)
+    {
+        // An order goes in the lowest level whose current rotation contains its tick.
+        uint32_t shift = slot_bits * (level + 1);
+        if ((tick >> shift) == (current_tick >> shift))
+        {
+            wheel[level][(tick >> (slot_bits * level)) & slot_mask].push_back(order);
+            return;
+        }
+    }
+    overflow.push_back(order);
+}
+
+void TimerWheel::cascade(ExpiryList &orders)
+{
+    ExpiryList pending;
+    pending.splice(pending.end(), orders);
+    while (!pending.empty())
+    {
+        Order &order = pending.front();
+        pending.pop_front();
+        place(order, std::max(toTick(order.getExpiryTime()), current_tick));
+    }
+}
+
+uint64_t TimerWheel::nextTick(uint64_t target_tick) const
+{
+    uint64_t next_tick = current_tick + 1;
+    for (uint32_t level = 0; level < num_levels; ++level)
+    {
+        uint32_t shift = slot_bits * level;
+        uint64_t rotation_start = (current_tick >> (shift + slot_bits)) << (shift + slot_bits);
+        const auto &slots = wheel[level];
+        for (uint64_t index = ((current_tick >> shift) & slot_mask) + 1; index < num_slots; ++index)
+        {
+            if (!slots[index].empty())
+                return std::min(rotation_start + (index << shift), target_tick);
+        }
+        // Nothing happens at this level until the start of the next rotation, so the search
+        // continues at the level above.
+        next_tick = rotation_start + (uint64_t{1} << (shift + slot_bits));
+    }
+    return std::min(next_tick, target_tick);
+}
+} // namespace RapidTrader
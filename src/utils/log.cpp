@@ -1,3 +1,4 @@
+#include <mutex>
 #include "log.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 
@@ -5,7 +6,10 @@ std::shared_ptr<spdlog::logger> Log::logger;
 
 void Log::init()
 {
-    spdlog::set_pattern("%^[%T] %n: %v%$");
-    logger = spdlog::stdout_color_mt("Fast Exchange");
-    logger->set_level(spdlog::level::trace);
+    static std::once_flag initialized;
+    std::call_once(initialized, [] {
+        spdlog::set_pattern("%^[%T] %n: %v%$");
+        logger = spdlog::stdout_color_mt("Fast Exchange");
+        logger->set_level(spdlog::level::trace);
+    });
 }
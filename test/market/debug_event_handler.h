@@ -5,19 +5,32 @@
 
 using namespace RapidTrader;
 
+// The execution of one order, recorded from an executed order event or from one side of a trade event.
+struct Execution
+{
+    uint64_t order_id;
+    Price price;
+    Quantity quantity;
+    Quantity open_quantity;
+};
+
 struct MarketEventDebugger
 {
     std::queue<OrderAdded> add_order_events;
     std::queue<OrderDeleted> delete_order_events;
-    std::queue<ExecutedOrder> execute_order_events;
+    std::queue<OrdersDeleted> delete_orders_events;
+    std::queue<Execution> execute_order_events;
+    std::queue<OrdersExecuted> execute_orders_events;
     std::queue<OrderUpdated> update_order_events;
+    std::queue<OrderRejected> reject_order_events;
     std::queue<SymbolAdded> add_symbol_events;
     std::queue<SymbolDeleted> delete_symbol_events;
 
     [[nodiscard]] bool empty() const
     {
-        return add_order_events.empty() && delete_order_events.empty() && execute_order_events.empty() && update_order_events.empty() &&
-               add_symbol_events.empty() && delete_symbol_events.empty();
+        return add_order_events.empty() && delete_order_events.empty() && delete_orders_events.empty() && execute_order_events.empty() &&
+               execute_orders_events.empty() && update_order_events.empty() && reject_order_events.empty() && add_symbol_events.empty() &&
+               delete_symbol_events.empty();
     }
 };
 
@@ -38,13 +51,36 @@ protected:
     {
         market_debugger.delete_order_events.push(notification);
     }
+    void handleOrdersDeleted(const OrdersDeleted &notification) override
+    {
+        market_debugger.delete_orders_events.push(notification);
+    }
     void handleOrderUpdated(const OrderUpdated &notification) override
     {
         market_debugger.update_order_events.push(notification);
     }
     void handleOrderExecuted(const ExecutedOrder &notification) override
     {
-        market_debugger.execute_order_events.push(notification);
+        const Order &order = notification.order;
+        market_debugger.execute_order_events.push(
+            {order.getOrderID(), order.getLastExecutedPrice(), order.getLastExecutedQuantity(), order.getOpenQuantity()});
+    }
+    // The bid side of a trade is recorded before the ask side.
+    void handleTrade(const Trade &notification) override
+    {
+        Execution aggressor{notification.aggressor_id, notification.price, notification.quantity, notification.aggressor_open_quantity};
+        Execution passive{notification.passive_id, notification.price, notification.quantity, notification.passive_open_quantity};
+        bool aggressor_is_bid = notification.aggressor_side == OrderSide::Bid;
+        market_debugger.execute_order_events.push(aggressor_is_bid ? aggressor : passive);
+        market_debugger.execute_order_events.push(aggressor_is_bid ? passive : aggressor);
+    }
+    void handleOrdersExecuted(const OrdersExecuted &notification) override
+    {
+        market_debugger.execute_orders_events.push(notification);
+    }
+    void handleOrderRejected(const OrderRejected &notification) override
+    {
+        market_debugger.reject_order_events.push(notification);
     }
     void handleSymbolAdded(const SymbolAdded &notification) override
     {
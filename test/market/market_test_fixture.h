@@ -40,9 +40,11 @@ protected:
         uint64_t expected_open_quantity)
     {
         ASSERT_FALSE(market_debugger.execute_order_events.empty());
-        Order &order_executed = market_debugger.execute_order_events.front().order;
-        checkOrder(
-            order_executed, expected_order_id, expected_last_execution_price, expected_last_execution_quantity, expected_open_quantity);
+        Execution &execution = market_debugger.execute_order_events.front();
+        ASSERT_EQ(execution.order_id, expected_order_id);
+        ASSERT_EQ(execution.price, expected_last_execution_price);
+        ASSERT_EQ(execution.quantity, expected_last_execution_quantity);
+        ASSERT_EQ(execution.open_quantity, expected_open_quantity);
         market_debugger.execute_order_events.pop();
     }
 
@@ -56,6 +58,31 @@ protected:
         market_debugger.delete_order_events.pop();
     }
 
+    void checkOrdersDeleted(const std::vector<uint64_t> &expected_order_ids)
+    {
+        ASSERT_FALSE(market_debugger.delete_orders_events.empty());
+        OrdersDeleted &orders_deleted = market_debugger.delete_orders_events.front();
+        ASSERT_EQ(orders_deleted.symbol_id, symbol_id);
+        ASSERT_EQ(orders_deleted.orders.size(), expected_order_ids.size());
+        for (size_t i = 0; i < expected_order_ids.size(); ++i)
+            ASSERT_EQ(orders_deleted.orders[i].getOrderID(), expected_order_ids[i]);
+        market_debugger.delete_orders_events.pop();
+    }
+
+    void checkOrdersExecuted(const std::vector<uint64_t> &expected_order_ids, uint64_t expected_last_execution_price)
+    {
+        ASSERT_FALSE(market_debugger.execute_orders_events.empty());
+        OrdersExecuted &orders_executed = market_debugger.execute_orders_events.front();
+        ASSERT_EQ(orders_executed.symbol_id, symbol_id);
+        ASSERT_EQ(orders_executed.orders.size(), expected_order_ids.size());
+        for (size_t i = 0; i < expected_order_ids.size(); ++i)
+        {
+            ASSERT_EQ(orders_executed.orders[i].getOrderID(), expected_order_ids[i]);
+            ASSERT_EQ(orders_executed.orders[i].getLastExecutedPrice(), expected_last_execution_price);
+        }
+        market_debugger.execute_orders_events.pop();
+    }
+
     void checkOrderUpdated(uint64_t expected_order_id, uint64_t expected_last_execution_price, uint64_t expected_last_execution_quantity,
         uint64_t expected_open_quantity)
     {
@@ -66,6 +93,15 @@ protected:
         market_debugger.update_order_events.pop();
     }
 
+    void checkOrderRejected(uint64_t expected_order_id, RejectReason expected_reason)
+    {
+        ASSERT_FALSE(market_debugger.reject_order_events.empty());
+        OrderRejected &order_rejected = market_debugger.reject_order_events.front();
+        ASSERT_EQ(order_rejected.order.getOrderID(), expected_order_id);
+        ASSERT_EQ(order_rejected.reason, expected_reason);
+        market_debugger.reject_order_events.pop();
+    }
+
     void checkSymbolAdded(uint64_t expected_symbol_id, const std::string &expected_symbol_name)
     {
         ASSERT_FALSE(market_debugger.add_symbol_events.empty());
@@ -77,7 +113,9 @@ protected:
     }
 
     MarketEventDebugger market_debugger;
-    RapidTrader::Market market{std::unique_ptr<RapidTrader::EventHandler>(new DebugEventHandler(market_debugger))};
+    // The market runs on a manual clock so that tests control when GTD orders expire.
+    std::shared_ptr<ManualClock> clock = std::make_shared<ManualClock>(1000000000);
+    RapidTrader::Market market{std::unique_ptr<RapidTrader::EventHandler>(new DebugEventHandler(market_debugger)), clock};
     uint32_t symbol_id = 1;
     std::string symbol_name = "GOOG";
 };
@@ -0,0 +1,96 @@
+#ifndef RAPID_TRADER_RECORDING_EVENT_HANDLER_H
+#define RAPID_TRADER_RECORDING_EVENT_HANDLER_H
+#include <map>
+#include <set>
+#include <sstream>
+#include "event_handler/event_handler.h"
+
+using namespace RapidTrader;
+
+/**
+ * Records the string representation of every event for each symbol, every event in the
+ * order it was handled with its sequence number, the orders that are resting in the book
+ * of each symbol, and every trade and trade bar.
+ */
+class RecordingEventHandler : public EventHandler
+{
+public:
+    std::map<uint32_t, std::vector<std::string>> symbol_events;
+    std::map<uint32_t, std::set<uint64_t>> resting_orders;
+    std::vector<std::string> sequenced_events;
+    std::vector<Trade> trades;
+    std::vector<TradeBar> trade_bars;
+
+protected:
+    void handleOrderAdded(const OrderAdded &event) override
+    {
+        resting_orders[event.order.getSymbolID()].insert(event.order.getOrderID());
+        record(event.order.getSymbolID(), event);
+    }
+
+    void handleOrderDeleted(const OrderDeleted &event) override
+    {
+        resting_orders[event.order.getSymbolID()].erase(event.order.getOrderID());
+        record(event.order.getSymbolID(), event);
+    }
+
+    void handleOrdersDeleted(const OrdersDeleted &event) override
+    {
+        for (const auto &order : event.orders)
+            resting_orders[event.symbol_id].erase(order.getOrderID());
+        record(event.symbol_id, event);
+    }
+
+    void handleOrdersExecuted(const OrdersExecuted &event) override
+    {
+        record(event.symbol_id, event);
+    }
+
+    void handleOrderUpdated(const OrderUpdated &event) override
+    {
+        record(event.order.getSymbolID(), event);
+    }
+
+    void handleOrderExecuted(const ExecutedOrder &event) override
+    {
+        record(event.order.getSymbolID(), event);
+    }
+
+    void handleTrade(const Trade &event) override
+    {
+        trades.push_back(event);
+        record(event.symbol_id, event);
+    }
+
+    void handleOrderRejected(const OrderRejected &event) override
+    {
+        record(event.order.getSymbolID(), event);
+    }
+
+    void handleSymbolAdded(const SymbolAdded &event) override
+    {
+        record(event.symbol_id, event);
+    }
+
+    void handleSymbolDeleted(const SymbolDeleted &event) override
+    {
+        record(event.symbol_id, event);
+    }
+
+    void handleTradeBar(const TradeBar &event) override
+    {
+        trade_bars.push_back(event);
+        record(event.symbol_id, event);
+    }
+
+private:
+    template<typename Event>
+    void record(uint32_t symbol_id, const Event &event)
+    {
+        std::ostringstream os;
+        os << event;
+        symbol_events[symbol_id].push_back(os.str());
+        sequenced_events.push_back(std::to_string(event.sequence_number) + ": " + os.str());
+    }
+};
+#endif // RAPID_TRADER_RECORDING_EVENT_HANDLER_H
@@ -181,6 +181,44 @@ TEST_F(MarketTest, AddFokLimitOrder2)
     ASSERT_TRUE(market_debugger.empty());
 }
 
+/**
+ * Tests adding limit FOK order that can only be filled by counting the volume of a level more than once.
+ */
+TEST_F(MarketTest, AddFokLimitOrder3)
+{
+    OrderTimeInForce tof1 = OrderTimeInForce::GTC;
+    uint64_t quantity1 = 200;
+    uint64_t price1 = 350;
+    uint64_t id1 = 1;
+    Order order1 = Order::limitAskOrder(id1, symbol_id, price1, quantity1, tof1);
+    market.addOrder(order1);
+
+    OrderTimeInForce tof2 = OrderTimeInForce::GTC;
+    uint64_t quantity2 = 100;
+    uint64_t price2 = 500;
+    uint64_t id2 = 2;
+    Order order2 = Order::limitAskOrder(id2, symbol_id, price2, quantity2, tof2);
+    market.addOrder(order2);
+
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, price1 - 1), 0);
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, price1), quantity1);
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, price2), quantity1 + quantity2);
+
+    OrderTimeInForce tof3 = OrderTimeInForce::FOK;
+    uint64_t quantity3 = 250;
+    uint64_t price3 = 450;
+    uint64_t id3 = 3;
+    Order order3 = Order::limitBidOrder(id3, symbol_id, price3, quantity3, tof3);
+    market.addOrder(order3);
+
+    checkOrderAdded(id1);
+    checkOrderAdded(id2);
+    checkOrderAdded(id3);
+    checkOrderDeleted(id3, 0, 0, quantity3);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, price2), quantity1 + quantity2);
+}
+
 /**
  * Tests adding market IOC order that is not able to be completely filled to an orderbook.
  */
@@ -815,4 +853,18 @@ TEST_F(MarketTest, AddGtcTrailingStopLimitOrder1)
     checkOrderDeleted(id8, price8, quantity8, 0);
     checkOrderDeleted(id9, price8, quantity9, 0);
     ASSERT_TRUE(market_debugger.empty());
-}
\ No newline at end of file
+}
+
+/**
+ * Tests that an order for a symbol that does not exist is rejected.
+ */
+TEST_F(MarketTest, AddOrderForUnknownSymbolShouldBeRejected1)
+{
+    uint32_t unknown_symbol_id = symbol_id + 1;
+    uint64_t id1 = 1;
+    Order order1 = Order::limitBidOrder(id1, unknown_symbol_id, 1500, 1000, OrderTimeInForce::GTC);
+    market.addOrder(order1);
+
+    checkOrderRejected(id1, RejectReason::UnknownSymbol);
+    ASSERT_TRUE(market_debugger.empty());
+}
@@ -20,4 +20,60 @@ TEST(AddSymbolTest, AddSymbolTest1)
     ASSERT_TRUE(event_debugger.add_symbol_events.front().name == symbol_name);
     event_debugger.add_symbol_events.pop();
     ASSERT_TRUE(event_debugger.empty());
-}
\ No newline at end of file
+}
+
+/**
+ * Tests that an orderbook added with a capacity hint does not grow while it stays within the hint.
+ */
+TEST(AddSymbolTest, AddSymbolWithCapacityHintTest1)
+{
+    MarketEventDebugger event_debugger;
+    Market market{std::make_unique<DebugEventHandler>(event_debugger)};
+
+    uint32_t symbol_id = 1;
+    market.addSymbol(symbol_id, "GOOG", 2000, 200);
+    for (uint64_t order_id = 1; order_id <= 1000; ++order_id)
+    {
+        market.addOrder(Order::limitBidOrder(order_id, symbol_id, 1000 + order_id % 100, 10, OrderTimeInForce::GTC));
+        market.addOrder(Order::limitAskOrder(order_id + 1000, symbol_id, 2000 + order_id % 100, 10, OrderTimeInForce::GTC));
+    }
+    ASSERT_EQ(market.numberOfGrowthEvents(symbol_id), 0);
+}
+
+/**
+ * Tests that an orderbook added without a capacity hint records growth events.
+ */
+TEST(AddSymbolTest, AddSymbolWithCapacityHintTest2)
+{
+    MarketEventDebugger event_debugger;
+    Market market{std::make_unique<DebugEventHandler>(event_debugger)};
+
+    uint32_t symbol_id = 1;
+    market.addSymbol(symbol_id, "GOOG");
+    for (uint64_t order_id = 1; order_id <= 1000; ++order_id)
+        market.addOrder(Order::limitBidOrder(order_id, symbol_id, 1000 + order_id % 100, 10, OrderTimeInForce::GTC));
+    ASSERT_GT(market.numberOfGrowthEvents(symbol_id), 0);
+}
+
+/**
+ * Tests that freeing the storage of deleted orders and adding an order that fits in the storage
+ * that is still allocated is not recorded as a growth event.
+ */
+TEST(AddSymbolTest, AddSymbolWithCapacityHintTest3)
+{
+    MarketEventDebugger event_debugger;
+    Market market{std::make_unique<DebugEventHandler>(event_debugger)};
+
+    uint32_t symbol_id = 1;
+    market.addSymbol(symbol_id, "GOOG");
+    // Places one order in each of four pages of the dense order index.
+    const uint64_t page_size = 4096;
+    for (uint64_t page = 0; page < 4; ++page)
+        market.addOrder(Order::limitBidOrder(page * page_size + 1, symbol_id, 1000, 10, OrderTimeInForce::GTC));
+    uint64_t growth_events = market.numberOfGrowthEvents(symbol_id);
+    // Empties the first two pages, so the dense order index frees one of them.
+    market.deleteOrder(symbol_id, 1);
+    market.deleteOrder(symbol_id, page_size + 1);
+    market.addOrder(Order::limitBidOrder(3 * page_size + 2, symbol_id, 1000, 10, OrderTimeInForce::GTC));
+    ASSERT_EQ(market.numberOfGrowthEvents(symbol_id), growth_events);
+}
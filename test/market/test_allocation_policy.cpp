@@ -0,0 +1,107 @@
+#include "market_test_fixture.h"
+
+/**
+ * Tests that pro-rata allocation shares an incoming order between the orders in a level
+ * in proportion to their quantities.
+ */
+TEST_F(MarketTest, AllocationPolicyShouldWork1)
+{
+    market.setAllocationPolicy(symbol_id, AllocationPolicy::ProRata);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 600, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1500, 300, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1500, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 1500, 500, OrderTimeInForce::IOC));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrderAdded(4);
+    checkExecutedOrder(1, 1500, 300, 300);
+    checkExecutedOrder(4, 1500, 300, 200);
+    checkExecutedOrder(2, 1500, 150, 150);
+    checkExecutedOrder(4, 1500, 150, 50);
+    checkExecutedOrder(3, 1500, 50, 50);
+    checkExecutedOrder(4, 1500, 50, 0);
+    checkOrderDeleted(4, 1500, 50, 0);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 500);
+}
+
+/**
+ * Tests that the quantity left over after rounding pro-rata allocations down is allocated
+ * in time priority.
+ */
+TEST_F(MarketTest, AllocationPolicyShouldWork2)
+{
+    market.setAllocationPolicy(symbol_id, AllocationPolicy::ProRata);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 200, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1500, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1500, 100, OrderTimeInForce::IOC));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkExecutedOrder(1, 1500, 67, 133);
+    checkExecutedOrder(3, 1500, 67, 33);
+    checkExecutedOrder(2, 1500, 33, 67);
+    checkExecutedOrder(3, 1500, 33, 0);
+    checkOrderDeleted(3, 1500, 33, 0);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests that pro-rata allocation fills every order in a level that the incoming order
+ * exceeds and continues matching at the next level.
+ */
+TEST_F(MarketTest, AllocationPolicyShouldWork3)
+{
+    market.setAllocationPolicy(symbol_id, AllocationPolicy::ProRata);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1500, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1400, 500, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 1400, 300, OrderTimeInForce::GTC));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrderAdded(4);
+    checkExecutedOrder(1, 1500, 100, 0);
+    checkExecutedOrder(4, 1500, 100, 200);
+    checkExecutedOrder(2, 1500, 100, 0);
+    checkExecutedOrder(4, 1500, 100, 100);
+    checkOrderDeleted(1, 1500, 100, 0);
+    checkOrderDeleted(2, 1500, 100, 0);
+    checkExecutedOrder(3, 1400, 100, 400);
+    checkExecutedOrder(4, 1400, 100, 0);
+    checkOrderDeleted(4, 1400, 100, 0);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 400);
+}
+
+/**
+ * Tests that top order pro-rata allocation fills the order at the front of a level
+ * before allocating the rest of the level pro-rata.
+ */
+TEST_F(MarketTest, AllocationPolicyShouldWork4)
+{
+    market.setAllocationPolicy(symbol_id, AllocationPolicy::TopOrderProRata);
+    market.addOrder(Order::limitAskOrder(1, symbol_id, 1500, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(2, symbol_id, 1500, 600, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1500, 300, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(4, symbol_id, 1500, 400, OrderTimeInForce::IOC));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrderAdded(4);
+    checkExecutedOrder(4, 1500, 100, 300);
+    checkExecutedOrder(1, 1500, 100, 0);
+    checkOrderDeleted(1, 1500, 100, 0);
+    checkExecutedOrder(4, 1500, 200, 100);
+    checkExecutedOrder(2, 1500, 200, 400);
+    checkExecutedOrder(4, 1500, 100, 0);
+    checkExecutedOrder(3, 1500, 100, 200);
+    checkOrderDeleted(4, 1500, 100, 0);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, 1500), 600);
+}
@@ -0,0 +1,170 @@
+#include "market_test_fixture.h"
+
+/**
+ * Tests reducing the quantity of an order, which should keep its priority.
+ */
+TEST_F(MarketTest, AmendOrderShouldWork1)
+{
+    OrderTimeInForce tof1 = OrderTimeInForce::GTC;
+    uint64_t quantity1 = 1000;
+    uint64_t price1 = 1500;
+    uint64_t id1 = 1;
+    Order order1 = Order::limitBidOrder(id1, symbol_id, price1, quantity1, tof1);
+    market.addOrder(order1);
+
+    OrderTimeInForce tof2 = OrderTimeInForce::GTC;
+    uint64_t quantity2 = 1000;
+    uint64_t price2 = 1500;
+    uint64_t id2 = 2;
+    Order order2 = Order::limitBidOrder(id2, symbol_id, price2, quantity2, tof2);
+    market.addOrder(order2);
+
+    uint64_t new_quantity1 = 400;
+    market.amendOrder(symbol_id, id1, new_quantity1, price1);
+
+    OrderTimeInForce tof3 = OrderTimeInForce::IOC;
+    uint64_t quantity3 = 400;
+    uint64_t price3 = 1500;
+    uint64_t id3 = 3;
+    Order order3 = Order::limitAskOrder(id3, symbol_id, price3, quantity3, tof3);
+    market.addOrder(order3);
+
+    checkOrderAdded(id1);
+    checkOrderAdded(id2);
+    checkOrderAdded(id3);
+    checkOrderUpdated(id1, 0, 0, new_quantity1);
+    checkExecutedOrder(id1, price1, new_quantity1, 0);
+    checkExecutedOrder(id3, price1, new_quantity1, 0);
+    checkOrderDeleted(id1, price1, new_quantity1, 0);
+    checkOrderDeleted(id3, price1, new_quantity1, 0);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests increasing the quantity of an order, which should move it to the back of its level.
+ */
+TEST_F(MarketTest, AmendOrderShouldWork2)
+{
+    OrderTimeInForce tof1 = OrderTimeInForce::GTC;
+    uint64_t quantity1 = 1000;
+    uint64_t price1 = 1500;
+    uint64_t id1 = 1;
+    Order order1 = Order::limitBidOrder(id1, symbol_id, price1, quantity1, tof1);
+    market.addOrder(order1);
+
+    OrderTimeInForce tof2 = OrderTimeInForce::GTC;
+    uint64_t quantity2 = 500;
+    uint64_t price2 = 1500;
+    uint64_t id2 = 2;
+    Order order2 = Order::limitBidOrder(id2, symbol_id, price2, quantity2, tof2);
+    market.addOrder(order2);
+
+    uint64_t new_quantity1 = 2000;
+    market.amendOrder(symbol_id, id1, new_quantity1, price1);
+
+    OrderTimeInForce tof3 = OrderTimeInForce::IOC;
+    uint64_t quantity3 = 500;
+    uint64_t price3 = 1500;
+    uint64_t id3 = 3;
+    Order order3 = Order::limitAskOrder(id3, symbol_id, price3, quantity3, tof3);
+    market.addOrder(order3);
+
+    checkOrderAdded(id1);
+    checkOrderAdded(id2);
+    checkOrderAdded(id3);
+    checkOrderUpdated(id1, 0, 0, new_quantity1);
+    checkExecutedOrder(id2, price2, quantity2, 0);
+    checkExecutedOrder(id3, price2, quantity3, 0);
+    checkOrderDeleted(id2, price2, quantity2, 0);
+    checkOrderDeleted(id3, price2, quantity3, 0);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests changing the price of an order such that it does not result in matching.
+ */
+TEST_F(MarketTest, AmendOrderShouldWork3)
+{
+    OrderTimeInForce tof1 = OrderTimeInForce::GTC;
+    uint64_t quantity1 = 1000;
+    uint64_t price1 = 1500;
+    uint64_t id1 = 1;
+    Order order1 = Order::limitBidOrder(id1, symbol_id, price1, quantity1, tof1);
+    market.addOrder(order1);
+
+    OrderTimeInForce tof2 = OrderTimeInForce::GTC;
+    uint64_t quantity2 = 1000;
+    uint64_t price2 = 2000;
+    uint64_t id2 = 2;
+    Order order2 = Order::limitAskOrder(id2, symbol_id, price2, quantity2, tof2);
+    market.addOrder(order2);
+
+    uint64_t new_price1 = 1800;
+    market.amendOrder(symbol_id, id1, quantity1, new_price1);
+
+    checkOrderAdded(id1);
+    checkOrderAdded(id2);
+    checkOrderUpdated(id1, 0, 0, quantity1);
+    ASSERT_TRUE(market_debugger.empty());
+
+    // The amended order should now be matched at its new price.
+    OrderTimeInForce tof3 = OrderTimeInForce::IOC;
+    uint64_t quantity3 = 1000;
+    uint64_t price3 = 1800;
+    uint64_t id3 = 3;
+    Order order3 = Order::limitAskOrder(id3, symbol_id, price3, quantity3, tof3);
+    market.addOrder(order3);
+
+    checkOrderAdded(id3);
+    checkExecutedOrder(id1, new_price1, quantity1, 0);
+    checkExecutedOrder(id3, new_price1, quantity3, 0);
+    checkOrderDeleted(id1, new_price1, quantity1, 0);
+    checkOrderDeleted(id3, new_price1, quantity3, 0);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests changing the price of an order such that it does result in matching.
+ */
+TEST_F(MarketTest, AmendOrderShouldWork4)
+{
+    OrderTimeInForce tof1 = OrderTimeInForce::GTC;
+    uint64_t quantity1 = 1000;
+    uint64_t price1 = 1500;
+    uint64_t id1 = 1;
+    Order order1 = Order::limitBidOrder(id1, symbol_id, price1, quantity1, tof1);
+    market.addOrder(order1);
+
+    OrderTimeInForce tof2 = OrderTimeInForce::GTC;
+    uint64_t quantity2 = 600;
+    uint64_t price2 = 2000;
+    uint64_t id2 = 2;
+    Order order2 = Order::limitAskOrder(id2, symbol_id, price2, quantity2, tof2);
+    market.addOrder(order2);
+
+    uint64_t new_price1 = 2000;
+    market.amendOrder(symbol_id, id1, quantity1, new_price1);
+
+    checkOrderAdded(id1);
+    checkOrderAdded(id2);
+    checkOrderUpdated(id1, 0, 0, quantity1);
+    checkExecutedOrder(id1, price2, quantity2, quantity1 - quantity2);
+    checkExecutedOrder(id2, price2, quantity2, 0);
+    checkOrderDeleted(id2, price2, quantity2, 0);
+    ASSERT_TRUE(market_debugger.empty());
+
+    // The remainder of the amended order should rest at its new price.
+    OrderTimeInForce tof3 = OrderTimeInForce::IOC;
+    uint64_t quantity3 = 400;
+    uint64_t price3 = 2000;
+    uint64_t id3 = 3;
+    Order order3 = Order::limitAskOrder(id3, symbol_id, price3, quantity3, tof3);
+    market.addOrder(order3);
+
+    checkOrderAdded(id3);
+    checkExecutedOrder(id1, new_price1, quantity3, 0);
+    checkExecutedOrder(id3, new_price1, quantity3, 0);
+    checkOrderDeleted(id1, new_price1, quantity3, 0);
+    checkOrderDeleted(id3, new_price1, quantity3, 0);
+    ASSERT_TRUE(market_debugger.empty());
+}
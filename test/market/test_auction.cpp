@@ -0,0 +1,68 @@
+#include "market_test_fixture.h"
+
+/**
+ * Tests that orders accumulate without matching during an auction and are uncrossed
+ * at the price that maximises the executed volume.
+ */
+TEST_F(MarketTest, AuctionShouldWork1)
+{
+    market.startAuction(symbol_id);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1600, 1000, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1500, 500, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1400, 400, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 1400, 600, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(5, symbol_id, 1500, 700, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(6, symbol_id, 1700, 300, OrderTimeInForce::GTC));
+    // Market orders cannot rest in the book during an auction.
+    market.addOrder(Order::marketBidOrder(7, symbol_id, 100, OrderTimeInForce::IOC));
+
+    for (uint64_t id = 1; id <= 7; ++id)
+        checkOrderAdded(id);
+    checkOrderDeleted(7, 0, 0, 100);
+    ASSERT_TRUE(market_debugger.empty());
+    // At 1400 only 600 can execute, at 1600 only 1000 can execute, but at 1500 1300 can execute.
+    ASSERT_EQ(market.auctionPrice(symbol_id), 1500);
+
+    market.uncrossAuction(symbol_id);
+
+    checkOrdersExecuted({1, 4, 1, 5, 2, 5}, 1500);
+    checkOrdersDeleted({4, 1, 5});
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 600);
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, 2000), 300);
+    ASSERT_EQ(market.auctionPrice(symbol_id), 0);
+}
+
+/**
+ * Tests that ties between auction prices are broken by imbalance and then by distance to the
+ * last traded price, and that the book returns to continuous matching after the auction.
+ */
+TEST_F(MarketTest, AuctionShouldWork2)
+{
+    market.startAuction(symbol_id);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(2, symbol_id, 1400, 100, OrderTimeInForce::GTC));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    ASSERT_TRUE(market_debugger.empty());
+    // Both prices execute the same volume with no imbalance, so the lower price is chosen.
+    ASSERT_EQ(market.auctionPrice(symbol_id), 1400);
+
+    market.uncrossAuction(symbol_id);
+
+    checkOrdersExecuted({1, 2}, 1400);
+    checkOrdersDeleted({1, 2});
+    ASSERT_TRUE(market_debugger.empty());
+
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1500, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 1500, 100, OrderTimeInForce::GTC));
+
+    checkOrderAdded(3);
+    checkOrderAdded(4);
+    checkExecutedOrder(3, 1500, 100, 0);
+    checkExecutedOrder(4, 1500, 100, 0);
+    checkOrderDeleted(3, 1500, 100, 0);
+    checkOrderDeleted(4, 1500, 100, 0);
+    ASSERT_TRUE(market_debugger.empty());
+}
@@ -0,0 +1,106 @@
+#include <map>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <gtest/gtest.h>
+#include "market/concurrent_market.h"
+#include "recording_event_handler.h"
+
+/**
+ * Applies the commands of one producer to a market. Each producer only touches its own symbols,
+ * so the events of each symbol do not depend on how the producers are interleaved.
+ *
+ * @param market the market to apply the commands to.
+ * @param producer the index of the producer.
+ * @param num_symbols the number of symbols that the producer owns.
+ */
+template<typename MarketType>
+static void runProducer(MarketType &market, uint32_t producer, uint32_t num_symbols)
+{
+    uint32_t first_symbol_id = producer * num_symbols + 1;
+    for (uint32_t symbol_id = first_symbol_id; symbol_id < first_symbol_id + num_symbols; ++symbol_id)
+        market.addSymbol(symbol_id, "SYMBOL" + std::to_string(symbol_id));
+    std::mt19937 random(producer);
+    uint64_t order_id = uint64_t{producer} << 32;
+    for (int i = 0; i < 3000; ++i)
+    {
+        uint32_t symbol_id = first_symbol_id + random() % num_symbols;
+        uint32_t action = random() % 20;
+        if (action == 0)
+        {
+            market.deleteOrders(symbol_id, random() % 2 == 0 ? OrderSide::Bid : OrderSide::Ask);
+            continue;
+        }
+        Price price = 1000 + random() % 20;
+        Quantity quantity = 1 + random() % 100;
+        OrderTimeInForce time_in_force = random() % 4 == 0 ? OrderTimeInForce::IOC : OrderTimeInForce::GTC;
+        if (random() % 2 == 0)
+            market.addOrder(Order::limitBidOrder(++order_id, symbol_id, price, quantity, time_in_force));
+        else
+            market.addOrder(Order::limitAskOrder(++order_id, symbol_id, price, quantity, time_in_force));
+    }
+    market.deleteSymbol(first_symbol_id);
+}
+
+/**
+ * Tests that a concurrent market driven by several producer threads at once sends the same events
+ * for each symbol as a market that applies the commands of the producers one after the other, and
+ * that each worker sends its events in sequence order.
+ */
+TEST(ConcurrentMarketTest, ProducersShouldMatchMarket1)
+{
+    const uint32_t num_workers = 3;
+    const uint32_t num_producers = 4;
+    const uint32_t num_symbols = 4;
+    std::vector<std::unique_ptr<EventHandler>> event_handlers;
+    std::vector<RecordingEventHandler *> worker_recorders;
+    for (uint32_t i = 0; i < num_workers; ++i)
+    {
+        auto recorder = std::make_unique<RecordingEventHandler>();
+        worker_recorders.push_back(recorder.get());
+        event_handlers.push_back(std::move(recorder));
+    }
+    ConcurrentMarket concurrent_market{event_handlers, num_workers};
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < num_producers; ++producer)
+        producers.emplace_back([&, producer] { runProducer(concurrent_market, producer, num_symbols); });
+    for (auto &producer : producers)
+        producer.join();
+    // The queries are answered once every worker has applied the commands that were submitted before them.
+    std::vector<uint32_t> symbol_ids(num_producers * num_symbols);
+    std::iota(symbol_ids.begin(), symbol_ids.end(), 1);
+    std::vector<BestBidOffer> best_bid_offers = concurrent_market.queryBestBidOffers(symbol_ids).get();
+
+    auto market_recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &recorder = *market_recorder;
+    Market market{std::move(market_recorder)};
+    for (uint32_t producer = 0; producer < num_producers; ++producer)
+        runProducer(market, producer, num_symbols);
+
+    std::map<uint32_t, std::vector<std::string>> worker_events;
+    for (auto *worker_recorder : worker_recorders)
+    {
+        for (auto &[symbol_id, events] : worker_recorder->symbol_events)
+        {
+            ASSERT_TRUE(worker_events.find(symbol_id) == worker_events.end());
+            worker_events[symbol_id] = events;
+        }
+        uint64_t last_sequence_number = 0;
+        for (const std::string &event : worker_recorder->sequenced_events)
+        {
+            uint64_t sequence_number = std::stoull(event);
+            ASSERT_GE(sequence_number, last_sequence_number);
+            last_sequence_number = sequence_number;
+        }
+    }
+    ASSERT_EQ(worker_events.size(), num_producers * num_symbols);
+    ASSERT_EQ(worker_events, recorder.symbol_events);
+    for (size_t i = 0; i < symbol_ids.size(); ++i)
+    {
+        BestBidOffer best_bid_offer = market.bestBidOffer(symbol_ids[i]);
+        ASSERT_EQ(best_bid_offers[i].bid_price, best_bid_offer.bid_price);
+        ASSERT_EQ(best_bid_offers[i].bid_volume, best_bid_offer.bid_volume);
+        ASSERT_EQ(best_bid_offers[i].ask_price, best_bid_offer.ask_price);
+        ASSERT_EQ(best_bid_offers[i].ask_volume, best_bid_offer.ask_volume);
+    }
+}
@@ -18,3 +18,103 @@ TEST_F(MarketTest, DeleteOrderShouldWork1)
     checkOrderDeleted(id1, 0, 0, quantity1);
     ASSERT_TRUE(market_debugger.empty());
 }
+
+
+/**
+ * Tests deleting all orders in an orderbook.
+ */
+TEST_F(MarketTest, DeleteOrdersShouldWork1)
+{
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 300, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 300, 200, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 250, 300, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 400, 400, OrderTimeInForce::GTC));
+
+    market.deleteOrders(symbol_id);
+
+    for (uint64_t id = 1; id <= 4; ++id)
+        checkOrderAdded(id);
+    checkOrdersDeleted({3, 1, 2, 4});
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 0);
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, 1000), 0);
+
+    // Deleting orders from an empty orderbook should not send any notifications.
+    market.deleteOrders(symbol_id);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests deleting all orders on one side of an orderbook.
+ */
+TEST_F(MarketTest, DeleteOrdersShouldWork2)
+{
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 300, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(2, symbol_id, 400, 200, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 450, 300, OrderTimeInForce::GTC));
+
+    market.deleteOrders(symbol_id, OrderSide::Ask);
+
+    for (uint64_t id = 1; id <= 3; ++id)
+        checkOrderAdded(id);
+    checkOrdersDeleted({2, 3});
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 100);
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, 1000), 0);
+
+    // The remaining bid order should still be in the orderbook.
+    market.deleteOrder(symbol_id, 1);
+    checkOrderDeleted(1, 0, 0, 100);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests deleting the orders on one side of an orderbook within a price range.
+ */
+TEST_F(MarketTest, DeleteOrdersShouldWork3)
+{
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 300, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 310, 200, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 320, 300, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(4, symbol_id, 330, 400, OrderTimeInForce::GTC));
+
+    market.deleteOrders(symbol_id, OrderSide::Bid, 310, 320);
+
+    for (uint64_t id = 1; id <= 4; ++id)
+        checkOrderAdded(id);
+    checkOrdersDeleted({2, 3});
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 500);
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 310), 400);
+}
+
+
+/**
+ * Tests deleting all orders that belong to an owner.
+ */
+TEST_F(MarketTest, DeleteOwnerOrdersShouldWork1)
+{
+    uint32_t owner1 = 7;
+    uint32_t owner2 = 8;
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 300, 100, OrderTimeInForce::GTC, owner1));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 300, 200, OrderTimeInForce::GTC, owner2));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 400, 300, OrderTimeInForce::GTC, owner1));
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 450, 400, OrderTimeInForce::GTC));
+    // An order that is deleted before its owner disconnects should not be deleted again.
+    market.addOrder(Order::limitAskOrder(5, symbol_id, 500, 500, OrderTimeInForce::GTC, owner1));
+    market.deleteOrder(symbol_id, 5);
+
+    market.deleteOwnerOrders(owner1);
+
+    for (uint64_t id = 1; id <= 5; ++id)
+        checkOrderAdded(id);
+    checkOrderDeleted(5, 0, 0, 500);
+    checkOrdersDeleted({1, 3});
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 200);
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, 1000), 400);
+
+    // Deleting the orders of an owner without any orders should not send any notifications.
+    market.deleteOwnerOrders(owner1);
+    ASSERT_TRUE(market_debugger.empty());
+}
@@ -28,4 +28,30 @@ TEST(DeleteSymbolTest, DeleteSymbolTest1)
     ASSERT_TRUE(event_debugger.delete_symbol_events.front().name == symbol_name);
     event_debugger.delete_symbol_events.pop();
     ASSERT_TRUE(event_debugger.empty());
-}
\ No newline at end of file
+}
+/**
+ * Tests that the commands and queries that reach the orderbook handler after their symbol was
+ * deleted, e.g. by another producer of a concurrent market, are ignored.
+ */
+TEST(DeleteSymbolTest, DeleteSymbolTest2)
+{
+    MarketEventDebugger event_debugger;
+    OrderBookHandler orderbook_handler{std::make_unique<DebugEventHandler>(event_debugger), std::make_shared<SystemClock>()};
+    uint32_t symbol_id = 1;
+    orderbook_handler.addOrderBook(symbol_id, "GOOG");
+    orderbook_handler.addOrder(Order::limitBidOrder(1, symbol_id, 1000, 100, OrderTimeInForce::GTC));
+    orderbook_handler.deleteOrderBook(symbol_id, "GOOG");
+    event_debugger = MarketEventDebugger{};
+
+    orderbook_handler.deleteOrder(symbol_id, 1);
+    orderbook_handler.cancelOrder(symbol_id, 1, 10);
+    orderbook_handler.replaceOrder(symbol_id, 1, 2, 1010);
+    orderbook_handler.amendOrder(symbol_id, 1, 50, 1000);
+    orderbook_handler.executeOrder(symbol_id, 1, 10);
+    orderbook_handler.haltSymbol(symbol_id);
+    orderbook_handler.setPriceBand(symbol_id, 100, 1000);
+    ASSERT_TRUE(event_debugger.empty());
+    ASSERT_EQ(orderbook_handler.bidVolumeAtOrAbove(symbol_id, 1000), 0);
+    ASSERT_EQ(orderbook_handler.auctionPrice(symbol_id), 0);
+    ASSERT_EQ(orderbook_handler.numberOfGrowthEvents(symbol_id), 0);
+}
@@ -1,4 +1,5 @@
 #include "market_test_fixture.h"
+
 /**
  * Tests Executing an order with a provided quantity but not a price.
  */
@@ -81,4 +82,4 @@ TEST_F(MarketTest, ExecuteOrderShouldWork4)
     checkExecutedOrder(id1, executed_price, executed_quantity, 0);
     checkOrderDeleted(id1, executed_price, executed_quantity, 0);
     ASSERT_TRUE(market_debugger.empty());
-}
\ No newline at end of file
+}
@@ -0,0 +1,99 @@
+#include "market_test_fixture.h"
+
+// One millisecond in nanoseconds.
+static constexpr uint64_t millisecond = 1000000;
+
+/**
+ * Tests that GTD orders are deleted once their expiry time is reached.
+ */
+TEST_F(MarketTest, ExpireOrderShouldWork1)
+{
+    uint64_t expiry_time1 = clock->now() + 5 * millisecond;
+    market.addOrder(Order::gtdBidOrder(1, symbol_id, 1500, 1000, expiry_time1));
+    // Far enough in the future that the order is in the highest level of the timer wheel.
+    uint64_t expiry_time2 = clock->now() + 2 * 60 * 60 * 1000 * millisecond;
+    market.addOrder(Order::gtdBidOrder(2, symbol_id, 1400, 1000, expiry_time2));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1300, 1000, OrderTimeInForce::GTC));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    ASSERT_TRUE(market_debugger.empty());
+
+    clock->setTime(expiry_time1 - 1);
+    market.expireOrders();
+    ASSERT_TRUE(market_debugger.empty());
+
+    clock->setTime(expiry_time1);
+    market.expireOrders();
+    checkOrdersDeleted({1});
+    ASSERT_TRUE(market_debugger.empty());
+
+    clock->setTime(expiry_time2);
+    market.expireOrders();
+    checkOrdersDeleted({2});
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 1000);
+}
+
+/**
+ * Tests that expired orders are deleted before an order is added and cannot be matched against,
+ * and that GTD orders that have already expired are not added to the book.
+ */
+TEST_F(MarketTest, ExpireOrderShouldWork2)
+{
+    uint64_t expiry_time1 = clock->now() + millisecond;
+    market.addOrder(Order::gtdAskOrder(1, symbol_id, 1500, 1000, expiry_time1));
+    clock->advance(2 * millisecond);
+
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1500, 1000, OrderTimeInForce::GTC));
+    market.addOrder(Order::gtdAskOrder(3, symbol_id, 1500, 1000, clock->now()));
+
+    checkOrderAdded(1);
+    checkOrdersDeleted({1});
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrderDeleted(3, 0, 0, 1000);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 1000);
+}
+
+/**
+ * Tests that GTD orders that are deleted before they expire are not deleted again.
+ */
+TEST_F(MarketTest, ExpireOrderShouldWork3)
+{
+    uint64_t expiry_time1 = clock->now() + millisecond;
+    market.addOrder(Order::gtdAskOrder(1, symbol_id, 1500, 1000, expiry_time1));
+    market.deleteOrder(symbol_id, 1);
+    clock->advance(2 * millisecond);
+    market.expireOrders();
+
+    checkOrderAdded(1);
+    checkOrderDeleted(1, 0, 0, 1000);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests deleting the DAY orders in the market.
+ */
+TEST_F(MarketTest, DeleteDayOrdersShouldWork1)
+{
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 1000, OrderTimeInForce::DAY));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1500, 1000, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1600, 1000, OrderTimeInForce::DAY));
+
+    market.deleteDayOrders();
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrdersDeleted({1, 3});
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 1000);
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, 2000), 0);
+
+    // There are no DAY orders left to delete.
+    market.deleteDayOrders();
+    ASSERT_TRUE(market_debugger.empty());
+}
@@ -0,0 +1,141 @@
+#include "market_test_fixture.h"
+
+/**
+ * Tests that new orders are rejected while a symbol is halted and that orders in the book
+ * can still be deleted.
+ */
+TEST_F(MarketTest, HaltShouldWork1)
+{
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 1000, OrderTimeInForce::GTC));
+    market.haltSymbol(symbol_id);
+    market.addOrder(Order::limitAskOrder(2, symbol_id, 1500, 1000, OrderTimeInForce::GTC));
+    market.deleteOrder(symbol_id, 1);
+    market.resumeSymbol(symbol_id);
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1500, 1000, OrderTimeInForce::GTC));
+
+    checkOrderAdded(1);
+    checkOrderRejected(2, RejectReason::Halted);
+    checkOrderDeleted(1, 0, 0, 1000);
+    checkOrderAdded(3);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, 1500), 1000);
+}
+
+/**
+ * Tests that new orders are rejected while the market is halted.
+ */
+TEST_F(MarketTest, HaltShouldWork2)
+{
+    market.haltMarket();
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 1000, OrderTimeInForce::GTC));
+    market.resumeMarket();
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1500, 1000, OrderTimeInForce::GTC));
+
+    checkOrderRejected(1, RejectReason::Halted);
+    checkOrderAdded(2);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests that limit orders with a price outside of a fixed price band are rejected.
+ */
+TEST_F(MarketTest, PriceBandShouldWork1)
+{
+    // A band of 10% around 1000.
+    market.setPriceBand(symbol_id, 1000, 1000);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 899, 1000, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 900, 1000, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1101, 1000, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 1100, 1000, OrderTimeInForce::GTC));
+    market.setPriceBand(symbol_id, 0);
+    market.addOrder(Order::limitAskOrder(5, symbol_id, 2000, 1000, OrderTimeInForce::GTC));
+
+    checkOrderRejected(1, RejectReason::OutsidePriceBand);
+    checkOrderAdded(2);
+    checkOrderRejected(3, RejectReason::OutsidePriceBand);
+    checkOrderAdded(4);
+    checkOrderAdded(5);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests that a price band without a reference price follows the last traded price.
+ */
+TEST_F(MarketTest, PriceBandShouldWork2)
+{
+    // A band of 5% around the last traded price.
+    market.setPriceBand(symbol_id, 500);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 2000, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(2, symbol_id, 2000, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1899, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(4, symbol_id, 1900, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::marketAskOrder(5, symbol_id, 100, OrderTimeInForce::IOC));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkExecutedOrder(1, 2000, 100, 0);
+    checkExecutedOrder(2, 2000, 100, 0);
+    checkOrderDeleted(1, 2000, 100, 0);
+    checkOrderDeleted(2, 2000, 100, 0);
+    checkOrderRejected(3, RejectReason::OutsidePriceBand);
+    checkOrderAdded(4);
+    checkOrderAdded(5);
+    checkExecutedOrder(4, 1900, 100, 0);
+    checkExecutedOrder(5, 1900, 100, 0);
+    checkOrderDeleted(4, 1900, 100, 0);
+    checkOrderDeleted(5, 1900, 100, 0);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests that orders cannot be replaced or amended into a trade while the market or symbol
+ * is halted, and that the original order stays in the book.
+ */
+TEST_F(MarketTest, HaltShouldWork3)
+{
+    market.addOrder(Order::limitAskOrder(1, symbol_id, 100, 10, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 90, 10, OrderTimeInForce::GTC));
+    market.haltMarket();
+    market.replaceOrder(symbol_id, 2, 3, 100);
+    market.amendOrder(symbol_id, 2, 10, 100);
+    market.resumeMarket();
+    market.haltSymbol(symbol_id);
+    market.replaceOrder(symbol_id, 2, 4, 100);
+    market.amendOrder(symbol_id, 2, 10, 100);
+    market.amendOrder(symbol_id, 2, 5, 90);
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderRejected(3, RejectReason::Halted);
+    checkOrderRejected(2, RejectReason::Halted);
+    checkOrderRejected(4, RejectReason::Halted);
+    checkOrderRejected(2, RejectReason::Halted);
+    checkOrderRejected(2, RejectReason::Halted);
+    ASSERT_TRUE(market_debugger.empty());
+    std::optional<Order> order = market.findOrder(symbol_id, 2);
+    ASSERT_TRUE(order.has_value());
+    ASSERT_EQ(order->getPrice(), 90);
+    ASSERT_EQ(order->getOpenQuantity(), 10);
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, 100), 10);
+}
+
+/**
+ * Tests that orders cannot be replaced or amended to a price outside of the price band.
+ */
+TEST_F(MarketTest, PriceBandShouldWork3)
+{
+    market.setPriceBand(symbol_id, 1000, 1000);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 950, 10, OrderTimeInForce::GTC));
+    market.amendOrder(symbol_id, 1, 10, 1200);
+    market.replaceOrder(symbol_id, 1, 2, 800);
+    market.amendOrder(symbol_id, 1, 20, 950);
+
+    checkOrderAdded(1);
+    checkOrderRejected(1, RejectReason::OutsidePriceBand);
+    checkOrderRejected(2, RejectReason::OutsidePriceBand);
+    ASSERT_FALSE(market_debugger.update_order_events.empty());
+    market_debugger.update_order_events.pop();
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.findOrder(symbol_id, 1)->getOpenQuantity(), 20);
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 950), 20);
+}
@@ -0,0 +1,88 @@
+#include "market_test_fixture.h"
+
+/**
+ * Tests that an iceberg order only matches its displayed quantity and moves to the
+ * back of its level once the displayed quantity is replenished.
+ */
+TEST_F(MarketTest, IcebergOrderShouldWork1)
+{
+    OrderTimeInForce tof1 = OrderTimeInForce::GTC;
+    uint64_t quantity1 = 1000;
+    uint64_t display_quantity1 = 300;
+    uint64_t price1 = 1500;
+    uint64_t id1 = 1;
+    Order order1 = Order::icebergBidOrder(id1, symbol_id, price1, quantity1, display_quantity1, tof1);
+    market.addOrder(order1);
+
+    OrderTimeInForce tof2 = OrderTimeInForce::GTC;
+    uint64_t quantity2 = 200;
+    uint64_t price2 = 1500;
+    uint64_t id2 = 2;
+    Order order2 = Order::limitBidOrder(id2, symbol_id, price2, quantity2, tof2);
+    market.addOrder(order2);
+
+    OrderTimeInForce tof3 = OrderTimeInForce::IOC;
+    uint64_t quantity3 = 400;
+    uint64_t price3 = 1500;
+    uint64_t id3 = 3;
+    Order order3 = Order::limitAskOrder(id3, symbol_id, price3, quantity3, tof3);
+    market.addOrder(order3);
+
+    checkOrderAdded(id1);
+    checkOrderAdded(id2);
+    checkOrderAdded(id3);
+    checkExecutedOrder(id1, price1, display_quantity1, quantity1 - display_quantity1);
+    checkExecutedOrder(id3, price1, display_quantity1, quantity3 - display_quantity1);
+    checkOrderUpdated(id1, price1, display_quantity1, quantity1 - display_quantity1);
+    checkExecutedOrder(id2, price2, quantity3 - display_quantity1, quantity2 - (quantity3 - display_quantity1));
+    checkExecutedOrder(id3, price2, quantity3 - display_quantity1, 0);
+    checkOrderDeleted(id3, price2, quantity3 - display_quantity1, 0);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, price1), quantity1 + quantity2 - quantity3);
+}
+
+/**
+ * Tests that an iceberg order that partially matches when it is added displays a
+ * full tranche once it rests in the book.
+ */
+TEST_F(MarketTest, IcebergOrderShouldWork2)
+{
+    OrderTimeInForce tof1 = OrderTimeInForce::GTC;
+    uint64_t quantity1 = 200;
+    uint64_t price1 = 1500;
+    uint64_t id1 = 1;
+    Order order1 = Order::limitAskOrder(id1, symbol_id, price1, quantity1, tof1);
+    market.addOrder(order1);
+
+    OrderTimeInForce tof2 = OrderTimeInForce::GTC;
+    uint64_t quantity2 = 1000;
+    uint64_t display_quantity2 = 300;
+    uint64_t price2 = 1500;
+    uint64_t id2 = 2;
+    Order order2 = Order::icebergBidOrder(id2, symbol_id, price2, quantity2, display_quantity2, tof2);
+    market.addOrder(order2);
+
+    checkOrderAdded(id1);
+    checkOrderAdded(id2);
+    checkExecutedOrder(id2, price1, quantity1, quantity2 - quantity1);
+    checkExecutedOrder(id1, price1, quantity1, 0);
+    checkOrderDeleted(id1, price1, quantity1, 0);
+    ASSERT_TRUE(market_debugger.empty());
+
+    OrderTimeInForce tof3 = OrderTimeInForce::IOC;
+    uint64_t quantity3 = 500;
+    uint64_t price3 = 1500;
+    uint64_t id3 = 3;
+    Order order3 = Order::limitAskOrder(id3, symbol_id, price3, quantity3, tof3);
+    market.addOrder(order3);
+
+    checkOrderAdded(id3);
+    checkExecutedOrder(id2, price2, display_quantity2, 500);
+    checkExecutedOrder(id3, price2, display_quantity2, 200);
+    checkOrderUpdated(id2, price2, display_quantity2, 500);
+    checkExecutedOrder(id2, price2, 200, 300);
+    checkExecutedOrder(id3, price2, 200, 0);
+    checkOrderDeleted(id3, price2, 200, 0);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, price2), 300);
+}
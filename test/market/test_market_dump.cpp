@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include "market_test_fixture.h"
+#include "recording_event_handler.h"
+
+/**
+ * Reads every book of a binary dump and renders it in the format of the string representation
+ * of a market.
+ *
+ * @param name the name of the dump.
+ * @return the string representation of the books in the dump.
+ */
+static std::string readDump(const std::string &name)
+{
+    BookDumpReader reader{name};
+    BookSnapshot book;
+    std::string market_string;
+    while (reader.read(book))
+        market_string += book.toString() + "\n";
+    return market_string;
+}
+
+/**
+ * Tests that the binary dump of a market has the same books as its string representation.
+ */
+TEST_F(MarketTest, DumpMarketBinaryShouldWork1)
+{
+    market.addSymbol(symbol_id + 1, "SYMBOL2");
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1000, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 990, 50, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1000, 30, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 1020, 10, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(5, symbol_id + 1, 500, 10, OrderTimeInForce::GTC));
+
+    std::string name = ::testing::TempDir() + "market_dump1.bin";
+    market.dumpMarketBinary(name);
+    EXPECT_EQ(readDump(name), market.toString());
+    std::remove(name.c_str());
+}
+
+/**
+ * Tests that the binary dump of a concurrent market has a book for every symbol, and that a
+ * file that is not a dump or that ends in the middle of a book is rejected.
+ */
+TEST(ConcurrentMarketTest, DumpMarketBinaryShouldWork1)
+{
+    const uint32_t num_workers = 2;
+    std::vector<std::unique_ptr<EventHandler>> event_handlers;
+    for (uint32_t i = 0; i < num_workers; ++i)
+        event_handlers.push_back(std::make_unique<RecordingEventHandler>());
+    ConcurrentMarket concurrent_market{event_handlers, num_workers};
+    for (uint32_t symbol_id = 1; symbol_id <= 4; ++symbol_id)
+    {
+        concurrent_market.addSymbol(symbol_id, "SYMBOL" + std::to_string(symbol_id));
+        concurrent_market.addOrder(Order::limitBidOrder(symbol_id, symbol_id, 1000 + symbol_id, 10, OrderTimeInForce::GTC));
+    }
+
+    std::string name = ::testing::TempDir() + "market_dump2.bin";
+    concurrent_market.dumpMarketBinary(name);
+    BookDumpReader reader{name};
+    BookSnapshot book;
+    std::vector<uint32_t> symbol_ids;
+    while (reader.read(book))
+    {
+        symbol_ids.push_back(book.symbol_id);
+        ASSERT_EQ(book.bid_levels.size(), 1);
+        EXPECT_EQ(book.bid_levels[0].price, 1000 + book.symbol_id);
+        EXPECT_EQ(book.bid_levels[0].volume, 10);
+    }
+    std::sort(symbol_ids.begin(), symbol_ids.end());
+    EXPECT_EQ(symbol_ids, (std::vector<uint32_t>{1, 2, 3, 4}));
+
+    // Truncate the dump in the middle of the last book.
+    std::ifstream dump_file(name, std::ios::binary);
+    std::string dump((std::istreambuf_iterator<char>(dump_file)), std::istreambuf_iterator<char>());
+    dump_file.close();
+    std::ofstream truncated_file(name, std::ios::binary | std::ios::trunc);
+    truncated_file << dump.substr(0, dump.size() - 8);
+    truncated_file.close();
+    EXPECT_THROW(readDump(name), std::runtime_error);
+
+    std::ofstream text_file(name, std::ios::trunc);
+    text_file << concurrent_market.toString();
+    text_file.close();
+    EXPECT_THROW(BookDumpReader{name}, std::runtime_error);
+    std::remove(name.c_str());
+}
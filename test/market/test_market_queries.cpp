@@ -0,0 +1,141 @@
+#include <cstdio>
+#include <gtest/gtest.h>
+#include "market_test_fixture.h"
+#include "recording_event_handler.h"
+
+/**
+ * Tests that the best bid and offer, depth, order lookup, and statistics queries of a market
+ * reflect the orders in the book.
+ */
+TEST_F(MarketTest, QueriesShouldWork1)
+{
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1000, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1000, 50, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 990, 10, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(4, symbol_id, 980, 20, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(5, symbol_id, 1010, 30, OrderTimeInForce::GTC));
+
+    BestBidOffer best_bid_offer = market.bestBidOffer(symbol_id);
+    ASSERT_EQ(best_bid_offer.symbol_id, symbol_id);
+    ASSERT_EQ(best_bid_offer.bid_price, 1000);
+    ASSERT_EQ(best_bid_offer.bid_volume, 150);
+    ASSERT_EQ(best_bid_offer.ask_price, 1010);
+    ASSERT_EQ(best_bid_offer.ask_volume, 30);
+
+    BookDepth book_depth = market.depth(symbol_id, 2);
+    ASSERT_EQ(book_depth.bid_levels.size(), 2);
+    ASSERT_EQ(book_depth.bid_levels[0].price, 1000);
+    ASSERT_EQ(book_depth.bid_levels[0].volume, 150);
+    ASSERT_EQ(book_depth.bid_levels[1].price, 990);
+    ASSERT_EQ(book_depth.ask_levels.size(), 1);
+    ASSERT_EQ(book_depth.ask_levels[0].price, 1010);
+
+    std::optional<Order> order = market.findOrder(symbol_id, 2);
+    ASSERT_TRUE(order.has_value());
+    ASSERT_EQ(order->getOpenQuantity(), 50);
+    ASSERT_FALSE(market.findOrder(symbol_id, 6).has_value());
+
+    SymbolStatistics symbol_statistics = market.statistics(symbol_id);
+    ASSERT_EQ(symbol_statistics.num_orders, 5);
+    ASSERT_EQ(symbol_statistics.num_bid_levels, 3);
+    ASSERT_EQ(symbol_statistics.num_ask_levels, 1);
+    ASSERT_FALSE(symbol_statistics.halted);
+}
+
+/**
+ * Tests that queries about symbols that do not exist return empty results.
+ */
+TEST_F(MarketTest, QueriesShouldWork2)
+{
+    BestBidOffer best_bid_offer = market.bestBidOffer(symbol_id + 1);
+    ASSERT_EQ(best_bid_offer.symbol_id, symbol_id + 1);
+    ASSERT_EQ(best_bid_offer.bid_price, 0);
+    ASSERT_EQ(best_bid_offer.ask_price, 0);
+    ASSERT_TRUE(market.depth(symbol_id + 1, 10).bid_levels.empty());
+    ASSERT_FALSE(market.findOrder(symbol_id + 1, 1).has_value());
+    ASSERT_EQ(market.statistics(symbol_id + 1).num_orders, 0);
+}
+
+/**
+ * Tests that the best bid and offer, depth, and snapshot of a market only report the displayed
+ * quantity of iceberg orders, including after the orders are executed and replenished.
+ */
+TEST_F(MarketTest, QueriesShouldWork3)
+{
+    market.addOrder(Order::icebergBidOrder(1, symbol_id, 1000, 500, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1000, 50, OrderTimeInForce::GTC));
+    ASSERT_EQ(market.bestBidOffer(symbol_id).bid_volume, 150);
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 1000), 550);
+
+    // Executes 70 of the displayed quantity and then the rest of it, which replenishes the iceberg.
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1000, 70, OrderTimeInForce::IOC));
+    ASSERT_EQ(market.bestBidOffer(symbol_id).bid_volume, 80);
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 1000, 30, OrderTimeInForce::IOC));
+    ASSERT_EQ(market.bestBidOffer(symbol_id).bid_volume, 150);
+    ASSERT_EQ(market.depth(symbol_id, 1).bid_levels[0].volume, 150);
+    // A manual execution may execute hidden quantity.
+    market.executeOrder(symbol_id, 1, 150, 1000);
+    ASSERT_EQ(market.bestBidOffer(symbol_id).bid_volume, 150);
+    market.amendOrder(symbol_id, 1, 60, 1000);
+    ASSERT_EQ(market.bestBidOffer(symbol_id).bid_volume, 110);
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 1000), 110);
+    market.amendOrder(symbol_id, 1, 200, 1000);
+    ASSERT_EQ(market.bestBidOffer(symbol_id).bid_volume, 150);
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 1000), 250);
+
+    std::string name = ::testing::TempDir() + "market_queries_dump.bin";
+    market.dumpMarketBinary(name);
+    BookDumpReader reader{name};
+    BookSnapshot book;
+    ASSERT_TRUE(reader.read(book));
+    ASSERT_EQ(book.bid_levels.size(), 1);
+    ASSERT_EQ(book.bid_levels[0].volume, 150);
+    std::remove(name.c_str());
+}
+
+/**
+ * Tests that the asynchronous queries of a concurrent market are answered after the commands
+ * that were submitted before them, and that batched queries return their results in order.
+ */
+TEST(ConcurrentMarketTest, QueriesShouldWork1)
+{
+    const uint32_t num_workers = 3;
+    std::vector<std::unique_ptr<EventHandler>> event_handlers;
+    for (uint32_t i = 0; i < num_workers; ++i)
+        event_handlers.push_back(std::make_unique<RecordingEventHandler>());
+    ConcurrentMarket concurrent_market{event_handlers, num_workers};
+    std::vector<uint32_t> symbol_ids;
+    for (uint32_t symbol_id = 1; symbol_id <= 6; ++symbol_id)
+    {
+        concurrent_market.addSymbol(symbol_id, "SYMBOL" + std::to_string(symbol_id));
+        concurrent_market.addOrder(Order::limitBidOrder(symbol_id, symbol_id, 1000 + symbol_id, 10 * symbol_id, OrderTimeInForce::GTC));
+        symbol_ids.push_back(symbol_id);
+    }
+    symbol_ids.push_back(100);
+
+    BestBidOffer best_bid_offer = concurrent_market.queryBestBidOffer(4).get();
+    ASSERT_EQ(best_bid_offer.bid_price, 1004);
+    ASSERT_EQ(best_bid_offer.bid_volume, 40);
+    ASSERT_EQ(concurrent_market.queryDepth(5, 10).get().bid_levels.size(), 1);
+    ASSERT_TRUE(concurrent_market.queryOrder(3, 3).get().has_value());
+    ASSERT_FALSE(concurrent_market.queryOrder(3, 4).get().has_value());
+    ASSERT_EQ(concurrent_market.queryStatistics(2).get().num_orders, 1);
+
+    std::vector<BestBidOffer> best_bid_offers = concurrent_market.queryBestBidOffers(symbol_ids).get();
+    ASSERT_EQ(best_bid_offers.size(), symbol_ids.size());
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        ASSERT_EQ(best_bid_offers[i].symbol_id, symbol_ids[i]);
+        ASSERT_EQ(best_bid_offers[i].bid_price, 1000 + symbol_ids[i]);
+    }
+    ASSERT_EQ(best_bid_offers.back().symbol_id, 100);
+    ASSERT_EQ(best_bid_offers.back().bid_price, 0);
+
+    std::promise<std::vector<SymbolStatistics>> statistics_promise;
+    concurrent_market.queryStatistics(
+        symbol_ids, [&](std::vector<SymbolStatistics> results) { statistics_promise.set_value(std::move(results)); });
+    std::vector<SymbolStatistics> symbol_statistics = statistics_promise.get_future().get();
+    ASSERT_EQ(symbol_statistics.size(), symbol_ids.size());
+    ASSERT_EQ(symbol_statistics[5].num_bid_levels, 1);
+    ASSERT_EQ(symbol_statistics.back().num_orders, 0);
+}
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <random>
+#include <sys/socket.h>
+#include <gtest/gtest.h>
+#include "market/replica.h"
+#include "recording_event_handler.h"
+
+using namespace RapidTrader;
+
+/**
+ * Tests that a replica fed by an asynchronous publisher reproduces the events and books of
+ * the primary, and that it can be promoted to take over as the primary.
+ */
+TEST(ReplicaTest, ReplicaShouldFollowPrimary1)
+{
+    int sockets[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+    auto clock = std::make_shared<ManualClock>(1000);
+    auto primary_recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &recorder = *primary_recorder;
+    Market primary{std::move(primary_recorder), clock};
+    ReplicaPublisher publisher{sockets[0], ReplicationMode::Async};
+    primary.setCommandListener(&publisher);
+    auto replica_recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &replica_events = *replica_recorder;
+    Replica replica{sockets[1], std::move(replica_recorder)};
+
+    const uint32_t num_symbols = 3;
+    for (uint32_t symbol_id = 1; symbol_id <= num_symbols; ++symbol_id)
+        primary.addSymbol(symbol_id, "SYMBOL" + std::to_string(symbol_id));
+    std::mt19937 random(7);
+    uint64_t order_id = 1;
+    for (int i = 0; i < 5000; ++i)
+    {
+        clock->advance(10);
+        uint32_t symbol_id = 1 + random() % num_symbols;
+        const auto &resting = recorder.resting_orders[symbol_id];
+        if (random() % 4 != 0 || resting.empty())
+        {
+            Price price = 1000 + random() % 20;
+            Quantity quantity = 1 + random() % 100;
+            // Some orders expire, which the replica must reproduce with the primary's clock.
+            if (random() % 5 == 0)
+                primary.addOrder(Order::gtdBidOrder(order_id++, symbol_id, price, quantity, clock->now() + random() % 500));
+            else if (random() % 2 == 0)
+                primary.addOrder(Order::limitBidOrder(order_id++, symbol_id, price, quantity, OrderTimeInForce::GTC));
+            else
+                primary.addOrder(Order::limitAskOrder(order_id++, symbol_id, price, quantity, OrderTimeInForce::GTC));
+        }
+        else
+        {
+            primary.deleteOrder(symbol_id, *resting.begin());
+        }
+        // Let the replica fall behind the primary and catch up.
+        if (i % 100 == 0)
+            replica.poll();
+    }
+    primary.haltSymbol(1);
+    primary.addOrder(Order::limitBidOrder(order_id++, 1, 1000, 10, OrderTimeInForce::GTC));
+
+    // The sender may be waiting for the replica to make room in the socket.
+    while (publisher.backlog() > 0)
+        replica.poll();
+    ASSERT_EQ(publisher.droppedCommands(), 0);
+    ASSERT_EQ(publisher.sentSequence(), publisher.publishedSequence());
+    while (replica.appliedSequence() < publisher.publishedSequence())
+        replica.poll();
+    ASSERT_FALSE(replica.hasGap());
+    ASSERT_EQ(replica_events.symbol_events, recorder.symbol_events);
+    ASSERT_EQ(replica.getMarket().toString(), primary.toString());
+
+    std::unique_ptr<Market> promoted = replica.promote();
+    promoted->addOrder(Order::limitAskOrder(order_id, 2, 1000, 10, OrderTimeInForce::GTC));
+    ASSERT_GT(replica_events.symbol_events[2].size(), recorder.symbol_events[2].size());
+}
+
+/**
+ * Tests that a replica stops applying commands once a command is missing.
+ */
+TEST(ReplicaTest, ReplicaShouldDetectGaps1)
+{
+    int sockets[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+    auto replica_recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &replica_events = *replica_recorder;
+    Replica replica{sockets[1], std::move(replica_recorder)};
+    ReplicaPublisher publisher{sockets[0], ReplicationMode::Sync};
+
+    Command add_symbol = Command::addSymbol(1, "GOOG", 0, 0);
+    add_symbol.sequence_number = 1;
+    publisher.handleCommand(add_symbol);
+    Command add_order = Command::addOrder(Order::limitBidOrder(1, 1, 1000, 10, OrderTimeInForce::GTC));
+    add_order.sequence_number = 3;
+    publisher.handleCommand(add_order);
+    ASSERT_EQ(publisher.sentSequence(), 3);
+
+    ASSERT_EQ(replica.poll(), 1);
+    ASSERT_EQ(replica.appliedSequence(), 1);
+    ASSERT_TRUE(replica.hasGap());
+    ASSERT_EQ(replica_events.symbol_events[1].size(), 1);
+    ASSERT_TRUE(replica_events.resting_orders[1].empty());
+}
+
+/**
+ * Tests that a replica installs its own risk stage at the same point in the commands as the primary
+ * installs its risk stage, so that it rejects the same orders as the primary.
+ */
+TEST(ReplicaTest, ReplicaShouldFollowPrimary2)
+{
+    int sockets[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+    auto clock = std::make_shared<ManualClock>(1000);
+    auto primary_recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &recorder = *primary_recorder;
+    Market primary{std::move(primary_recorder), clock};
+    ReplicaPublisher publisher{sockets[0], ReplicationMode::Sync};
+    primary.setCommandListener(&publisher);
+    const uint32_t num_owners = 3;
+    RiskLimits limits;
+    limits.max_position = 150;
+    auto primary_risk_check = std::make_shared<AccountRiskCheck>(num_owners + 1);
+    auto replica_risk_check = std::make_shared<AccountRiskCheck>(num_owners + 1);
+    for (uint32_t owner_id = 1; owner_id <= num_owners; ++owner_id)
+    {
+        primary_risk_check->setLimits(owner_id, limits);
+        replica_risk_check->setLimits(owner_id, limits);
+    }
+    auto replica_recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &replica_events = *replica_recorder;
+    Replica replica{sockets[1], std::move(replica_recorder), replica_risk_check};
+
+    uint32_t symbol_id = 1;
+    primary.addSymbol(symbol_id, "SYMBOL1");
+    std::mt19937 random(11);
+    for (uint64_t order_id = 1; order_id <= 600; ++order_id)
+    {
+        // The orders before the risk stage is installed are recorded by it, and the orders after it is removed are not checked.
+        if (order_id == 100)
+            primary.setRiskCheck(primary_risk_check);
+        else if (order_id == 500)
+            primary.setRiskCheck(nullptr);
+        Price price = 1000 + random() % 10;
+        Quantity quantity = 1 + random() % 60;
+        uint32_t owner_id = 1 + random() % num_owners;
+        if (random() % 2 == 0)
+            primary.addOrder(Order::limitBidOrder(order_id, symbol_id, price, quantity, OrderTimeInForce::GTC, owner_id));
+        else
+            primary.addOrder(Order::limitAskOrder(order_id, symbol_id, price, quantity, OrderTimeInForce::GTC, owner_id));
+        replica.poll();
+        if (order_id == 499)
+        {
+            for (uint32_t id = 1; id <= num_owners; ++id)
+            {
+                ASSERT_EQ(replica_risk_check->getPosition(id), primary_risk_check->getPosition(id));
+                ASSERT_EQ(replica_risk_check->getOpenQuantity(id, OrderSide::Bid), primary_risk_check->getOpenQuantity(id, OrderSide::Bid));
+                ASSERT_EQ(replica_risk_check->getOpenQuantity(id, OrderSide::Ask), primary_risk_check->getOpenQuantity(id, OrderSide::Ask));
+            }
+        }
+    }
+    ASSERT_EQ(replica.appliedSequence(), publisher.publishedSequence());
+    ASSERT_FALSE(replica.hasGap());
+    size_t num_rejected = std::count_if(recorder.sequenced_events.begin(), recorder.sequenced_events.end(),
+        [](const std::string &event) { return event.find("REJECTED ORDER") != std::string::npos; });
+    ASSERT_GT(num_rejected, 0);
+    ASSERT_EQ(replica_events.sequenced_events, recorder.sequenced_events);
+    ASSERT_EQ(replica.getMarket().toString(), primary.toString());
+}
+
+/**
+ * A clock that moves forward every time it is read.
+ */
+class SteppingClock : public Clock
+{
+public:
+    explicit SteppingClock(uint64_t step_)
+        : step(step_)
+        , time(0)
+    {}
+
+    [[nodiscard]] uint64_t now() const override
+    {
+        return time.fetch_add(step, std::memory_order_acq_rel) + step;
+    }
+
+private:
+    uint64_t step;
+    mutable std::atomic<uint64_t> time;
+};
+
+/**
+ * Tests that the primary applies each command at the time that it publishes with the command, even
+ * if its clock moves while the command is applied, so that the replica expires the same orders.
+ */
+TEST(ReplicaTest, ReplicaShouldFollowPrimary3)
+{
+    int sockets[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+    const uint64_t step = 10000000;
+    auto primary_recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &recorder = *primary_recorder;
+    Market primary{std::move(primary_recorder), std::make_shared<SteppingClock>(step)};
+    ReplicaPublisher publisher{sockets[0], ReplicationMode::Sync};
+    primary.setCommandListener(&publisher);
+    auto replica_recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &replica_events = *replica_recorder;
+    Replica replica{sockets[1], std::move(replica_recorder)};
+
+    uint32_t symbol_id = 1;
+    primary.addSymbol(symbol_id, "SYMBOL1");
+    primary.setBarInterval(symbol_id, step);
+    primary.addOrder(Order::limitAskOrder(1, symbol_id, 1000, 10, OrderTimeInForce::GTC));
+    // Each command reads the clock once, so the order is added and trades at 4 * step, and only
+    // expires with the last command.
+    primary.addOrder(Order::gtdBidOrder(2, symbol_id, 1000, 100, 4 * step + 1));
+    ASSERT_EQ(recorder.resting_orders[symbol_id].size(), 1);
+    primary.closeBars();
+    primary.expireOrders();
+    replica.poll();
+
+    ASSERT_EQ(replica.appliedSequence(), publisher.publishedSequence());
+    ASSERT_TRUE(recorder.resting_orders[symbol_id].empty());
+    ASSERT_EQ(recorder.trade_bars.size(), 1);
+    ASSERT_EQ(recorder.trade_bars[0].start_time, 4 * step);
+    ASSERT_EQ(replica_events.sequenced_events, recorder.sequenced_events);
+    ASSERT_EQ(replica.getMarket().toString(), primary.toString());
+}
@@ -0,0 +1,179 @@
+#include <limits>
+#include "market_test_fixture.h"
+#include "recording_event_handler.h"
+
+/**
+ * Tests that orders that could take an account beyond its position limit are rejected
+ * and that positions follow executions.
+ */
+TEST_F(MarketTest, RiskCheckShouldWork1)
+{
+    auto risk_check = std::make_unique<AccountRiskCheck>(100);
+    AccountRiskCheck *account_risk_check = risk_check.get();
+    RiskLimits limits;
+    limits.max_position = 1000;
+    risk_check->setLimits(5, limits);
+    market.setRiskCheck(std::move(risk_check));
+
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 800, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitAskOrder(2, symbol_id, 1500, 800, OrderTimeInForce::GTC, 6));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1500, 300, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 1600, 1500, OrderTimeInForce::GTC, 5));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkExecutedOrder(1, 1500, 800, 0);
+    checkExecutedOrder(2, 1500, 800, 0);
+    checkOrderDeleted(1, 1500, 800, 0);
+    checkOrderDeleted(2, 1500, 800, 0);
+    checkOrderRejected(3, RejectReason::PositionLimit);
+    checkOrderAdded(4);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(account_risk_check->getPosition(5), 800);
+    ASSERT_EQ(account_risk_check->getPosition(6), -800);
+}
+
+/**
+ * Tests that orders that exceed the notional limit or the order rate limit of an account
+ * are rejected, as are orders from accounts that are not in the table.
+ */
+TEST_F(MarketTest, RiskCheckShouldWork2)
+{
+    auto risk_check = std::make_unique<AccountRiskCheck>(100, 1000000000);
+    RiskLimits limits;
+    limits.max_order_notional = 1000000;
+    limits.max_orders_per_window = 2;
+    risk_check->setLimits(5, limits);
+    market.setRiskCheck(std::move(risk_check));
+
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1000, 1001, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1000, 1000, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1000, 1000, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(4, symbol_id, 1000, 1000, OrderTimeInForce::GTC, 5));
+    clock->advance(1000000000);
+    market.addOrder(Order::limitBidOrder(5, symbol_id, 1000, 1000, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(6, symbol_id, 1000, 1000, OrderTimeInForce::GTC, 200));
+    market.addOrder(Order::limitBidOrder(7, symbol_id, 1000, 1000, OrderTimeInForce::GTC));
+
+    checkOrderRejected(1, RejectReason::NotionalLimit);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrderRejected(4, RejectReason::OrderRateLimit);
+    checkOrderAdded(5);
+    checkOrderRejected(6, RejectReason::UnknownAccount);
+    checkOrderAdded(7);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests that the open quantity of resting orders counts towards the position limit of an account
+ * until the orders are executed, reduced, or deleted, and that amendments that increase the
+ * quantity of an order are checked.
+ */
+TEST_F(MarketTest, RiskCheckShouldWork3)
+{
+    auto risk_check = std::make_shared<AccountRiskCheck>(100);
+    RiskLimits limits;
+    limits.max_position = 1000;
+    risk_check->setLimits(5, limits);
+    market.setRiskCheck(risk_check);
+
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 600, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1490, 500, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1490, 400, OrderTimeInForce::GTC, 5));
+    ASSERT_EQ(risk_check->getOpenQuantity(5, OrderSide::Bid), 1000);
+    checkOrderRejected(2, RejectReason::PositionLimit);
+
+    // Increasing the quantity of an order is rejected and leaves the order as it was.
+    market.amendOrder(symbol_id, 3, 500, 1490);
+    checkOrderRejected(3, RejectReason::PositionLimit);
+    ASSERT_EQ(risk_check->getOpenQuantity(5, OrderSide::Bid), 1000);
+    market.amendOrder(symbol_id, 3, 300, 1490);
+    ASSERT_EQ(risk_check->getOpenQuantity(5, OrderSide::Bid), 900);
+    market.replaceOrder(symbol_id, 3, 4, 1480);
+    ASSERT_EQ(risk_check->getOpenQuantity(5, OrderSide::Bid), 900);
+
+    // Executions move open quantity into the position, and deletions release it.
+    market.addOrder(Order::limitAskOrder(5, symbol_id, 1500, 200, OrderTimeInForce::GTC, 6));
+    ASSERT_EQ(risk_check->getOpenQuantity(5, OrderSide::Bid), 700);
+    ASSERT_EQ(risk_check->getPosition(5), 200);
+    market.deleteOrder(symbol_id, 1);
+    market.amendOrder(symbol_id, 4, 200, 1480);
+    ASSERT_EQ(risk_check->getOpenQuantity(5, OrderSide::Bid), 200);
+    market.addOrder(Order::limitBidOrder(6, symbol_id, 1490, 600, OrderTimeInForce::GTC, 5));
+    ASSERT_EQ(risk_check->getOpenQuantity(5, OrderSide::Bid), 800);
+    market.deleteSymbol(symbol_id);
+    ASSERT_EQ(risk_check->getOpenQuantity(5, OrderSide::Bid), 0);
+    ASSERT_EQ(risk_check->getPosition(5), 200);
+}
+
+/**
+ * Tests that market orders are valued at the last traded price of their book for the notional
+ * limit, and are rejected if the book has not traded.
+ */
+TEST_F(MarketTest, RiskCheckShouldWork4)
+{
+    auto risk_check = std::make_shared<AccountRiskCheck>(100);
+    RiskLimits limits;
+    limits.max_order_notional = 100000;
+    risk_check->setLimits(5, limits);
+    market.setRiskCheck(risk_check);
+
+    market.addOrder(Order::limitAskOrder(1, symbol_id, 1000, 500, OrderTimeInForce::GTC, 6));
+    market.addOrder(Order::marketBidOrder(2, symbol_id, 50, OrderTimeInForce::IOC, 5));
+    checkOrderRejected(2, RejectReason::NotionalLimit);
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1000, 100, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::marketBidOrder(4, symbol_id, 101, OrderTimeInForce::IOC, 5));
+    checkOrderRejected(4, RejectReason::NotionalLimit);
+    market.addOrder(Order::marketBidOrder(5, symbol_id, 100, OrderTimeInForce::IOC, 5));
+    ASSERT_TRUE(market_debugger.reject_order_events.empty());
+    ASSERT_EQ(risk_check->getPosition(5), 200);
+}
+
+/**
+ * Tests that orders whose notional value does not fit in a price or a quantity are rejected
+ * by the notional limit.
+ */
+TEST_F(MarketTest, RiskCheckShouldWork5)
+{
+    auto risk_check = std::make_shared<AccountRiskCheck>(100);
+    RiskLimits limits;
+    limits.max_order_notional = 1000000;
+    risk_check->setLimits(5, limits);
+    market.setRiskCheck(risk_check);
+
+    // The notional values wrap around to 0 in 32-bit and 64-bit prices respectively.
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 65536, 65536, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, std::numeric_limits<Price>::max() / 2 + 1, 2, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1000, 1000, OrderTimeInForce::GTC, 5));
+    checkOrderRejected(1, RejectReason::NotionalLimit);
+    checkOrderRejected(2, RejectReason::NotionalLimit);
+    checkOrderAdded(3);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests that a risk stage that is shared by the workers of a concurrent market enforces the
+ * limits of an account across symbols that are owned by different workers.
+ */
+TEST(ConcurrentMarketTest, RiskCheckShouldWork1)
+{
+    const uint32_t num_workers = 2;
+    std::vector<std::unique_ptr<EventHandler>> event_handlers;
+    for (uint32_t i = 0; i < num_workers; ++i)
+        event_handlers.push_back(std::make_unique<RecordingEventHandler>());
+    ConcurrentMarket concurrent_market{event_handlers, num_workers};
+    auto risk_check = std::make_shared<AccountRiskCheck>(100);
+    RiskLimits limits;
+    limits.max_position = 1000;
+    risk_check->setLimits(5, limits);
+    concurrent_market.setRiskCheck(risk_check);
+    for (uint32_t symbol_id = 1; symbol_id <= 4; ++symbol_id)
+    {
+        concurrent_market.addSymbol(symbol_id, "SYMBOL" + std::to_string(symbol_id));
+        concurrent_market.addOrder(Order::limitBidOrder(symbol_id, symbol_id, 1000, 300, OrderTimeInForce::GTC, 5));
+    }
+    for (uint32_t symbol_id = 1; symbol_id <= 4; ++symbol_id)
+        concurrent_market.queryStatistics(symbol_id).get();
+    ASSERT_EQ(risk_check->getOpenQuantity(5, OrderSide::Bid), 900);
+}
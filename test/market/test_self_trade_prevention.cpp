@@ -0,0 +1,148 @@
+#include "market_test_fixture.h"
+
+/**
+ * Tests that self-trade prevention cancels the incoming order when the mode is cancel newest.
+ */
+TEST_F(MarketTest, SelfTradePreventionShouldWork1)
+{
+    market.setSelfTradePrevention(symbol_id, SelfTradePrevention::CancelNewest);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 1000, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1400, 500, OrderTimeInForce::GTC, 6));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1400, 800, OrderTimeInForce::GTC, 5));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrderDeleted(3, 0, 0, 0);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 1500);
+}
+
+/**
+ * Tests that self-trade prevention deletes the resting order and continues matching
+ * when the mode is cancel oldest.
+ */
+TEST_F(MarketTest, SelfTradePreventionShouldWork2)
+{
+    market.setSelfTradePrevention(symbol_id, SelfTradePrevention::CancelOldest);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 1000, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1400, 500, OrderTimeInForce::GTC, 6));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1400, 800, OrderTimeInForce::GTC, 5));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrderDeleted(1, 0, 0, 1000);
+    checkExecutedOrder(2, 1400, 500, 0);
+    checkExecutedOrder(3, 1400, 500, 300);
+    checkOrderDeleted(2, 1400, 500, 0);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 0);
+    ASSERT_EQ(market.askVolumeAtOrBelow(symbol_id, 1400), 300);
+}
+
+/**
+ * Tests that self-trade prevention deletes both orders when the mode is cancel both.
+ */
+TEST_F(MarketTest, SelfTradePreventionShouldWork3)
+{
+    market.setSelfTradePrevention(symbol_id, SelfTradePrevention::CancelBoth);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 1000, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1400, 500, OrderTimeInForce::GTC, 6));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1400, 800, OrderTimeInForce::GTC, 5));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrderDeleted(1, 0, 0, 1000);
+    checkOrderDeleted(3, 0, 0, 0);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 500);
+}
+
+/**
+ * Tests that self-trade prevention reduces both orders by the smaller open quantity
+ * when the mode is decrement.
+ */
+TEST_F(MarketTest, SelfTradePreventionShouldWork4)
+{
+    market.setSelfTradePrevention(symbol_id, SelfTradePrevention::Decrement);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 1000, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1400, 500, OrderTimeInForce::GTC, 6));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1400, 800, OrderTimeInForce::GTC, 5));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrderUpdated(1, 0, 0, 200);
+    checkOrderDeleted(3, 0, 0, 0);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 700);
+
+    // The decremented order should trade with orders of other owners.
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 1500, 200, OrderTimeInForce::IOC, 6));
+
+    checkOrderAdded(4);
+    checkExecutedOrder(1, 1500, 200, 0);
+    checkExecutedOrder(4, 1500, 200, 0);
+    checkOrderDeleted(1, 1500, 200, 0);
+    checkOrderDeleted(4, 1500, 200, 0);
+    ASSERT_TRUE(market_debugger.empty());
+}
+
+/**
+ * Tests that a FOK order is only filled if the book has enough volume from other owners
+ * when the mode is cancel oldest.
+ */
+TEST_F(MarketTest, SelfTradePreventionShouldWork5)
+{
+    market.setSelfTradePrevention(symbol_id, SelfTradePrevention::CancelOldest);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 1000, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1400, 500, OrderTimeInForce::GTC, 6));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1400, 800, OrderTimeInForce::FOK, 5));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrderDeleted(3, 0, 0, 800);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 1500);
+
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 1400, 500, OrderTimeInForce::FOK, 5));
+
+    checkOrderAdded(4);
+    checkOrderDeleted(1, 0, 0, 1000);
+    checkExecutedOrder(2, 1400, 500, 0);
+    checkExecutedOrder(4, 1400, 500, 0);
+    checkOrderDeleted(2, 1400, 500, 0);
+    checkOrderDeleted(4, 1400, 500, 0);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 0);
+}
+
+/**
+ * Tests that a FOK order is only filled if it is filled before reaching a level with an
+ * order of its owner when the mode is cancel newest.
+ */
+TEST_F(MarketTest, SelfTradePreventionShouldWork6)
+{
+    market.setSelfTradePrevention(symbol_id, SelfTradePrevention::CancelNewest);
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1500, 500, OrderTimeInForce::GTC, 6));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 1400, 1000, OrderTimeInForce::GTC, 5));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 1400, 600, OrderTimeInForce::FOK, 5));
+
+    checkOrderAdded(1);
+    checkOrderAdded(2);
+    checkOrderAdded(3);
+    checkOrderDeleted(3, 0, 0, 600);
+    ASSERT_TRUE(market_debugger.empty());
+
+    market.addOrder(Order::limitAskOrder(4, symbol_id, 1400, 400, OrderTimeInForce::FOK, 5));
+
+    checkOrderAdded(4);
+    checkExecutedOrder(1, 1500, 400, 100);
+    checkExecutedOrder(4, 1500, 400, 0);
+    checkOrderDeleted(4, 1500, 400, 0);
+    ASSERT_TRUE(market_debugger.empty());
+    ASSERT_EQ(market.bidVolumeAtOrAbove(symbol_id, 0), 1100);
+}
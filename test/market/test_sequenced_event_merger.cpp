@@ -0,0 +1,104 @@
+#include <random>
+#include <thread>
+#include <gtest/gtest.h>
+#include "market/sequenced_event_merger.h"
+#include "recording_event_handler.h"
+
+using namespace RapidTrader;
+
+/**
+ * Tests that the events of the workers of a concurrent market are stamped with the sequence
+ * numbers of their commands, and that the merged stream of events is the same as the stream
+ * of a market that applies the same commands on one thread.
+ */
+TEST(SequencedEventMergerTest, MergedEventsShouldMatchSingleThreadedMarket1)
+{
+    const uint32_t num_workers = 4;
+    auto merged_recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &merged_events = *merged_recorder;
+    SequencedEventMerger merger{std::move(merged_recorder), num_workers};
+    std::vector<std::unique_ptr<EventHandler>> event_handlers = merger.createEventHandlers();
+    ConcurrentMarket concurrent_market{event_handlers, num_workers};
+    auto recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &expected_events = *recorder;
+    Market market{std::move(recorder)};
+
+    uint64_t num_commands = 0;
+    const uint32_t num_symbols = 8;
+    for (uint32_t symbol_id = 1; symbol_id <= num_symbols; ++symbol_id)
+    {
+        concurrent_market.addSymbol(symbol_id, "SYMBOL" + std::to_string(symbol_id));
+        market.addSymbol(symbol_id, "SYMBOL" + std::to_string(symbol_id));
+        ++num_commands;
+    }
+    std::mt19937 random(11);
+    uint64_t order_id = 1;
+    for (int i = 0; i < 5000; ++i)
+    {
+        uint32_t symbol_id = 1 + random() % num_symbols;
+        const auto &resting = expected_events.resting_orders[symbol_id];
+        if (i % 1000 == 500)
+        {
+            // Market-wide commands are sent to every worker under one sequence number.
+            concurrent_market.haltMarket();
+            market.haltMarket();
+            concurrent_market.resumeMarket();
+            market.resumeMarket();
+            num_commands += 2;
+        }
+        else if (random() % 4 != 0 || resting.empty())
+        {
+            Price price = 1000 + random() % 20;
+            Quantity quantity = 1 + random() % 100;
+            Order order = random() % 2 == 0 ? Order::limitBidOrder(order_id++, symbol_id, price, quantity, OrderTimeInForce::GTC)
+                                            : Order::limitAskOrder(order_id++, symbol_id, price, quantity, OrderTimeInForce::GTC);
+            concurrent_market.addOrder(order);
+            market.addOrder(order);
+            ++num_commands;
+        }
+        else
+        {
+            uint64_t resting_order_id = *resting.begin();
+            concurrent_market.deleteOrder(symbol_id, resting_order_id);
+            market.deleteOrder(symbol_id, resting_order_id);
+            ++num_commands;
+        }
+        // Merge while the workers are still applying commands.
+        if (i % 64 == 0)
+            merger.poll(concurrent_market);
+    }
+    while (concurrent_market.sequenceWatermark() < num_commands)
+        std::this_thread::yield();
+    merger.poll(concurrent_market);
+
+    EXPECT_EQ(merger.pending(), 0);
+    ASSERT_FALSE(expected_events.sequenced_events.empty());
+    EXPECT_EQ(expected_events.sequenced_events.front().rfind("1: ", 0), 0);
+    EXPECT_EQ(merged_events.sequenced_events, expected_events.sequenced_events);
+}
+
+/**
+ * Tests that the events of symbols that are owned by different workers are interleaved in
+ * the order that their commands were submitted.
+ */
+TEST(SequencedEventMergerTest, MergedEventsShouldBeInSequenceOrder1)
+{
+    const uint32_t num_workers = 2;
+    auto merged_recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &merged_events = *merged_recorder;
+    SequencedEventMerger merger{std::move(merged_recorder), num_workers};
+    std::vector<std::unique_ptr<EventHandler>> event_handlers = merger.createEventHandlers();
+    ConcurrentMarket concurrent_market{event_handlers, num_workers};
+
+    concurrent_market.addSymbol(1, "SYMBOL1");
+    concurrent_market.addSymbol(2, "SYMBOL2");
+    concurrent_market.addOrder(Order::limitBidOrder(1, 1, 1000, 10, OrderTimeInForce::GTC));
+    concurrent_market.addOrder(Order::limitBidOrder(2, 2, 1000, 10, OrderTimeInForce::GTC));
+    while (concurrent_market.sequenceWatermark() < 4)
+        std::this_thread::yield();
+    EXPECT_EQ(merger.poll(concurrent_market), 4);
+
+    std::vector<std::string> expected_events = {"1: " + merged_events.symbol_events[1][0], "2: " + merged_events.symbol_events[2][0],
+        "3: " + merged_events.symbol_events[1][1], "4: " + merged_events.symbol_events[2][1]};
+    EXPECT_EQ(merged_events.sequenced_events, expected_events);
+}
@@ -0,0 +1,160 @@
+#include <csignal>
+#include <random>
+#include <gtest/gtest.h>
+#include "market/sharded_market.h"
+#include "recording_event_handler.h"
+
+using namespace RapidTrader;
+
+/**
+ * Tests that a market sharded across several processes sends the same events for each
+ * symbol as a market in a single process.
+ */
+TEST(ShardedMarketTest, ShardsShouldMatchInProcessMarket1)
+{
+    const uint8_t num_shards = 3;
+    const uint32_t num_symbols = 7;
+    std::vector<std::unique_ptr<EventHandler>> event_handlers;
+    std::vector<RecordingEventHandler *> shard_recorders;
+    for (uint8_t i = 0; i < num_shards; ++i)
+    {
+        auto recorder = std::make_unique<RecordingEventHandler>();
+        shard_recorders.push_back(recorder.get());
+        event_handlers.push_back(std::move(recorder));
+    }
+    // Keep the rings small so that the router and the shards have to wait for each other.
+    ShardedMarket sharded_market{event_handlers, num_shards, 64};
+    auto market_recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &recorder = *market_recorder;
+    Market market{std::move(market_recorder)};
+
+    for (uint32_t symbol_id = 1; symbol_id <= num_symbols; ++symbol_id)
+    {
+        market.addSymbol(symbol_id, "SYMBOL" + std::to_string(symbol_id));
+        sharded_market.addSymbol(symbol_id, "SYMBOL" + std::to_string(symbol_id));
+    }
+
+    std::mt19937 random(42);
+    uint64_t order_id = 1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        uint32_t symbol_id = 1 + random() % num_symbols;
+        const auto &resting = recorder.resting_orders[symbol_id];
+        uint32_t action = random() % 10;
+        if (action < 6 || resting.empty())
+        {
+            Price price = 1000 + random() % 20;
+            Quantity quantity = 1 + random() % 100;
+            OrderTimeInForce time_in_force = random() % 4 == 0 ? OrderTimeInForce::IOC : OrderTimeInForce::GTC;
+            Order order = random() % 2 == 0 ? Order::limitBidOrder(order_id, symbol_id, price, quantity, time_in_force)
+                                            : Order::limitAskOrder(order_id, symbol_id, price, quantity, time_in_force);
+            ++order_id;
+            market.addOrder(order);
+            sharded_market.addOrder(order);
+            continue;
+        }
+        uint64_t resting_id = *std::next(resting.begin(), random() % resting.size());
+        if (action == 6)
+        {
+            market.deleteOrder(symbol_id, resting_id);
+            sharded_market.deleteOrder(symbol_id, resting_id);
+        }
+        else if (action == 7)
+        {
+            Quantity new_quantity = 1 + random() % 100;
+            Price new_price = 1000 + random() % 20;
+            market.amendOrder(symbol_id, resting_id, new_quantity, new_price);
+            sharded_market.amendOrder(symbol_id, resting_id, new_quantity, new_price);
+        }
+        else if (action == 8)
+        {
+            Price new_price = 1000 + random() % 20;
+            market.replaceOrder(symbol_id, resting_id, order_id, new_price);
+            sharded_market.replaceOrder(symbol_id, resting_id, order_id, new_price);
+            ++order_id;
+        }
+        else
+        {
+            market.executeOrder(symbol_id, resting_id, 1);
+            sharded_market.executeOrder(symbol_id, resting_id, 1);
+        }
+    }
+    market.deleteSymbol(num_symbols);
+    sharded_market.deleteSymbol(num_symbols);
+    Order unknown_symbol_order = Order::limitBidOrder(order_id, num_symbols + 1, 1000, 10, OrderTimeInForce::GTC);
+    market.addOrder(unknown_symbol_order);
+    sharded_market.addOrder(unknown_symbol_order);
+    sharded_market.sync();
+
+    std::map<uint32_t, std::vector<std::string>> shard_events;
+    for (auto *shard_recorder : shard_recorders)
+    {
+        for (auto &[symbol_id, events] : shard_recorder->symbol_events)
+        {
+            ASSERT_TRUE(shard_events.find(symbol_id) == shard_events.end());
+            shard_events[symbol_id] = events;
+        }
+    }
+    ASSERT_EQ(shard_events.size(), num_symbols + 1);
+    ASSERT_EQ(shard_events, recorder.symbol_events);
+}
+
+/**
+ * Tests that the trade bars of a shard are delivered to the event handler of the shard.
+ */
+TEST(ShardedMarketTest, TradeBarsShouldBeDelivered1)
+{
+    std::vector<std::unique_ptr<EventHandler>> event_handlers;
+    auto recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &events = *recorder;
+    event_handlers.push_back(std::move(recorder));
+    ShardedMarket sharded_market{event_handlers, 1};
+    uint32_t symbol_id = 1;
+    sharded_market.addSymbol(symbol_id, "SYMBOL1");
+    // Bars of a nanosecond have all ended by the time the bars are closed.
+    sharded_market.setBarInterval(symbol_id, 1);
+    sharded_market.addOrder(Order::limitAskOrder(1, symbol_id, 1000, 100, OrderTimeInForce::GTC));
+    sharded_market.addOrder(Order::limitBidOrder(2, symbol_id, 1000, 30, OrderTimeInForce::GTC));
+    sharded_market.addOrder(Order::limitBidOrder(3, symbol_id, 1000, 20, OrderTimeInForce::GTC));
+    sharded_market.closeBars();
+    sharded_market.sync();
+
+    ASSERT_FALSE(events.trade_bars.empty());
+    Volume volume = 0;
+    uint64_t num_trades = 0;
+    for (const TradeBar &bar : events.trade_bars)
+    {
+        EXPECT_EQ(bar.symbol_id, symbol_id);
+        EXPECT_EQ(bar.close_price, 1000);
+        EXPECT_LT(bar.start_time, bar.end_time);
+        volume += bar.volume;
+        num_trades += bar.num_trades;
+    }
+    EXPECT_EQ(volume, 50);
+    EXPECT_EQ(num_trades, 2);
+}
+
+/**
+ * Tests that a shard process that dies is reported instead of being waited for forever.
+ */
+TEST(ShardedMarketTest, ShardExitShouldBeReported1)
+{
+    const uint8_t num_shards = 2;
+    std::vector<std::unique_ptr<EventHandler>> event_handlers;
+    for (uint8_t i = 0; i < num_shards; ++i)
+        event_handlers.push_back(std::make_unique<RecordingEventHandler>());
+    ShardedMarket sharded_market{event_handlers, num_shards, 64};
+    sharded_market.addSymbol(1, "SYMBOL1");
+    sharded_market.addSymbol(2, "SYMBOL2");
+    sharded_market.sync();
+
+    ASSERT_EQ(kill(sharded_market.shardProcess(1), SIGKILL), 0);
+    // The commands for the dead shard fill its ring.
+    EXPECT_THROW(
+        {
+            for (uint64_t order_id = 1; order_id <= 1000; ++order_id)
+                sharded_market.addOrder(Order::limitBidOrder(order_id, 2, 1000, 10, OrderTimeInForce::GTC));
+        },
+        std::runtime_error);
+    EXPECT_THROW(sharded_market.sync(), std::runtime_error);
+}
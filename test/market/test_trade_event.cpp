@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include "market/market.h"
+#include "recording_event_handler.h"
+
+/**
+ * Tests that matching an incoming order sends one trade event for each fill, with the incoming
+ * order as the aggressor, and no executed order events.
+ */
+TEST(TradeEventTest, TradeEventShouldWork1)
+{
+    auto recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &events = *recorder;
+    Market market{std::move(recorder)};
+    uint32_t symbol_id = 1;
+    market.addSymbol(symbol_id, "SYMBOL1");
+    market.addOrder(Order::limitBidOrder(1, symbol_id, 1000, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitBidOrder(2, symbol_id, 990, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(3, symbol_id, 990, 150, OrderTimeInForce::GTC));
+
+    ASSERT_EQ(events.trades.size(), 2);
+    const Trade &first_trade = events.trades[0];
+    EXPECT_EQ(first_trade.symbol_id, symbol_id);
+    EXPECT_EQ(first_trade.aggressor_id, 3);
+    EXPECT_EQ(first_trade.passive_id, 1);
+    EXPECT_EQ(first_trade.aggressor_side, OrderSide::Ask);
+    EXPECT_EQ(first_trade.price, 1000);
+    EXPECT_EQ(first_trade.quantity, 100);
+    EXPECT_EQ(first_trade.aggressor_open_quantity, 50);
+    EXPECT_EQ(first_trade.passive_open_quantity, 0);
+    const Trade &second_trade = events.trades[1];
+    EXPECT_EQ(second_trade.passive_id, 2);
+    EXPECT_EQ(second_trade.price, 990);
+    EXPECT_EQ(second_trade.quantity, 50);
+    EXPECT_EQ(second_trade.aggressor_open_quantity, 0);
+    EXPECT_EQ(second_trade.passive_open_quantity, 50);
+    for (const auto &event : events.symbol_events[symbol_id])
+        EXPECT_NE(event.rfind("EXECUTED ORDER", 0), 0);
+}
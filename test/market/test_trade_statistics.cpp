@@ -0,0 +1,127 @@
+#include <thread>
+#include <gtest/gtest.h>
+#include "market/market.h"
+#include "recording_event_handler.h"
+
+/**
+ * Tests that the trading statistics of a symbol count each fill once and are updated by
+ * matching, auctions, and manual executions.
+ */
+TEST(TradeStatisticsTest, StatisticsShouldWork1)
+{
+    auto recorder = std::make_unique<RecordingEventHandler>();
+    Market market{std::move(recorder), std::make_shared<ManualClock>(1000)};
+    uint32_t symbol_id = 1;
+    market.addSymbol(symbol_id, "SYMBOL1");
+    market.addOrder(Order::limitAskOrder(1, symbol_id, 1000, 100, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(2, symbol_id, 1010, 100, OrderTimeInForce::GTC));
+    // Fills 100 at 1000 and 50 at 1010.
+    market.addOrder(Order::limitBidOrder(3, symbol_id, 1010, 150, OrderTimeInForce::GTC));
+    // Fills 50 at 990.
+    market.executeOrder(symbol_id, 2, 50, 990);
+
+    SymbolStatistics symbol_statistics = market.statistics(symbol_id);
+    EXPECT_EQ(symbol_statistics.num_trades, 3);
+    EXPECT_EQ(symbol_statistics.traded_volume, 200);
+    EXPECT_EQ(symbol_statistics.open_price, 1000);
+    EXPECT_EQ(symbol_statistics.high_price, 1010);
+    EXPECT_EQ(symbol_statistics.low_price, 990);
+    EXPECT_EQ(symbol_statistics.last_traded_price, 990);
+    EXPECT_DOUBLE_EQ(symbol_statistics.vwap, (1000.0 * 100 + 1010.0 * 50 + 990.0 * 50) / 200);
+
+    market.startAuction(symbol_id);
+    market.addOrder(Order::limitBidOrder(4, symbol_id, 1020, 10, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(5, symbol_id, 1020, 10, OrderTimeInForce::GTC));
+    market.uncrossAuction(symbol_id);
+    symbol_statistics = market.statistics(symbol_id);
+    EXPECT_EQ(symbol_statistics.num_trades, 4);
+    EXPECT_EQ(symbol_statistics.traded_volume, 210);
+    EXPECT_EQ(symbol_statistics.high_price, 1020);
+
+    SymbolStatistics unknown_statistics = market.statistics(symbol_id + 1);
+    EXPECT_EQ(unknown_statistics.num_trades, 0);
+    EXPECT_EQ(unknown_statistics.vwap, 0);
+}
+
+/**
+ * Tests that the trades of a symbol are aggregated into bars that are sent once a trade
+ * occurs after the end of their interval or the bars are closed after it.
+ */
+TEST(TradeStatisticsTest, TradeBarsShouldWork1)
+{
+    auto recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &events = *recorder;
+    auto clock = std::make_shared<ManualClock>(1000);
+    Market market{std::move(recorder), clock};
+    uint32_t symbol_id = 1;
+    market.addSymbol(symbol_id, "SYMBOL1");
+    market.setBarInterval(symbol_id, 1000);
+    market.addOrder(Order::limitAskOrder(1, symbol_id, 1000, 1000, OrderTimeInForce::GTC));
+    market.addOrder(Order::limitAskOrder(2, symbol_id, 1010, 1000, OrderTimeInForce::GTC));
+
+    clock->setTime(1100);
+    market.addOrder(Order::marketBidOrder(3, symbol_id, 10, OrderTimeInForce::IOC));
+    clock->setTime(1900);
+    market.addOrder(Order::limitBidOrder(4, symbol_id, 1010, 1000, OrderTimeInForce::IOC));
+    market.closeBars();
+    EXPECT_TRUE(events.trade_bars.empty());
+
+    // The first trade of the next interval sends the bar of the previous one.
+    clock->setTime(2500);
+    market.addOrder(Order::marketBidOrder(5, symbol_id, 20, OrderTimeInForce::IOC));
+    ASSERT_EQ(events.trade_bars.size(), 1);
+    const TradeBar &first_bar = events.trade_bars[0];
+    EXPECT_EQ(first_bar.symbol_id, symbol_id);
+    EXPECT_EQ(first_bar.start_time, 1000);
+    EXPECT_EQ(first_bar.end_time, 2000);
+    EXPECT_EQ(first_bar.open_price, 1000);
+    EXPECT_EQ(first_bar.high_price, 1010);
+    EXPECT_EQ(first_bar.low_price, 1000);
+    EXPECT_EQ(first_bar.close_price, 1010);
+    EXPECT_EQ(first_bar.volume, 1010);
+    EXPECT_EQ(first_bar.num_trades, 3);
+
+    // An idle symbol only sends its bar once the bars are closed.
+    clock->setTime(5000);
+    ASSERT_EQ(events.trade_bars.size(), 1);
+    market.closeBars();
+    ASSERT_EQ(events.trade_bars.size(), 2);
+    EXPECT_EQ(events.trade_bars[1].start_time, 2000);
+    EXPECT_EQ(events.trade_bars[1].volume, 20);
+    EXPECT_EQ(events.trade_bars[1].close_price, 1010);
+    market.closeBars();
+    EXPECT_EQ(events.trade_bars.size(), 2);
+
+    market.setBarInterval(symbol_id, 0);
+    market.addOrder(Order::marketBidOrder(6, symbol_id, 20, OrderTimeInForce::IOC));
+    clock->setTime(10000);
+    market.closeBars();
+    EXPECT_EQ(events.trade_bars.size(), 2);
+}
+
+/**
+ * Tests that the bars of a concurrent market are sent by the worker that owns the symbol.
+ */
+TEST(TradeStatisticsTest, TradeBarsShouldWork2)
+{
+    auto clock = std::make_shared<ManualClock>(1000);
+    std::vector<std::unique_ptr<EventHandler>> event_handlers;
+    auto recorder = std::make_unique<RecordingEventHandler>();
+    RecordingEventHandler &events = *recorder;
+    event_handlers.push_back(std::move(recorder));
+    ConcurrentMarket concurrent_market{event_handlers, 1, clock};
+    uint32_t symbol_id = 1;
+    concurrent_market.addSymbol(symbol_id, "SYMBOL1");
+    concurrent_market.setBarInterval(symbol_id, 1000);
+    concurrent_market.addOrder(Order::limitAskOrder(1, symbol_id, 1000, 100, OrderTimeInForce::GTC));
+    concurrent_market.addOrder(Order::limitBidOrder(2, symbol_id, 1000, 40, OrderTimeInForce::GTC));
+    SymbolStatistics symbol_statistics = concurrent_market.queryStatistics(symbol_id).get();
+    EXPECT_EQ(symbol_statistics.num_trades, 1);
+    EXPECT_EQ(symbol_statistics.traded_volume, 40);
+
+    clock->setTime(3000);
+    concurrent_market.closeBars();
+    concurrent_market.queryStatistics(symbol_id).get();
+    ASSERT_EQ(events.trade_bars.size(), 1);
+    EXPECT_EQ(events.trade_bars[0].volume, 40);
+}
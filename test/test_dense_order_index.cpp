@@ -0,0 +1,137 @@
+#include <limits>
+#include <gtest/gtest.h>
+#include "dense_order_index.h"
+
+using namespace RapidTrader;
+
+TEST(DenseOrderIndex, InsertingAndFindingElementsShouldWork1)
+{
+    DenseOrderIndex<uint64_t, 4> index;
+    // Index should initially be empty.
+    ASSERT_TRUE(index.empty());
+    ASSERT_EQ(index.find(1), index.end());
+    // Insert elements spanning several pages.
+    for (uint64_t id = 1; id <= 100; ++id)
+    {
+        auto [it, inserted] = index.emplace(id, id * 10);
+        ASSERT_TRUE(inserted);
+        ASSERT_EQ(it->first, id);
+    }
+    ASSERT_EQ(index.size(), 100);
+    // Inserting an existing ID should not replace the element.
+    auto [it, inserted] = index.emplace(50, 0);
+    ASSERT_FALSE(inserted);
+    ASSERT_EQ(it->second, 500);
+    // All elements should be found.
+    for (uint64_t id = 1; id <= 100; ++id)
+        ASSERT_EQ(index.find(id)->second, id * 10);
+    // IDs outside of the covered range should not be found.
+    ASSERT_EQ(index.find(0), index.end());
+    ASSERT_EQ(index.find(101), index.end());
+    ASSERT_EQ(index.find(1000000), index.end());
+}
+
+TEST(DenseOrderIndex, ErasingElementsShouldRecyclePages1)
+{
+    DenseOrderIndex<uint64_t, 4> index;
+    for (uint64_t id = 0; id < 64; ++id)
+        index.emplace(id, id);
+    // 64 IDs should span 4 pages of 16 IDs.
+    ASSERT_EQ(index.numberOfPages(), 4);
+    // Erase the IDs in the first two pages.
+    for (uint64_t id = 0; id < 32; ++id)
+        index.erase(index.find(id));
+    ASSERT_EQ(index.size(), 32);
+    ASSERT_EQ(index.numberOfPages(), 2);
+    // Only one of the recycled pages is kept for reuse.
+    ASSERT_EQ(index.capacity(), 48);
+    ASSERT_EQ(index.find(5), index.end());
+    ASSERT_EQ(index.find(40)->second, 40);
+    // IDs below the first page should still be insertable.
+    auto [it, inserted] = index.emplace(3, 3);
+    ASSERT_TRUE(inserted);
+    ASSERT_EQ(index.numberOfPages(), 3);
+    ASSERT_EQ(index.find(3)->second, 3);
+    // Erase everything.
+    index.erase(index.find(3));
+    for (uint64_t id = 32; id < 64; ++id)
+        index.erase(index.find(id));
+    ASSERT_TRUE(index.empty());
+    ASSERT_EQ(index.numberOfPages(), 0);
+    ASSERT_EQ(index.capacity(), 16);
+}
+
+TEST(DenseOrderIndex, ReservedPagesShouldBeKept1)
+{
+    DenseOrderIndex<uint64_t, 4> index;
+    index.reserve(64);
+    // 64 sequential IDs may straddle 5 pages of 16 IDs.
+    ASSERT_EQ(index.capacity(), 80);
+    // Sparse IDs each take a page of their own.
+    for (uint64_t id = 0; id < 8; ++id)
+        index.emplace(id * 1000, id);
+    ASSERT_EQ(index.numberOfPages(), 8);
+    ASSERT_EQ(index.capacity(), 128);
+    // Erasing them keeps the reserved pages but frees the rest.
+    for (uint64_t id = 0; id < 8; ++id)
+        index.erase(index.find(id * 1000));
+    ASSERT_TRUE(index.empty());
+    ASSERT_EQ(index.capacity(), 80);
+}
+
+TEST(DenseOrderIndex, AllocatedPagesShouldNeverDecrease1)
+{
+    DenseOrderIndex<uint64_t, 4> index;
+    for (uint64_t id = 0; id < 64; ++id)
+        index.emplace(id, id);
+    ASSERT_EQ(index.numberOfAllocatedPages(), 4);
+    // Freeing pages lowers the capacity but not the number of allocated pages.
+    for (uint64_t id = 0; id < 48; ++id)
+        index.erase(index.find(id));
+    ASSERT_EQ(index.capacity(), 32);
+    ASSERT_EQ(index.numberOfAllocatedPages(), 4);
+    // Inserting into a live page or a recycled page does not allocate.
+    index.emplace(0, 0);
+    index.emplace(48, 48);
+    ASSERT_EQ(index.numberOfAllocatedPages(), 4);
+    // Growing back into a freed page does.
+    index.emplace(16, 16);
+    ASSERT_EQ(index.numberOfAllocatedPages(), 5);
+}
+
+TEST(DenseOrderIndex, FarIdsShouldNotAllocateTheGap1)
+{
+    using Index = DenseOrderIndex<uint64_t, 4>;
+    Index index;
+    uint64_t far_id = uint64_t{1} << 44;
+    index.emplace(1, 1);
+    index.emplace(far_id, 2);
+    index.emplace(std::numeric_limits<uint64_t>::max(), 3);
+    // Only the page of the first ID is allocated.
+    ASSERT_EQ(index.numberOfAllocatedPages(), 1);
+    ASSERT_EQ(index.size(), 3);
+    ASSERT_EQ(index.find(far_id)->second, 2);
+    ASSERT_EQ(index.find(std::numeric_limits<uint64_t>::max())->second, 3);
+    ASSERT_EQ(index.find(far_id + 1), index.end());
+    ASSERT_FALSE(index.emplace(far_id, 0).second);
+    // An ID at the edge of the span is stored in a page, but the next one is not.
+    uint64_t last_id = Index::max_span_pages * Index::page_size - 1;
+    index.emplace(last_id, 4);
+    index.emplace(last_id + 1, 5);
+    ASSERT_EQ(index.numberOfAllocatedPages(), 2);
+    ASSERT_EQ(index.find(last_id + 1)->second, 5);
+    // Far IDs can be erased like any other.
+    index.erase(index.find(far_id));
+    ASSERT_EQ(index.find(far_id), index.end());
+    index.erase(index.find(last_id + 1));
+    index.erase(index.find(last_id));
+    index.erase(index.find(1));
+    ASSERT_EQ(index.size(), 1);
+    // Once the pages are empty, a far ID starts a new window.
+    index.emplace(far_id, 6);
+    ASSERT_EQ(index.numberOfAllocatedPages(), 2);
+    ASSERT_EQ(index.find(far_id)->second, 6);
+    index.erase(index.find(std::numeric_limits<uint64_t>::max()));
+    index.erase(index.find(far_id));
+    ASSERT_TRUE(index.empty());
+}
@@ -0,0 +1,80 @@
+#include <map>
+#include <gtest/gtest.h>
+#include "depth_index.h"
+
+using namespace RapidTrader;
+
+TEST(DepthIndex, CumulativeVolumeQueriesShouldWork1)
+{
+    DepthIndex depth;
+    // Index should initially be empty.
+    ASSERT_EQ(depth.totalVolume(), 0);
+    ASSERT_EQ(depth.volumeAtOrBelow(1000), 0);
+    // Add volume at prices spread far enough apart that the window has to grow.
+    for (Price price = 1000; price < 2000; price += 10)
+        depth.add(price, 5);
+    ASSERT_EQ(depth.totalVolume(), 500);
+    ASSERT_EQ(depth.volumeAtOrBelow(999), 0);
+    ASSERT_EQ(depth.volumeAtOrBelow(1000), 5);
+    ASSERT_EQ(depth.volumeAtOrBelow(1009), 5);
+    ASSERT_EQ(depth.volumeAtOrBelow(1500), 255);
+    ASSERT_EQ(depth.volumeAtOrBelow(5000), 500);
+    ASSERT_EQ(depth.volumeAtOrAbove(1990), 5);
+    ASSERT_EQ(depth.volumeAtOrAbove(1991), 0);
+    ASSERT_EQ(depth.volumeAtOrAbove(0), 500);
+    // Remove volume.
+    depth.remove(1500, 5);
+    depth.remove(1000, 3);
+    ASSERT_EQ(depth.volumeAtOrBelow(1500), 247);
+    ASSERT_EQ(depth.totalVolume(), 492);
+}
+
+TEST(DepthIndex, PricesOutsideOfWindowShouldWork1)
+{
+    DepthIndex depth{128};
+    depth.add(1000, 10);
+    // Prices that do not fit in the window should be tracked separately.
+    depth.add(1, 20);
+    depth.add(1000000, 30);
+    ASSERT_EQ(depth.volumeAtOrBelow(0), 0);
+    ASSERT_EQ(depth.volumeAtOrBelow(1), 20);
+    ASSERT_EQ(depth.volumeAtOrBelow(1000), 30);
+    ASSERT_EQ(depth.volumeAtOrBelow(999999), 30);
+    ASSERT_EQ(depth.volumeAtOrBelow(1000000), 60);
+    ASSERT_EQ(depth.volumeAtOrAbove(1000), 40);
+    depth.remove(1, 20);
+    depth.remove(1000000, 30);
+    ASSERT_EQ(depth.totalVolume(), 10);
+    ASSERT_EQ(depth.volumeAtOrBelow(1000000), 10);
+}
+
+TEST(DepthIndex, WindowShouldFollowPrices1)
+{
+    DepthIndex depth{128};
+    std::map<Price, Volume> volumes;
+    // The prices drift far beyond the window, with the oldest prices being removed as the newest are added.
+    for (Price price = 1000; price < 20000; price += 7)
+    {
+        depth.add(price, price % 13 + 1);
+        volumes[price] += price % 13 + 1;
+        if (price >= 1000 + 7 * 15)
+        {
+            Price old_price = price - 7 * 15;
+            depth.remove(old_price, volumes[old_price]);
+            volumes.erase(old_price);
+        }
+        // The window re-centres on the newest prices, so they do not all end up as outliers.
+        ASSERT_LT(depth.numberOfOutliers(), 15);
+    }
+    // A price far away from the others stays an outlier.
+    depth.add(1, 5);
+    volumes[1] += 5;
+    for (Price price : {Price{0}, Price{1}, Price{18000}, Price{19000}, Price{19990}, Price{19999}, Price{30000}})
+    {
+        Volume expected = 0;
+        for (auto it = volumes.begin(); it != volumes.end() && it->first <= price; ++it)
+            expected += it->second;
+        ASSERT_EQ(depth.volumeAtOrBelow(price), expected);
+        ASSERT_EQ(depth.volumeAtOrAbove(price + 1), depth.totalVolume() - expected);
+    }
+}
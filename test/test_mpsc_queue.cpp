@@ -0,0 +1,56 @@
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "concurrent/mpsc_queue.h"
+
+using namespace RapidTrader::Concurrent;
+
+TEST(MpscQueue, PushingAndPoppingShouldWork1)
+{
+    MpscQueue<uint64_t> queue(4);
+    uint64_t item = 0;
+    ASSERT_TRUE(queue.empty());
+    ASSERT_FALSE(queue.tryPop(item));
+    // Go around the ring a few times.
+    for (uint64_t i = 1; i <= 10; ++i)
+    {
+        queue.push(i);
+        queue.push(i + 100);
+        ASSERT_TRUE(queue.tryPop(item));
+        ASSERT_EQ(item, i);
+        ASSERT_TRUE(queue.tryPop(item));
+        ASSERT_EQ(item, i + 100);
+    }
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(MpscQueue, ItemsFromEachProducerShouldArriveInOrder1)
+{
+    // Keep the ring small so that the producers have to wait for the consumer.
+    MpscQueue<uint64_t> queue(64);
+    const uint64_t num_producers = 4;
+    const uint64_t num_items = 20000;
+    std::vector<std::thread> producers;
+    for (uint64_t producer = 0; producer < num_producers; ++producer)
+    {
+        producers.emplace_back([&queue, producer] {
+            for (uint64_t i = 0; i < num_items; ++i)
+                queue.push(producer * num_items + i);
+        });
+    }
+    std::vector<uint64_t> next_item(num_producers, 0);
+    uint64_t num_popped = 0;
+    uint64_t item = 0;
+    while (num_popped < num_producers * num_items)
+    {
+        if (!queue.tryPop(item))
+            continue;
+        uint64_t producer = item / num_items;
+        ASSERT_EQ(item % num_items, next_item[producer]);
+        ++next_item[producer];
+        ++num_popped;
+    }
+    for (auto &thread : producers)
+        thread.join();
+    ASSERT_TRUE(queue.empty());
+}
@@ -0,0 +1,40 @@
+#include <map>
+#include <gtest/gtest.h>
+#include "node_pool.h"
+
+using namespace RapidTrader;
+
+TEST(NodePool, AllocatingAndDeallocatingBlocksShouldWork1)
+{
+    NodePool pool{24};
+    pool.reserve(4);
+    ASSERT_EQ(pool.getCapacity(), 4);
+    void *first = pool.allocate();
+    void *second = pool.allocate();
+    ASSERT_NE(first, second);
+    // Deallocated blocks should be reused before the pool grows.
+    pool.deallocate(second);
+    ASSERT_EQ(pool.allocate(), second);
+    pool.allocate();
+    pool.allocate();
+    ASSERT_EQ(pool.getCapacity(), 4);
+    // The pool should grow once all blocks have been allocated.
+    pool.allocate();
+    ASSERT_GT(pool.getCapacity(), 4);
+}
+
+TEST(NodePool, PoolAllocatorShouldAllocateMapNodesFromPool1)
+{
+    NodePool pool{sizeof(std::pair<const uint64_t, uint64_t>) + 4 * sizeof(void *)};
+    pool.reserve(100);
+    std::map<uint64_t, uint64_t, std::less<uint64_t>, PoolAllocator<std::pair<const uint64_t, uint64_t>>> map{
+        PoolAllocator<std::pair<const uint64_t, uint64_t>>(&pool)};
+    for (uint64_t i = 0; i < 100; ++i)
+        map.emplace(i, i);
+    for (uint64_t i = 0; i < 100; ++i)
+        map.erase(i);
+    for (uint64_t i = 0; i < 100; ++i)
+        map.emplace(i, i);
+    ASSERT_EQ(map.size(), 100);
+    ASSERT_EQ(pool.getCapacity(), 100);
+}
@@ -0,0 +1,95 @@
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "market/symbol_routing_table.h"
+
+using namespace RapidTrader;
+
+TEST(SymbolRoutingTable, FindingSymbolsShouldWork1)
+{
+    SymbolRoutingTable routes(8192);
+    // Symbols in the dense array, in different chunks, and in the sparse table.
+    routes.insert(1, 0);
+    routes.insert(5000, 1);
+    routes.insert(1000000, 2);
+    ASSERT_EQ(routes.find(1), 0);
+    ASSERT_EQ(routes.find(5000), 1);
+    ASSERT_EQ(routes.find(1000000), 2);
+    ASSERT_EQ(routes.find(2), SymbolRoutingTable::unknown_symbol);
+    ASSERT_EQ(routes.find(4096), SymbolRoutingTable::unknown_symbol);
+    ASSERT_EQ(routes.find(1000001), SymbolRoutingTable::unknown_symbol);
+    routes.erase(1);
+    routes.erase(1000000);
+    ASSERT_EQ(routes.find(1), SymbolRoutingTable::unknown_symbol);
+    ASSERT_EQ(routes.find(5000), 1);
+    ASSERT_EQ(routes.find(1000000), SymbolRoutingTable::unknown_symbol);
+    // A deleted symbol may be added again.
+    routes.insert(1000000, 3);
+    ASSERT_EQ(routes.find(1000000), 3);
+}
+
+TEST(SymbolRoutingTable, ReadersShouldSeeSymbolsWhileTheyAreAdded1)
+{
+    SymbolRoutingTable routes(4096);
+    // Most symbols go in the dense array, but some go in the sparse table.
+    const uint32_t num_symbols = 4096 + 256;
+    std::atomic_bool done = false;
+    // A reader checks that a symbol never changes route once it has been found.
+    std::thread reader([&] {
+        while (!done)
+        {
+            for (uint32_t symbol_id = 0; symbol_id < num_symbols; ++symbol_id)
+            {
+                uint32_t route = routes.find(symbol_id);
+                ASSERT_TRUE(route == SymbolRoutingTable::unknown_symbol || route == symbol_id % 4);
+            }
+        }
+    });
+    for (uint32_t symbol_id = 0; symbol_id < num_symbols; ++symbol_id)
+        routes.insert(symbol_id, symbol_id % 4);
+    done = true;
+    reader.join();
+    for (uint32_t symbol_id = 0; symbol_id < num_symbols; ++symbol_id)
+        ASSERT_EQ(routes.find(symbol_id), symbol_id % 4);
+}
+
+TEST(SymbolRoutingTable, ReadersShouldSeeSymbolsWhileTheyAreErased1)
+{
+    SymbolRoutingTable routes(4096);
+    const uint32_t first_sparse_id = 1000000;
+    const uint32_t num_symbols = 64;
+    for (uint32_t symbol_id = first_sparse_id; symbol_id < first_sparse_id + num_symbols; symbol_id += 2)
+        routes.insert(symbol_id, symbol_id % 4);
+    std::atomic_bool done = false;
+    // The readers check that symbols that are never erased are always found while the sparse table is
+    // replaced and freed under them.
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i)
+    {
+        readers.emplace_back([&] {
+            while (!done)
+            {
+                for (uint32_t symbol_id = first_sparse_id; symbol_id < first_sparse_id + num_symbols; ++symbol_id)
+                {
+                    uint32_t route = routes.find(symbol_id);
+                    if (symbol_id % 2 == 0)
+                        ASSERT_EQ(route, symbol_id % 4);
+                    else
+                        ASSERT_TRUE(route == SymbolRoutingTable::unknown_symbol || route == symbol_id % 4);
+                }
+            }
+        });
+    }
+    for (int round = 0; round < 200; ++round)
+    {
+        for (uint32_t symbol_id = first_sparse_id + 1; symbol_id < first_sparse_id + num_symbols; symbol_id += 2)
+            routes.insert(symbol_id, symbol_id % 4);
+        for (uint32_t symbol_id = first_sparse_id + 1; symbol_id < first_sparse_id + num_symbols; symbol_id += 2)
+            routes.erase(symbol_id);
+    }
+    done = true;
+    for (auto &reader : readers)
+        reader.join();
+    for (uint32_t symbol_id = first_sparse_id; symbol_id < first_sparse_id + num_symbols; ++symbol_id)
+        ASSERT_EQ(routes.find(symbol_id), symbol_id % 2 == 0 ? symbol_id % 4 : SymbolRoutingTable::unknown_symbol);
+}
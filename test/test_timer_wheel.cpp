@@ -0,0 +1,62 @@
+#include <random>
+#include <gtest/gtest.h>
+#include "timer_wheel.h"
+
+using namespace RapidTrader;
+
+TEST(TimerWheel, OrdersShouldExpireOnTime1)
+{
+    const uint64_t tick = 1000;
+    const uint64_t start = 5000000;
+    TimerWheel wheel(tick, start);
+    // Spread expiry times over a range wide enough that some orders land in the overflow list.
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<uint64_t> expiry_distribution(1, uint64_t{1} << 26);
+    std::vector<Order> orders;
+    orders.reserve(1000);
+    for (uint64_t id = 1; id <= 1000; ++id)
+        orders.push_back(Order::gtdBidOrder(id, 1, 100, 10, start + expiry_distribution(generator) * tick));
+    for (Order &order : orders)
+        wheel.schedule(order);
+
+    std::vector<bool> expired(orders.size() + 1, false);
+    std::uniform_int_distribution<uint64_t> step_distribution(1, uint64_t{1} << 20);
+    uint64_t now = start;
+    size_t num_expired = 0;
+    while (num_expired < orders.size())
+    {
+        now += step_distribution(generator) * tick;
+        ExpiryList expired_orders;
+        wheel.advance(now, expired_orders);
+        while (!expired_orders.empty())
+        {
+            Order &order = expired_orders.front();
+            expired_orders.pop_front();
+            // Orders should never expire early.
+            ASSERT_LE(order.getExpiryTime(), now);
+            ASSERT_FALSE(expired[order.getOrderID()]);
+            expired[order.getOrderID()] = true;
+            ++num_expired;
+        }
+        // Every order whose expiry time has passed should have expired.
+        for (const Order &order : orders)
+            ASSERT_EQ(expired[order.getOrderID()], order.getExpiryTime() <= now);
+    }
+}
+
+TEST(TimerWheel, DestroyedOrdersShouldLeaveWheel1)
+{
+    TimerWheel wheel(1, 0);
+    std::vector<Order> orders;
+    orders.push_back(Order::gtdAskOrder(1, 1, 100, 10, 10));
+    orders.push_back(Order::gtdAskOrder(2, 1, 100, 10, 10));
+    wheel.schedule(orders[0]);
+    wheel.schedule(orders[1]);
+    // Destroying an order unlinks it from the wheel.
+    orders.pop_back();
+    ExpiryList expired_orders;
+    wheel.advance(10, expired_orders);
+    ASSERT_EQ(expired_orders.size(), 1);
+    ASSERT_EQ(expired_orders.front().getOrderID(), 1);
+    expired_orders.clear();
+}
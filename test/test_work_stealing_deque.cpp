@@ -0,0 +1,73 @@
+#include <thread>
+#include <gtest/gtest.h>
+#include "concurrent/work_stealing_deque.h"
+
+using namespace RapidTrader::Concurrent;
+
+TEST(WorkStealingDeque, PushingAndPoppingShouldWork1)
+{
+    // Start small so that the deque has to grow.
+    WorkStealingDeque<uint64_t> deque(2);
+    for (uint64_t i = 1; i <= 100; ++i)
+        deque.push(i);
+    uint64_t item = 0;
+    // The owner pops the newest items and thieves steal the oldest.
+    ASSERT_TRUE(deque.pop(item));
+    ASSERT_EQ(item, 100);
+    ASSERT_TRUE(deque.steal(item));
+    ASSERT_EQ(item, 1);
+    for (uint64_t i = 99; i >= 2; --i)
+    {
+        ASSERT_TRUE(deque.pop(item));
+        ASSERT_EQ(item, i);
+    }
+    ASSERT_TRUE(deque.empty());
+    ASSERT_FALSE(deque.pop(item));
+    ASSERT_FALSE(deque.steal(item));
+}
+
+TEST(WorkStealingDeque, ItemsShouldBeTakenExactlyOnce1)
+{
+    const uint64_t num_items = 200000;
+    const uint32_t num_thieves = 3;
+    WorkStealingDeque<uint64_t> deque(16);
+    std::vector<uint64_t> taken_counts(num_items + 1, 0);
+    std::vector<std::vector<uint64_t>> stolen(num_thieves);
+    std::atomic_bool done = false;
+    std::vector<std::thread> thieves;
+    for (uint32_t i = 0; i < num_thieves; ++i)
+    {
+        thieves.emplace_back([&, i] {
+            uint64_t item = 0;
+            while (!done || !deque.empty())
+            {
+                if (deque.steal(item))
+                    stolen[i].push_back(item);
+            }
+        });
+    }
+    // The owner pushes every item and pops some of them back.
+    std::vector<uint64_t> popped;
+    for (uint64_t i = 1; i <= num_items; ++i)
+    {
+        deque.push(i);
+        uint64_t item = 0;
+        if (i % 3 == 0 && deque.pop(item))
+            popped.push_back(item);
+    }
+    done = true;
+    for (auto &thief : thieves)
+        thief.join();
+    uint64_t item = 0;
+    while (deque.pop(item))
+        popped.push_back(item);
+    for (uint64_t popped_item : popped)
+        ++taken_counts[popped_item];
+    for (const auto &stolen_items : stolen)
+    {
+        for (uint64_t stolen_item : stolen_items)
+            ++taken_counts[stolen_item];
+    }
+    for (uint64_t i = 1; i <= num_items; ++i)
+        ASSERT_EQ(taken_counts[i], 1);
+}
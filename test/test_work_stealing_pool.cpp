@@ -0,0 +1,55 @@
+#include <chrono>
+#include <ctime>
+#include <gtest/gtest.h>
+#include "concurrent/work_stealing_pool.h"
+
+using namespace RapidTrader::Concurrent;
+
+TEST(WorkStealingPool, SubmittedTasksShouldRun1)
+{
+    WorkStealingPool pool(4);
+    std::vector<std::future<uint64_t>> futures;
+    for (uint64_t i = 1; i <= 1000; ++i)
+        futures.push_back(pool.submitTask([](uint64_t x) { return x * x; }, i));
+    uint64_t sum = 0;
+    for (auto &future : futures)
+        sum += future.get();
+    ASSERT_EQ(sum, 1000 * 1001 * 2001 / 6);
+}
+
+TEST(WorkStealingPool, NestedTasksShouldRun1)
+{
+    WorkStealingPool pool(4);
+    std::atomic<uint64_t> count = 0;
+    // Each outer task submits inner tasks to its own deque, which idle workers steal.
+    auto outer = pool.submitTask([&] {
+        std::vector<std::future<void>> inner;
+        for (int i = 0; i < 100; ++i)
+            inner.push_back(pool.submitTask([&] { ++count; }));
+        return inner;
+    });
+    auto inner = outer.get();
+    for (auto &future : inner)
+        future.get();
+    ASSERT_EQ(count, 100);
+    auto failing = pool.submitTask([] { throw std::runtime_error("Task failed!"); });
+    ASSERT_THROW(failing.get(), std::runtime_error);
+}
+
+TEST(WorkStealingPool, IdleWorkersShouldPark1)
+{
+    WorkStealingPool pool(4);
+    ASSERT_EQ(pool.submitTask([] { return 1; }).get(), 1);
+    // Give the workers time to park, then measure the CPU time that the idle pool uses.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::clock_t start = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    double idle_seconds = double(std::clock() - start) / CLOCKS_PER_SEC;
+    ASSERT_LT(idle_seconds, 0.05);
+    // Parked workers should wake up for new tasks.
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i)
+        futures.push_back(pool.submitTask([i] { return i; }));
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(futures[i].get(), i);
+}
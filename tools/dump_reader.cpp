@@ -0,0 +1,57 @@
+#include <cstring>
+#include <iostream>
+#include "book_dump.h"
+
+using namespace RapidTrader;
+
+/**
+ * Writes the levels of a book as CSV rows.
+ *
+ * @param book the book that the levels belong to.
+ * @param kind the kind of the levels.
+ * @param levels the levels to write.
+ */
+static void writeCsvLevels(const BookSnapshot &book, const char *kind, const std::vector<BookSnapshot::LevelSnapshot> &levels)
+{
+    for (const auto &level : levels)
+        std::cout << book.symbol_id << ',' << book.last_traded_price << ',' << kind << ',' << level.price << ',' << level.volume << '\n';
+}
+
+// Renders a binary dump written by Market::dumpMarketBinary or ConcurrentMarket::dumpMarketBinary
+// as text, in the same format as Market::dumpMarket, or as CSV.
+int main(int argc, char *argv[])
+{
+    bool csv = argc == 3 && std::strcmp(argv[2], "--csv") == 0;
+    if (argc != 2 && !csv)
+    {
+        std::cerr << "Usage: " << argv[0] << " <dump> [--csv]\n";
+        return 2;
+    }
+    try
+    {
+        BookDumpReader reader{argv[1]};
+        BookSnapshot book;
+        if (csv)
+            std::cout << "symbol_id,last_traded_price,kind,price,volume\n";
+        while (reader.read(book))
+        {
+            if (!csv)
+            {
+                std::cout << book.toString() << '\n';
+                continue;
+            }
+            writeCsvLevels(book, "bid", book.bid_levels);
+            writeCsvLevels(book, "ask", book.ask_levels);
+            writeCsvLevels(book, "stop_bid", book.stop_bid_levels);
+            writeCsvLevels(book, "stop_ask", book.stop_ask_levels);
+            writeCsvLevels(book, "trailing_stop_bid", book.trailing_stop_bid_levels);
+            writeCsvLevels(book, "trailing_stop_ask", book.trailing_stop_ask_levels);
+        }
+    }
+    catch (const std::exception &exception)
+    {
+        std::cerr << exception.what() << '\n';
+        return 1;
+    }
+    return 0;
+}